@@ -5,17 +5,25 @@
  *  \brief Contains adapters for yaml_document_t
  */
 
+#include <vector>
+
 #include "../../parsing/numbers.h"
 #include "../../layer.h"
 
 #include "yaml.h"
 
 #include "error.h"
+#include "internal.h"
 
 
 namespace garlic::adapters::libyaml {
 
+  using scalar_table = std::vector<internal::scalar_entry>;
+
   //! An adapter for yaml_document_t conforming to garlic::ViewLayer
+  /*! Views made by YamlDocument read the types and values of scalars from a table the document
+   *  builds once, other views parse the scalar every time it is read.
+   */
   class YamlView {
 
     struct ValueIteratorWrapper {
@@ -24,9 +32,10 @@ namespace garlic::adapters::libyaml {
 
       iterator_type iterator;
       yaml_document_t* doc;
+      const scalar_table* scalars;
 
       inline YamlView wrap() const {
-        return YamlView(doc, yaml_document_get_node(doc, *iterator));
+        return YamlView(doc, yaml_document_get_node(doc, *iterator), scalars);
       }
     };
 
@@ -36,11 +45,12 @@ namespace garlic::adapters::libyaml {
 
       iterator_type iterator;
       yaml_document_t* doc;
+      const scalar_table* scalars;
 
       inline output_type wrap() const {
         return output_type {
-          YamlView{doc, yaml_document_get_node(doc, iterator->key)},
-          YamlView{doc, yaml_document_get_node(doc, iterator->value)},
+          YamlView{doc, yaml_document_get_node(doc, iterator->key), scalars},
+          YamlView{doc, yaml_document_get_node(doc, iterator->value), scalars},
         };
       }
     };
@@ -49,67 +59,121 @@ namespace garlic::adapters::libyaml {
     using ConstValueIterator = RandomAccessIterator<ValueIteratorWrapper>;
     using ConstMemberIterator = RandomAccessIterator<MemberIteratorWrapper>;
 
-    YamlView (yaml_document_t* doc, yaml_node_t* node) : doc_(doc), node_(node) {}
-    YamlView (yaml_document_t* doc) : doc_(doc) { node_ = yaml_document_get_root_node(doc); }
+    YamlView (yaml_document_t* doc, yaml_node_t* node, const scalar_table* scalars = nullptr
+        ) : doc_(doc), node_(node), scalars_(scalars) {}
+    YamlView (yaml_document_t* doc, const scalar_table* scalars = nullptr
+        ) : doc_(doc), scalars_(scalars) { node_ = yaml_document_get_root_node(doc); }
 
     bool is_null() const {
+      if (auto entry = this->classified(); entry) return entry->flag & internal::scalar_entry::null;
       return node_->type == yaml_node_type_t::YAML_NO_NODE || (
           is_string() && strcmp("null", get_cstr()) == 0
           );
     }
     bool is_int() const noexcept {
+      if (auto entry = this->classified(); entry) return entry->flag & internal::scalar_entry::integer;
       int holder;
       return (
         node_->type == yaml_node_type_t::YAML_SCALAR_NODE &&
         node_->data.scalar.style == yaml_scalar_style_t::YAML_PLAIN_SCALAR_STYLE &&
-        parsing::ParseInt(scalar_data(), holder)
+        parsing::ParseInt(scalar_data(), node_->data.scalar.length, holder)
       );
     }
     bool is_string() const noexcept { return node_->type == yaml_node_type_t::YAML_SCALAR_NODE; }
+    TypeFlag get_type() const noexcept {
+      if (auto entry = this->classified(); entry) return entry->type;
+      switch (node_->type) {
+        case yaml_node_type_t::YAML_SCALAR_NODE: break;
+        case yaml_node_type_t::YAML_MAPPING_NODE: return TypeFlag::Object;
+        case yaml_node_type_t::YAML_SEQUENCE_NODE: return TypeFlag::List;
+        default: return TypeFlag::Null;
+      }
+      internal::scalar_entry entry;
+      internal::classify_scalar(*node_, entry);
+      return entry.type;
+    }
     bool is_double() const noexcept {
+      if (auto entry = this->classified(); entry) return entry->flag & internal::scalar_entry::real;
       double holder;
       return (
         node_->type == yaml_node_type_t::YAML_SCALAR_NODE &&
         node_->data.scalar.style == yaml_scalar_style_t::YAML_PLAIN_SCALAR_STYLE &&
-        parsing::ParseDouble(scalar_data(), holder)
+        parsing::ParseDouble(scalar_data(), node_->data.scalar.length, holder)
       );
     }
     bool is_object() const noexcept { return node_->type == yaml_node_type_t::YAML_MAPPING_NODE; }
     bool is_list() const noexcept { return node_->type == yaml_node_type_t::YAML_SEQUENCE_NODE; }
     bool is_bool() const noexcept {
+      if (auto entry = this->classified(); entry) return entry->flag & internal::scalar_entry::boolean;
+      bool holder;
       return (
         node_->type == yaml_node_type_t::YAML_SCALAR_NODE &&
         node_->data.scalar.style == yaml_scalar_style_t::YAML_PLAIN_SCALAR_STYLE &&
-        check_bool(scalar_data(), [](auto){})
+        internal::parse_bool(scalar_data(), node_->data.scalar.length, holder)
       );
     }
 
     char* scalar_data() const noexcept { return (char*)node_->data.scalar.value; }
     int get_int() const noexcept {
+      if (auto entry = this->classified(); entry && (entry->flag & internal::scalar_entry::integer)) {
+        return static_cast<int>(entry->int_value);
+      }
       int result = 0;
-      parsing::ParseInt(scalar_data(), result);
+      parsing::ParseInt(scalar_data(), node_->data.scalar.length, result);
+      return result;
+    }
+    bool is_int64() const noexcept {
+      if (auto entry = this->classified(); entry) return entry->flag & internal::scalar_entry::int64;
+      int64_t holder;
+      return this->parse_plain(holder);
+    }
+    bool is_uint64() const noexcept {
+      if (auto entry = this->classified(); entry) return entry->flag & internal::scalar_entry::uint64;
+      uint64_t holder;
+      return this->parse_plain(holder);
+    }
+    int64_t get_int64() const noexcept {
+      if (auto entry = this->classified(); entry && (entry->flag & internal::scalar_entry::int64)) {
+        return entry->int_value;
+      }
+      int64_t result = 0;
+      parsing::ParseInt(scalar_data(), node_->data.scalar.length, result);
+      return result;
+    }
+    uint64_t get_uint64() const noexcept {
+      if (auto entry = this->classified(); entry && (entry->flag & internal::scalar_entry::uint64)) {
+        return static_cast<uint64_t>(entry->int_value);
+      }
+      uint64_t result = 0;
+      parsing::ParseInt(scalar_data(), node_->data.scalar.length, result);
       return result;
     }
     std::string get_string() const noexcept { return std::string{scalar_data()}; }
     std::string_view get_string_view() const noexcept { return std::string_view{scalar_data()}; }
     const char* get_cstr() const noexcept { return scalar_data(); }
     double get_double() const noexcept {
+      if (auto entry = this->classified(); entry && (entry->flag & internal::scalar_entry::real)) {
+        return entry->real_value;
+      }
       double result;
-      parsing::ParseDouble(scalar_data(), result);
+      parsing::ParseDouble(scalar_data(), node_->data.scalar.length, result);
       return result;
     }
     bool get_bool() const noexcept {
+      if (auto entry = this->classified(); entry && (entry->flag & internal::scalar_entry::boolean)) {
+        return entry->bool_value;
+      }
       bool result = false;
-      check_bool(scalar_data(), [&result](auto r) { result = r; });
+      internal::parse_bool(scalar_data(), node_->data.scalar.length, result);
       return result;
     }
 
-    ConstValueIterator begin_list() const { return ConstValueIterator({node_->data.sequence.items.start, doc_}); }
-    ConstValueIterator end_list() const { return ConstValueIterator({node_->data.sequence.items.top, doc_}); }
+    ConstValueIterator begin_list() const { return ConstValueIterator({node_->data.sequence.items.start, doc_, scalars_}); }
+    ConstValueIterator end_list() const { return ConstValueIterator({node_->data.sequence.items.top, doc_, scalars_}); }
     auto get_list() const { return ConstListRange<YamlView>{*this}; }
 
-    ConstMemberIterator begin_member() const { return ConstMemberIterator({node_->data.mapping.pairs.start, doc_}); }
-    ConstMemberIterator end_member() const { return ConstMemberIterator({node_->data.mapping.pairs.top, doc_}); }
+    ConstMemberIterator begin_member() const { return ConstMemberIterator({node_->data.mapping.pairs.start, doc_, scalars_}); }
+    ConstMemberIterator end_member() const { return ConstMemberIterator({node_->data.mapping.pairs.top, doc_, scalars_}); }
     ConstMemberIterator find_member(text key) const {
       return std::find_if(this->begin_member(), this->end_member(), [&key](const auto& item) {
         return key.compare(item.key.get_cstr()) == 0;
@@ -125,26 +189,23 @@ namespace garlic::adapters::libyaml {
   private:
     yaml_document_t* doc_;
     yaml_node_t* node_;
+    const scalar_table* scalars_;
 
-    template<typename Callable>
-    bool check_bool(const char* input, const Callable& cb) const {
-      struct pair {
-        const char* name;
-        bool value;
-      };
-      static const pair pairs[8] = {
-        {"y", true}, {"n", false},
-        {"true", true}, {"false", false},
-        {"on", true}, {"off", false},
-        {"yes", true}, {"no", false},
-      };
-      for(auto it = std::begin(pairs); it != std::end(pairs); it++) {
-        if (strcmp(it->name, input) == 0) {
-          cb(it->value);
-          return true;
-        }
-      }
-      return false;
+    // The classification of the node if the view has a table that covers it.
+    inline const internal::scalar_entry* classified() const noexcept {
+      if (!scalars_) return nullptr;
+      auto position = static_cast<size_t>(node_ - doc_->nodes.start);
+      return position < scalars_->size() ? scalars_->data() + position : nullptr;
+    }
+
+    // Parse a plain scalar as an integer of the given width.
+    template<typename Integer>
+    inline bool parse_plain(Integer& holder) const noexcept {
+      return (
+        node_->type == yaml_node_type_t::YAML_SCALAR_NODE &&
+        node_->data.scalar.style == yaml_scalar_style_t::YAML_PLAIN_SCALAR_STYLE &&
+        parsing::ParseInt(scalar_data(), node_->data.scalar.length, holder)
+      );
     }
   };
 
@@ -155,11 +216,12 @@ namespace garlic::adapters::libyaml {
   protected:
     yaml_document_t doc_;
     bool ready_ = false;
+    scalar_table scalars_;
 
   public:
     YamlDocument() = default;
     YamlDocument(const YamlDocument&) = delete;
-    YamlDocument(YamlDocument&& doc) : doc_(std::move(doc.doc_)), ready_(true) {
+    YamlDocument(YamlDocument&& doc) : doc_(std::move(doc.doc_)), ready_(true), scalars_(std::move(doc.scalars_)) {
       doc.ready_ = false;
     }
 
@@ -168,8 +230,20 @@ namespace garlic::adapters::libyaml {
         yaml_document_delete(&doc_);
     }
 
+    //! @return a view of the root node, it reads scalars from the classification when there is one.
+    /*! @note It never writes to the document, views of a shared document can be taken concurrently. */
     YamlView get_view() {
-      return YamlView{&doc_};
+      if (!this->ready_ || scalars_.size() != static_cast<size_t>(doc_.nodes.top - doc_.nodes.start))
+        return YamlView{&doc_};
+      return YamlView{&doc_, &scalars_};
+    }
+
+    //! Classifies every scalar of the document once so that views do not parse them on every read.
+    /*! The load() functions call it, documents filled or changed through get_inner_document()
+     *  have to call it again before they are shared between threads.
+     */
+    void classify() {
+      if (this->ready_) scalars_ = internal::classify_nodes(doc_);
     }
 
     yaml_document_t* get_inner_document() { return &doc_; }
@@ -204,6 +278,7 @@ namespace garlic::adapters::libyaml {
     }
 
     yaml_parser_delete(&parser);  // Everything is good, delete the parser!
+    doc.classify();
     return doc;
   }
 
@@ -212,6 +287,7 @@ namespace garlic::adapters::libyaml {
   static YamlDocument load(yaml_parser_t* parser) {
     YamlDocument doc;
     yaml_parser_load(parser, doc.get_inner_document());
+    doc.classify();
     return doc;
   }
 
@@ -28,7 +28,8 @@ namespace garlic::adapters::libyaml {
        char* buffer,
        yaml_mapping_style_t mapping_style = yaml_mapping_style_t::YAML_ANY_MAPPING_STYLE,
        yaml_sequence_style_t sequence_style = yaml_sequence_style_t::YAML_ANY_SEQUENCE_STYLE) {
-    if (layer.is_object()) {
+    auto type = garlic::internal::probe_type(layer);
+    if (type.is_object()) {
       if (!internal::emit_mapping_start(emitter, event, mapping_style))
         return false;
       for (const auto& pair : layer.get_object()) {
@@ -38,23 +39,29 @@ namespace garlic::adapters::libyaml {
           return false;
       }
       yaml_mapping_end_event_initialize(event);
-    } else if (layer.is_list()) {
+    } else if (type.is_list()) {
       if (!internal::emit_sequence_start(emitter, event, sequence_style))
         return false;
       for (const auto& item : layer.get_list()) {
         emit(emitter, event, item, buffer, mapping_style, sequence_style);
       }
       yaml_sequence_end_event_initialize(event);
-    } else if (layer.is_bool()) {
+    } else if (type.is_bool()) {
       if (! (layer.get_bool() ? internal::initialize_true(event) : internal::initialize_false(event)) )
         return false;
-    } else if (layer.is_int()) {
+    } else if (type.is_int()) {
       if (!internal::initialize_int(event, layer.get_int(), buffer))
         return false;
-    } else if (layer.is_double()) {
+    } else if (type.is_int64()) {
+      if (!internal::initialize_int(event, garlic::get_int64(layer), buffer))
+        return false;
+    } else if (type.is_uint64()) {
+      if (!internal::initialize_int(event, garlic::get_uint64(layer), buffer))
+        return false;
+    } else if (type.is_double()) {
       if (!internal::initialize_double(event, layer.get_double(), buffer))
         return false;
-    } else if (layer.is_string()) {
+    } else if (type.is_string()) {
       auto view = layer.get_string_view();
       if (!internal::initialize_string(event, view.data(), view.size()))
         return false;
@@ -108,7 +108,7 @@
  *                if (event_.data.scalar.style != yaml_scalar_style_t::YAML_PLAIN_SCALAR_STYLE) {
  *                  stack.front().value.set_string(this->data());
  *                } else {
- *                  set_plain_scalar_value(stack.front().value, this->data());
+ *                  set_plain_scalar_value(stack.front().value, this->data(), event_.data.scalar.length);
  *                }
  *                stack.pop_front();
  *              }
@@ -1,6 +1,11 @@
 #ifndef GARLIC_LIBYAML_INTERNAL_H
 #define GARLIC_LIBYAML_INTERNAL_H
 
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
 #include "../../parsing/numbers.h"
 #include "../../layer.h"
 
@@ -16,42 +21,112 @@ namespace garlic::adapters::libyaml::internal {
     return size;
   }
 
-  static bool parse_bool(const char* data, bool& output) {
-    struct pair {
-      const char* name;
-      bool value;
-    };
-    static const pair pairs[8] = {
-      {"y", true}, {"n", false},
-      {"true", true}, {"false", false},
-      {"on", true}, {"off", false},
-      {"yes", true}, {"no", false},
+  // Read the spellings of a boolean YAML accepts, every one of them has a distinct length.
+  static bool parse_bool(const char* data, size_t length, bool& output) {
+    auto is = [data, length](const char* name) { return memcmp(data, name, length) == 0; };
+    switch (length) {
+      case 1: if (is("y") || is("n")) { output = *data == 'y'; return true; } break;
+      case 2: if (is("on") || is("no")) { output = data[1] == 'n'; return true; } break;
+      case 3: if (is("yes") || is("off")) { output = *data == 'y'; return true; } break;
+      case 4: if (is("true")) { output = true; return true; } break;
+      case 5: if (is("false")) { output = false; return true; } break;
+    }
+    return false;
+  }
+
+  // The types a node can be read as and its parsed values, so views do not parse scalars again.
+  struct scalar_entry {
+    enum flags : uint8_t {
+      none     = 0,
+      integer  = 0x1 << 0,
+      real     = 0x1 << 1,
+      boolean  = 0x1 << 2,
+      null     = 0x1 << 3,
+      int64    = 0x1 << 4,
+      uint64   = 0x1 << 5,
     };
-    for (const auto& it : pairs) {
-      if (strcmp(it.name, data) == 0) {
-        output = it.value;
-        return true;
+
+    double real_value = 0;
+    int64_t int_value = 0;  // values only uint64 can hold keep their bits here.
+    uint8_t flag = flags::none;
+    bool bool_value = false;
+    TypeFlag type = TypeFlag::Null;  // every TypeFlag the node passes, see YamlView::get_type().
+  };
+
+  // The TypeFlag of a scalar node with the classification, every scalar is a string too.
+  static inline TypeFlag scalar_type(uint8_t flag) noexcept {
+    uint16_t type = TypeFlag::String;
+    if (flag & scalar_entry::integer) type |= TypeFlag::Integer;
+    if (flag & scalar_entry::real) type |= TypeFlag::Double;
+    if (flag & scalar_entry::boolean) type |= TypeFlag::Boolean;
+    if (flag & scalar_entry::null) type |= TypeFlag::Null;
+    if (flag & scalar_entry::int64) type |= TypeFlag::Int64;
+    if (flag & scalar_entry::uint64) type |= TypeFlag::UInt64;
+    return static_cast<TypeFlag>(type);
+  }
+
+  // Classify a scalar node the same way YamlView reads it.
+  static inline void classify_scalar(const yaml_node_t& node, scalar_entry& entry) {
+    auto data = reinterpret_cast<const char*>(node.data.scalar.value);
+    auto length = node.data.scalar.length;
+    if (node.data.scalar.style == yaml_scalar_style_t::YAML_PLAIN_SCALAR_STYLE) {
+      // integers convert to the same double a parse of their digits rounds to, except for -0.
+      if (parsing::ParseInt(data, length, entry.int_value)) {
+        entry.flag |= scalar_entry::int64 | scalar_entry::real;
+        if (entry.int_value >= 0) entry.flag |= scalar_entry::uint64;
+        if (entry.int_value >= INT32_MIN && entry.int_value <= INT32_MAX) entry.flag |= scalar_entry::integer;
+        entry.real_value = entry.int_value == 0 && *data == '-' ? -0.0 : static_cast<double>(entry.int_value);
+      } else if (uint64_t value; parsing::ParseInt(data, length, value)) {
+        entry.flag |= scalar_entry::uint64 | scalar_entry::real;
+        entry.int_value = static_cast<int64_t>(value);
+        entry.real_value = static_cast<double>(value);
+      } else if (parsing::ParseDouble(data, length, entry.real_value)) {
+        entry.flag |= scalar_entry::real;
+      } else if (parse_bool(data, length, entry.bool_value)) {
+        entry.flag |= scalar_entry::boolean;
       }
     }
-    return false;
+    // numbers and booleans are never "null".
+    if (!entry.flag && strcmp("null", data) == 0) entry.flag |= scalar_entry::null;
+    entry.type = scalar_type(entry.flag);
+  }
+
+  // Classify every node of the document the same way YamlView reads them, in the order of the nodes.
+  static inline std::vector<scalar_entry>
+  classify_nodes(const yaml_document_t& doc) {
+    std::vector<scalar_entry> entries(doc.nodes.top - doc.nodes.start);
+    auto entry = entries.begin();
+    for (auto node = doc.nodes.start; node != doc.nodes.top; ++node, ++entry) {
+      switch (node->type) {
+        case yaml_node_type_t::YAML_SCALAR_NODE: classify_scalar(*node, *entry); break;
+        case yaml_node_type_t::YAML_MAPPING_NODE: entry->type = TypeFlag::Object; break;
+        case yaml_node_type_t::YAML_SEQUENCE_NODE: entry->type = TypeFlag::List; break;
+        default: entry->flag = scalar_entry::null;
+      }
+    }
+    return entries;
   }
 
   // Write to the layer with the scalar value of the data.
   template<GARLIC_REF Layer>
   static inline void
-  set_plain_scalar_value(Layer&& layer, const char* data) {
-    int i;
-    if (parsing::ParseInt(data, i)) {
-      layer.set_int(i);
+  set_plain_scalar_value(Layer&& layer, const char* data, size_t length) {
+    int64_t i;
+    if (parsing::ParseInt(data, length, i)) {
+      garlic::set_int64(layer, i);
+      return;
+    }
+    if (uint64_t u; parsing::ParseInt(data, length, u)) {
+      garlic::set_uint64(layer, u);
       return;
     }
     double d;
-    if (parsing::ParseDouble(data, d)) {
+    if (parsing::ParseDouble(data, length, d)) {
       layer.set_double(d);
       return;
     }
     bool b;
-    if (parse_bool(data, b)) {
+    if (parse_bool(data, length, b)) {
       layer.set_bool(b);
       return;
     }
@@ -62,6 +137,36 @@ namespace garlic::adapters::libyaml::internal {
     layer.set_string(data);
   }
 
+  // Report the scalar value of the data to a handler with integer(), real(), boolean(), null() and string().
+  template<typename Handler>
+  static inline void
+  read_plain_scalar_value(Handler&& handler, const char* data, size_t length) {
+    int64_t i;
+    if (parsing::ParseInt(data, length, i)) {
+      handler.integer(i);
+      return;
+    }
+    if (uint64_t u; parsing::ParseInt(data, length, u)) {
+      handler.integer(u);
+      return;
+    }
+    double d;
+    if (parsing::ParseDouble(data, length, d)) {
+      handler.real(d);
+      return;
+    }
+    bool b;
+    if (parse_bool(data, length, b)) {
+      handler.boolean(b);
+      return;
+    }
+    if (strcmp(data, "null") == 0) {
+      handler.null();
+      return;
+    }
+    handler.string(std::string_view(data, length));
+  }
+
   static inline bool emit_mapping_start(yaml_emitter_t* emitter, yaml_event_t* event, yaml_mapping_style_t style) {
     return (
       yaml_mapping_start_event_initialize(event, NULL, (yaml_char_t*)YAML_MAP_TAG, 1, style) &&
@@ -90,8 +195,9 @@ namespace garlic::adapters::libyaml::internal {
       1, 0, yaml_scalar_style_t::YAML_PLAIN_SCALAR_STYLE);
   }
 
-  static inline bool initialize_int(yaml_event_t* event, int value, char* buffer) {
-    auto size = sprintf(buffer, "%d", value);
+  template<typename Integer>
+  static inline bool initialize_int(yaml_event_t* event, Integer value, char* buffer) {
+    auto size = std::to_chars(buffer, buffer + 20, value).ptr - buffer;
     return yaml_scalar_event_initialize(
         event, NULL,
         (yaml_char_t*)YAML_INT_TAG,
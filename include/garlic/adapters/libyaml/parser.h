@@ -1,7 +1,10 @@
 #ifndef GARLIC_LIBYAML_PARSER_H
 #define GARLIC_LIBYAML_PARSER_H
 
+#include <vector>
+
 #include "../../layer.h"
+#include "../../streaming.h"
 
 #include "yaml.h"
 
@@ -83,28 +86,32 @@ namespace garlic::adapters::libyaml {
     template<GARLIC_REF Layer>
     void read_mapping_recursive(Layer&& layer) {
       layer.set_object();
-      do {
+      while (!consume(yaml_event_type_t::YAML_MAPPING_END_EVENT) && !error_) {
         if (event_.type != yaml_event_type_t::YAML_SCALAR_EVENT) {
           error_ = true;
           return;
         }
-        std::string tmp = data();  // Keep a copy of the key. TODO improve this.
-        take();  // parse the next event, this will destroy the event so that tmp above is needed.
-        layer.add_member_builder(tmp.c_str(), [this](auto ref) {
-            read_value_recursive(ref);  // parse the value!
+        // keep the key event alive while the value is read so the key is only copied into the layer.
+        auto key = event_;
+        parse_event();
+        layer.add_member_builder(
+            text(reinterpret_cast<const char*>(key.data.scalar.value), key.data.scalar.length),
+            [this](auto ref) {
+              read_value_recursive(ref);  // parse the value!
             });
-      } while (!consume(yaml_event_type_t::YAML_MAPPING_END_EVENT) && !error_);
+        yaml_event_delete(&key);
+      }
     }
 
     // Recursively read values until a sequence end event gets consumed.
     template<GARLIC_REF Layer>
     void read_sequence_recursive(Layer&& layer) {
       layer.set_list();
-      do {
+      while (!consume(yaml_event_type_t::YAML_SEQUENCE_END_EVENT) && !error_) {
         layer.push_back_builder([this](auto ref) {
             read_value_recursive(ref);  // parse the value!
             });
-      } while (!consume(yaml_event_type_t::YAML_SEQUENCE_END_EVENT) && !error_);
+      }
     }
 
     template<GARLIC_REF Layer>
@@ -127,7 +134,7 @@ namespace garlic::adapters::libyaml {
               take();
               return;
             }
-            internal::set_plain_scalar_value(layer, this->data());
+            internal::set_plain_scalar_value(layer, this->data(), event_.data.scalar.length);
             take();
           }
           return;
@@ -140,6 +147,115 @@ namespace garlic::adapters::libyaml {
     }
   };
 
+  //! Counterpart of RecursiveParser that validates the events instead of populating a layer.
+  /*! Events go straight to a garlic::StreamValidator so no document is ever built. Scalars are
+   *  read the same way RecursiveParser reads them, so the result is the same as loading the
+   *  document and validating it.
+   */
+  class ValidatingParser {
+  private:
+    enum class container_state : uint8_t {
+      key,  // a mapping waiting for a key.
+      value,  // a mapping waiting for the value of a key.
+      item,  // a sequence.
+    };
+
+    yaml_parser_t* parser_;
+    yaml_event_t event_;
+    bool started_ = false;
+
+  public:
+    ValidatingParser(yaml_parser_t* parser) : parser_(parser) {}
+
+    ~ValidatingParser() {
+      if (started_) yaml_event_delete(&event_);
+    }
+
+    // Parse a document with the inner yaml_parser_t and feed it to the validator.
+    // Return whether or not the document was read completely.
+    inline bool parse(StreamValidator& validator) {
+      if (!take() || !consume(yaml_event_type_t::YAML_STREAM_START_EVENT))
+        return false;
+      if (!consume(yaml_event_type_t::YAML_DOCUMENT_START_EVENT))
+        return false;
+
+      // one entry per open container.
+      std::vector<container_state> states;
+      do {
+        bool value_ended = true;
+        switch (event_.type) {
+          case yaml_event_type_t::YAML_MAPPING_START_EVENT:
+            if (expects_key(states)) return false;  // complex keys are not supported.
+            validator.begin_object();
+            states.push_back(container_state::key);
+            value_ended = false;
+            break;
+          case yaml_event_type_t::YAML_MAPPING_END_EVENT:
+            validator.end_object();
+            states.pop_back();
+            break;
+          case yaml_event_type_t::YAML_SEQUENCE_START_EVENT:
+            if (expects_key(states)) return false;
+            validator.begin_list();
+            states.push_back(container_state::item);
+            value_ended = false;
+            break;
+          case yaml_event_type_t::YAML_SEQUENCE_END_EVENT:
+            validator.end_list();
+            states.pop_back();
+            break;
+          case yaml_event_type_t::YAML_SCALAR_EVENT:
+            if (expects_key(states)) {
+              validator.key(std::string_view(this->data(), event_.data.scalar.length));
+              states.back() = container_state::value;
+              value_ended = false;
+            } else {
+              this->read_scalar(validator);
+            }
+            break;
+          default:  // aliases are not supported.
+            return false;
+        }
+        if (value_ended && !states.empty() && states.back() == container_state::value)
+          states.back() = container_state::key;
+        if (!take()) return false;
+      } while (!states.empty());
+
+      if (!consume(yaml_event_type_t::YAML_DOCUMENT_END_EVENT))
+        return false;
+      return consume(yaml_event_type_t::YAML_STREAM_END_EVENT);
+    }
+
+  private:
+    static inline bool expects_key(const std::vector<container_state>& states) {
+      return !states.empty() && states.back() == container_state::key;
+    }
+
+    // Delete the existing event and parse the next one.
+    inline bool take() {
+      if (started_) yaml_event_delete(&event_);
+      started_ = yaml_parser_parse(parser_, &event_);
+      return started_;
+    }
+
+    inline bool consume(yaml_event_type_t type) {
+      return event_.type == type && take();
+    }
+
+    inline const char* data() const {
+      return reinterpret_cast<const char*>(event_.data.scalar.value);
+    }
+
+    inline void read_scalar(StreamValidator& validator) {
+      // if value is not plain, it is definitely a string.
+      if (event_.data.scalar.style != yaml_scalar_style_t::YAML_PLAIN_SCALAR_STYLE) {
+        validator.string(std::string_view(this->data(), event_.data.scalar.length));
+        return;
+      }
+      internal::read_plain_scalar_value(validator, this->data(), event_.data.scalar.length);
+    }
+  };
+
   template<GARLIC_REF Layer, typename Initializer>
   static inline tl::expected<void, ParserProblem>
   load(Layer&& layer, Initializer&& initializer) {
@@ -156,6 +272,7 @@ namespace garlic::adapters::libyaml {
       return tl::make_unexpected(problem);
     }
 
+    yaml_parser_delete(&parser);
     return tl::expected<void, ParserProblem>();
   }
 
@@ -213,6 +330,80 @@ namespace garlic::adapters::libyaml {
     return RecursiveParser(parser).parse(layer);
   }
 
+  template<typename Target, typename Initializer>
+  static inline tl::expected<ConstraintResult, ParserProblem>
+  validate_input(Target&& target, Initializer&& initializer) {
+    yaml_parser_t parser;
+
+    if (!yaml_parser_initialize(&parser))
+      return tl::make_unexpected(ParserProblem(parser));
+
+    initializer(&parser);
+
+    StreamValidator validator(std::forward<Target>(target));
+    if (!ValidatingParser(&parser).parse(validator)) {
+      auto problem = ParserProblem(parser);
+      yaml_parser_delete(&parser);
+      return tl::make_unexpected(problem);
+    }
+
+    yaml_parser_delete(&parser);
+    return std::move(validator.result());
+  }
+
+  //! Use libyaml parser to validate a YAML string without loading it.
+  //! \param data YAML string.
+  //! \param length length of the string to validate.
+  //! \param target a std::shared_ptr<Model> or a Constraint to validate against.
+  template<typename Target>
+  static inline tl::expected<ConstraintResult, ParserProblem>
+  validate(const char* data, size_t length, Target&& target) {
+    return validate_input(std::forward<Target>(target), [&](yaml_parser_t* parser) {
+        yaml_parser_set_input_string(parser, reinterpret_cast<const unsigned char*>(data), length);
+        });
+  }
+
+  //! Use libyaml parser to validate a YAML string without loading it.
+  //! \param data YAML string.
+  //! \param target a std::shared_ptr<Model> or a Constraint to validate against.
+  template<typename Target>
+  static inline tl::expected<ConstraintResult, ParserProblem>
+  validate(const char* data, Target&& target) {
+    return validate(data, strlen(data), std::forward<Target>(target));
+  }
+
+  //! Use libyaml parser to validate the input of a custom read handler without loading it.
+  //! \param handler custom read handler.
+  //! \param data pointer to custom context that gets fed to the read handler.
+  //! \param target a std::shared_ptr<Model> or a Constraint to validate against.
+  template<typename Target>
+  static inline tl::expected<ConstraintResult, ParserProblem>
+  validate(yaml_read_handler_t* handler, void* data, Target&& target) {
+    return validate_input(std::forward<Target>(target), [&](yaml_parser_t* parser) {
+        yaml_parser_set_input(parser, handler, data);
+        });
+  }
+
+  //! Use libyaml parser to validate a file without loading it.
+  //! \param file an open and readable file. This function does not close the file afterward.
+  //! \param target a std::shared_ptr<Model> or a Constraint to validate against.
+  template<typename Target>
+  static inline tl::expected<ConstraintResult, ParserProblem>
+  validate(FILE* file, Target&& target) {
+    return validate_input(std::forward<Target>(target), [&](yaml_parser_t* parser) {
+        yaml_parser_set_input_file(parser, file);
+        });
+  }
+
+  //! Use an already initialized and ready yaml_parser_t to feed a validator.
+  //! \param parser an initialized and ready yaml_parser_t
+  //! \param validator the validator to feed, its result is ready if this function returns true.
+  //! \return true if successful, false if parsing runs into an error.
+  static inline bool
+  validate(yaml_parser_t* parser, StreamValidator& validator) {
+    return ValidatingParser(parser).parse(validator);
+  }
+
 }
 
 #endif /* end of include guard: GARLIC_LIBYAML_PARSER_H */
@@ -90,13 +90,37 @@ namespace garlic::adapters::rapidjson {
 
     bool is_null() const noexcept { return value_->IsNull(); }
     bool is_int() const noexcept { return value_->IsInt(); }
+    bool is_int64() const noexcept { return value_->IsInt64(); }
+    bool is_uint64() const noexcept { return value_->IsUint64(); }
+    TypeFlag get_type() const noexcept {
+      switch (value_->GetType()) {
+        case ::rapidjson::kNullType: return TypeFlag::Null;
+        case ::rapidjson::kFalseType:
+        case ::rapidjson::kTrueType: return TypeFlag::Boolean;
+        case ::rapidjson::kObjectType: return TypeFlag::Object;
+        case ::rapidjson::kArrayType: return TypeFlag::List;
+        case ::rapidjson::kStringType: return TypeFlag::String;
+        case ::rapidjson::kNumberType: {
+          uint16_t type = 0;
+          // integers too wide for an int read as doubles as well, like every other layer.
+          if (value_->IsInt()) type |= TypeFlag::Integer;
+          else type |= TypeFlag::Double;
+          if (value_->IsInt64()) type |= TypeFlag::Int64;
+          if (value_->IsUint64()) type |= TypeFlag::UInt64;
+          return static_cast<TypeFlag>(type);
+        }
+      }
+      return static_cast<TypeFlag>(0);
+    }
     bool is_string() const noexcept { return value_->IsString(); }
-    bool is_double() const noexcept { return value_->IsDouble(); }
+    bool is_double() const noexcept { return value_->IsNumber() && !value_->IsInt(); }
     bool is_object() const noexcept { return value_->IsObject(); }
     bool is_list() const noexcept { return value_->IsArray(); }
     bool is_bool() const noexcept { return value_->IsBool(); }
 
     int get_int() const noexcept { return value_->GetInt(); }
+    int64_t get_int64() const noexcept { return value_->GetInt64(); }
+    uint64_t get_uint64() const noexcept { return value_->GetUint64(); }
     std::string get_string() const noexcept {
       return std::string(value_->GetString(), value_->GetStringLength());
     }
@@ -231,6 +255,8 @@ namespace garlic::adapters::rapidjson {
         value_.SetString(::rapidjson::StringRef(value.data(), value.size()));
       }
       void set_int(int value) { value_.SetInt(value); }
+      void set_int64(int64_t value) { value_.SetInt64(value); }
+      void set_uint64(uint64_t value) { value_.SetUint64(value); }
       void set_double(double value) { value_.SetDouble(value); }
       void set_bool(bool value) { value_.SetBool(value); }
       void set_null() { value_.SetNull(); }
@@ -460,7 +486,7 @@ namespace garlic::adapters::rapidjson {
 
     template<GARLIC_VIEW Layer>
     static inline std::enable_if_t<is_rapidjson_wrapper<Layer>::value, ::rapidjson::StringBuffer>
-    dump(Layer&& source, bool pretty = false) {
+    dump_layer(Layer&& source, bool pretty = false) {
       ::rapidjson::StringBuffer buffer;
       if (pretty) {
         auto writer = ::rapidjson::PrettyWriter<::rapidjson::StringBuffer>(buffer);
@@ -474,21 +500,21 @@ namespace garlic::adapters::rapidjson {
 
     template<GARLIC_VIEW Layer>
     static inline std::enable_if_t<!is_rapidjson_wrapper<Layer>::value, ::rapidjson::StringBuffer>
-    dump(Layer&& source, bool pretty = false) {
+    dump_layer(Layer&& source, bool pretty = false) {
       ::rapidjson::StringBuffer buffer;
       if (pretty) {
         auto writer = ::rapidjson::PrettyWriter<::rapidjson::StringBuffer>(buffer);
-        dump(writer, source);
+        write(writer, source);
       } else {
         auto writer = ::rapidjson::Writer<::rapidjson::StringBuffer>(buffer);
-        dump(writer, source);
+        write(writer, source);
       }
       return buffer;
     }
 
     template<GARLIC_VIEW Layer>
     static inline std::enable_if_t<is_rapidjson_wrapper<Layer>::value>
-    dump(FILE * file, Layer&& source, char* write_buffer, size_t length, bool pretty = false) {
+    dump_layer(FILE * file, Layer&& source, char* write_buffer, size_t length, bool pretty = false) {
       ::rapidjson::FileWriteStream os(file, write_buffer, length);
       if (pretty) {
         auto writer = ::rapidjson::PrettyWriter<::rapidjson::FileWriteStream>(os);
@@ -501,7 +527,7 @@ namespace garlic::adapters::rapidjson {
 
     template<GARLIC_VIEW Layer>
     static inline std::enable_if_t<!is_rapidjson_wrapper<Layer>::value>
-    dump(FILE * file, Layer&& source, char* write_buffer, size_t length, bool pretty = false) {
+    dump_layer(FILE * file, Layer&& source, char* write_buffer, size_t length, bool pretty = false) {
       ::rapidjson::FileWriteStream os(file, write_buffer, length);
       if (pretty) {
         auto writer = ::rapidjson::PrettyWriter<::rapidjson::FileWriteStream>(os);
@@ -556,7 +582,7 @@ namespace garlic::adapters::rapidjson {
   //! \param pretty if enabled, would output more readable JSON string.
   template<GARLIC_VIEW Layer>
   static inline void dump(FILE* file, Layer&& source, char* buffer, size_t length, bool pretty = false) {
-    internal::dump(file, source, buffer, length, pretty);
+    internal::dump_layer(file, source, buffer, length, pretty);
   }
 
   //! Write JSON string representing the given layer to the given file.
@@ -568,7 +594,7 @@ namespace garlic::adapters::rapidjson {
   template<GARLIC_VIEW Layer, unsigned BufferSize = 65536>
   static inline void dump(FILE* file, Layer&& source, bool pretty = false) {
     char buffer[BufferSize];
-    internal::dump(file, source, buffer, sizeof(buffer), pretty);
+    internal::dump_layer(file, source, buffer, sizeof(buffer), pretty);
   }
 
   //! Get a JSON string representing the given layer.
@@ -576,7 +602,7 @@ namespace garlic::adapters::rapidjson {
   template<GARLIC_VIEW Layer>
   static inline ::rapidjson::StringBuffer
   dump(Layer&& layer, bool pretty = false) {
-    return internal::dump(layer, pretty);
+    return internal::dump_layer(layer, pretty);
   }
 
 }
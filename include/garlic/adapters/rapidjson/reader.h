@@ -1,9 +1,12 @@
 #ifndef GARLIC_RAPIDJSON_READER_H
 #define GARLIC_RAPIDJSON_READER_H
 
+#include <cstdint>
 #include <deque>
+#include <type_traits>
 
 #include "../../layer.h"
+#include "../../streaming.h"
 
 #include "rapidjson/reader.h"
 
@@ -54,77 +57,67 @@ namespace garlic::adapters::rapidjson {
         item.layer.add_member(item.key.string_ref(), value);
       item.state = node_state::key;
     }
-    
-  public:
-    LayerHandler(Layer&& layer) {
-      nodes_.emplace_front( node(layer.get_reference()) );
+
+    // Integers past int are kept as 64 bit integers when the layer can hold them.
+    template<GARLIC_REF Target, typename Integer>
+    static void set_integer(Target&& layer, Integer value) {
+      if constexpr (std::is_signed_v<Integer>) garlic::set_int64(layer, value);
+      else garlic::set_uint64(layer, value);
     }
 
-    bool Null() {
+    template<typename Integer>
+    bool wide_integer(Integer value) {
       auto& item = nodes_.front();
       switch (item.state) {
         case node_state::set: {
-          item.layer.set_null();
+          set_integer(item.layer, value);
           nodes_.pop_front();
           return true;
         }
         case node_state::push: {
           item.layer.push_back();
+          set_integer(*--item.layer.end_list(), value);
           return true;
         }
         case node_state::value: {
           this->add_member();
+          set_integer((*--item.layer.end_member()).value, value);
           return true;
         }
         default: return false;
       }
     }
 
-    bool Bool(bool value) {
-      auto& item = nodes_.front();
-      switch (item.state) {
-        case node_state::set: {
-          item.layer.set_bool(value);
-          nodes_.pop_front();
-          return true;
-        }
-        case node_state::push: {
-          item.layer.push_back(value);
-          return true;
-        }
-        case node_state::value: {
-          this->add_member(value);
-          return true;
-        }
-        default: return false;
-      }
+  public:
+    LayerHandler(Layer&& layer) {
+      nodes_.emplace_front( node(layer.get_reference()) );
     }
 
-    bool Int(int value) {
+    bool Null() {
       auto& item = nodes_.front();
       switch (item.state) {
         case node_state::set: {
-          item.layer.set_int(value);
+          item.layer.set_null();
           nodes_.pop_front();
           return true;
         }
         case node_state::push: {
-          item.layer.push_back(value);
+          item.layer.push_back();
           return true;
         }
         case node_state::value: {
-          this->add_member(value);
+          this->add_member();
           return true;
         }
         default: return false;
       }
     }
 
-    bool Double(double value) {
+    bool Bool(bool value) {
       auto& item = nodes_.front();
       switch (item.state) {
         case node_state::set: {
-          item.layer.set_double(value);
+          item.layer.set_bool(value);
           nodes_.pop_front();
           return true;
         }
@@ -140,77 +133,49 @@ namespace garlic::adapters::rapidjson {
       }
     }
 
-    bool Uint(unsigned value) {
+    bool Int(int value) {
       auto& item = nodes_.front();
       switch (item.state) {
         case node_state::set: {
-          if (value < INT32_MAX) {
-            item.layer.set_int(static_cast<int>(value));
-          } else {
-            item.layer.set_double(static_cast<double>(value));
-          }
+          item.layer.set_int(value);
           nodes_.pop_front();
           return true;
         }
         case node_state::push: {
-          if (value < INT32_MAX) {
-            item.layer.push_back(static_cast<int>(value));
-          } else {
-            item.layer.push_back(static_cast<double>(value));
-          }
+          item.layer.push_back(value);
           return true;
         }
         case node_state::value: {
-          if (value < INT32_MAX) {
-            this->add_member(static_cast<int>(value));
-          } else {
-            this->add_member(static_cast<double>(value));
-          }
+          this->add_member(value);
           return true;
         }
         default: return false;
       }
     }
 
-    bool Uint64(uint64_t value) {
+    bool Double(double value) {
       auto& item = nodes_.front();
       switch (item.state) {
         case node_state::set: {
-          item.layer.set_double(static_cast<double>(value));
+          item.layer.set_double(value);
           nodes_.pop_front();
           return true;
         }
         case node_state::push: {
-          item.layer.push_back(static_cast<double>(value));
+          item.layer.push_back(value);
           return true;
         }
         case node_state::value: {
-          this->add_member(static_cast<double>(value));
+          this->add_member(value);
           return true;
         }
         default: return false;
       }
     }
 
-    bool Int64(int64_t value) {
-      auto& item = nodes_.front();
-      switch (item.state) {
-        case node_state::set: {
-          item.layer.set_double(static_cast<double>(value));
-          nodes_.pop_front();
-          return true;
-        }
-        case node_state::push: {
-          item.layer.push_back(static_cast<double>(value));
-          return true;
-        }
-        case node_state::value: {
-          this->add_member(static_cast<double>(value));
-          return true;
-        }
-        default: return false;
-      }
-    }
+    bool Uint(unsigned value) { return this->wide_integer(uint64_t{value}); }
+    bool Uint64(uint64_t value) { return this->wide_integer(value); }
+    bool Int64(int64_t value) { return this->wide_integer(value); }
 
     bool String(const Ch* str, ::rapidjson::SizeType length, bool copy) {
       auto& item = nodes_.front();
@@ -326,6 +291,69 @@ namespace garlic::adapters::rapidjson {
     }
   };
 
+  //! RapidJSON read handler type that validates the document while it is being read.
+  /*! The document is never loaded, every event goes straight to a garlic::StreamValidator.
+   *  Numbers are reported the same way LayerHandler stores them so the result is the same
+   *  as loading the document and validating it.
+   *
+   *  @code
+   *  ValidationHandler handler(module.get_model("User"));
+   *  ::rapidjson::Reader reader;
+   *  ::rapidjson::StringStream stream(json);
+   *  reader.Parse(stream, handler);
+   *  handler.result().is_valid();
+   *  @endcode
+   */
+  class ValidationHandler {
+    using Ch = char;
+
+  private:
+    StreamValidator validator_;
+
+  public:
+    //! Takes a std::shared_ptr<Model> or a Constraint to validate the document against.
+    template<typename Target>
+    explicit ValidationHandler(Target&& target) : validator_(std::forward<Target>(target)) {}
+
+    bool Null() { validator_.null(); return true; }
+    bool Bool(bool value) { validator_.boolean(value); return true; }
+    bool Int(int value) { validator_.integer(value); return true; }
+    bool Double(double value) { validator_.real(value); return true; }
+
+    bool Uint(unsigned value) { validator_.integer(uint64_t{value}); return true; }
+    bool Int64(int64_t value) { validator_.integer(value); return true; }
+    bool Uint64(uint64_t value) { validator_.integer(value); return true; }
+
+    bool String(const Ch* str, ::rapidjson::SizeType length, bool copy) {
+      validator_.string(std::string_view{str, length});
+      return true;
+    }
+
+    bool RawNumber(const Ch* str, ::rapidjson::SizeType length, bool copy) {
+      return String(str, length, copy);
+    }
+
+    bool StartObject() { validator_.begin_object(); return true; }
+
+    bool Key(const Ch* str, ::rapidjson::SizeType length, bool copy) {
+      validator_.key(std::string_view{str, length});
+      return true;
+    }
+
+    bool EndObject(::rapidjson::SizeType length) { validator_.end_object(); return true; }
+    bool StartArray() { validator_.begin_list(); return true; }
+    bool EndArray(::rapidjson::SizeType length) { validator_.end_list(); return true; }
+
+    //! @return whether or not the whole document has been read.
+    bool done() const noexcept { return validator_.done(); }
+
+    //! @return the result of the validation, only available once done() is true.
+    const ConstraintResult& result() const noexcept { return validator_.result(); }
+
+    //! @copydoc result()
+    ConstraintResult& result() noexcept { return validator_.result(); }
+  };
+
   //! Convenient shortcut method to create a layer handler to be used in a rapidjson reader.
   //! \tparam Layer any type conforming to garlic::RefLayer concept that is to be populated.
   template<GARLIC_REF Layer>
@@ -15,26 +15,31 @@ namespace garlic::adapters::rapidjson {
   template<typename Writer, GARLIC_VIEW Layer>
   static void
   write(Writer&& writer, Layer&& layer) {
-    if (layer.is_object()) {
+    auto type = garlic::internal::probe_type(layer);
+    if (type.is_object()) {
       writer.StartObject();
       for (const auto& pair : layer.get_object()) {
         writer.Key(pair.key.get_cstr());
         write(writer, pair.value);
       }
       writer.EndObject();
-    } else if (layer.is_list()) {
+    } else if (type.is_list()) {
       writer.StartArray();
       for (const auto& item : layer.get_list()) {
         write(writer, item);
       }
       writer.EndArray();
-    } else if (layer.is_bool()) {
+    } else if (type.is_bool()) {
       writer.Bool(layer.get_bool());
-    } else if (layer.is_int()) {
+    } else if (type.is_int()) {
       writer.Int(layer.get_int());
-    } else if (layer.is_double()) {
+    } else if (type.is_int64()) {
+      writer.Int64(garlic::get_int64(layer));
+    } else if (type.is_uint64()) {
+      writer.Uint64(garlic::get_uint64(layer));
+    } else if (type.is_double()) {
       writer.Double(layer.get_double());
-    } else if (layer.is_string()) {
+    } else if (type.is_string()) {
       writer.String(layer.get_cstr());
     } else {
       writer.Null();
@@ -91,12 +91,7 @@ namespace garlic::adapters::yamlcpp {
 
     ConstMemberIterator begin_member() const { return ConstMemberIterator({node_.begin()}); }
     ConstMemberIterator end_member() const { return ConstMemberIterator({node_.end()}); }
-    ConstMemberIterator find_member(const char* key) const {
-      return std::find_if(this->begin_member(), this->end_member(), [&key](const auto& item) {
-          return strcmp(key, item.key.get_cstr()) == 0;
-      });
-    }
-    ConstMemberIterator find_member(std::string_view key) const {
+    ConstMemberIterator find_member(text key) const {
       return std::find_if(this->begin_member(), this->end_member(), [&key](const auto& item) {
           return key.compare(item.key.get_cstr()) == 0;
       });
@@ -112,9 +107,9 @@ namespace garlic::adapters::yamlcpp {
     void clear() { node_.reset(YAML::Node{YAML::NodeType::Sequence}); }
     template<typename Callable>
     void push_back_builder(Callable&& cb) {
-      YAML::Node node_;
-      cb(YamlNode(node_));
-      node_.push_back(node_);
+      YAML::Node value;
+      cb(YamlNode(value));
+      node_.push_back(value);
     }
     void push_back() { node_.push_back(YAML::Node()); }
     void push_back(const YamlNode& value) { node_.push_back(value.get_inner_value()); }
@@ -126,9 +121,9 @@ namespace garlic::adapters::yamlcpp {
     void push_back(bool value) { node_.push_back(value); }
 
     // member functions.
-    MemberIterator find_member(const char* key) {
+    MemberIterator find_member(text key) {
       return std::find_if(this->begin_member(), this->end_member(), [&key](const auto& item) {
-        return strcmp(item.key.get_cstr(), key) == 0;
+        return key.compare(item.key.get_cstr()) == 0;
       });
     }
     MemberIterator find_member(const YamlNode& value) { return this->find_member(value.get_cstr()); }
@@ -140,7 +135,7 @@ namespace garlic::adapters::yamlcpp {
       node_.force_insert(std::move(key), std::move(value));
     }
     void add_member(const char* key) { this->add_member(YAML::Node(key)); }
-    void add_member(const char* key, YAML::Node&& value) { this->add_member(key, std::move(value)); }
+    void add_member(const char* key, YAML::Node&& value) { node_.force_insert(key, std::move(value)); }
     void add_member(const char* key, const char* value) { this->add_member(key, YAML::Node(value)); }
     void add_member(const char* key, const std::string& value) { this->add_member(key, YAML::Node(value)); }
     void add_member(const char* key, const std::string_view value) { this->add_member(key, YAML::Node(value.data())); }
@@ -152,7 +147,7 @@ namespace garlic::adapters::yamlcpp {
     void add_member_builder(const char* key, Callable&& cb) {
       YAML::Node value;
       cb(YamlNode(value));
-      this->add_member(key, value);
+      this->add_member(key, std::move(value));
     }
 
     void remove_member(const char* key) { node_.remove(key); }
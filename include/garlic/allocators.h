@@ -1,6 +1,11 @@
 #ifndef GARLIC_ALLOCATORS_H
 #define GARLIC_ALLOCATORS_H
 
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_set>
+
 #include "garlic.h"
 
 namespace garlic {
@@ -41,6 +46,220 @@ namespace garlic {
     void free(void* ptr) { std::free(ptr); }
   };
 
+  //! Monotonic allocator that carves every allocation out of large chunks.
+  /*!
+   * Nothing is given back until the allocator is reset or destroyed, which means values
+   * using it never have to walk their tree to release memory (needs_free is false).
+   * Once every document using the arena is gone, call reset() to reuse the same chunks
+   * for the next batch of values.
+   *
+   * @code
+   * auto arena = std::make_shared<ArenaAllocator>();
+   * {
+   *   GenericCloveDocument<ArenaAllocator> doc(arena);
+   *   // fill and use the document.
+   * }
+   * arena->reset();  // the chunks are ready to be used by the next document.
+   * @endcode
+   */
+  class ArenaAllocator {
+  public:
+    static const bool needs_free = false;
+    static const size_t default_chunk_size = 64 * 1024;
+
+    explicit ArenaAllocator(size_t chunk_size = default_chunk_size) : chunk_size_(chunk_size) {}
+    ArenaAllocator(const ArenaAllocator& another) = delete;
+    ~ArenaAllocator() {
+      while (head_) {
+        auto next = head_->next;
+        std::free(head_);
+        head_ = next;
+      }
+    }
+
+    void* allocate(size_t size) {
+      if (size == 0) return nullptr;
+      size = align(size);
+      if (size > static_cast<size_t>(end_ - cursor_)) this->next_chunk(size);
+      last_ = cursor_;
+      cursor_ += size;
+      return last_;
+    }
+
+    void* reallocate(void* original, size_t old_size, size_t new_size) {
+      if (!original) return this->allocate(new_size);
+      if (new_size == 0) return nullptr;
+      if (original == last_) {
+        // the most recent allocation can grow or shrink in place.
+        if (align(new_size) <= static_cast<size_t>(end_ - last_)) {
+          cursor_ = last_ + align(new_size);
+          return original;
+        }
+      } else if (new_size <= old_size) {
+        return original;
+      }
+      auto result = this->allocate(new_size);
+      std::memcpy(result, original, old_size < new_size ? old_size : new_size);
+      return result;
+    }
+
+    void free(void*) noexcept {}
+
+    //! Rewinds the arena so the chunks allocated so far get reused.
+    /*!
+     * Every pointer handed out before the reset is invalid afterwards, so only call
+     * this once no value refers to the memory of this allocator anymore.
+     */
+    void reset() noexcept {
+      current_ = head_;
+      last_ = nullptr;
+      cursor_ = end_ = nullptr;
+      if (current_) {
+        cursor_ = data(current_);
+        end_ = cursor_ + current_->size;
+      }
+    }
+
+  private:
+    struct chunk {
+      chunk* next;
+      size_t size;
+    };
+
+    static constexpr size_t alignment = alignof(std::max_align_t);
+
+    static constexpr size_t align(size_t size) noexcept {
+      return (size + alignment - 1) & ~(alignment - 1);
+    }
+
+    static char* data(chunk* block) noexcept {
+      return reinterpret_cast<char*>(block) + align(sizeof(chunk));
+    }
+
+    void next_chunk(size_t size) {
+      // reuse the chunks kept around from before the last reset if it is large enough.
+      auto next = current_ ? current_->next : head_;
+      if (!next || next->size < size) {
+        auto capacity = size > chunk_size_ ? size : chunk_size_;
+        auto block = reinterpret_cast<chunk*>(std::malloc(align(sizeof(chunk)) + capacity));
+        block->size = capacity;
+        block->next = next;
+        if (current_) current_->next = block;
+        else head_ = block;
+        next = block;
+      }
+      current_ = next;
+      cursor_ = data(current_);
+      end_ = cursor_ + current_->size;
+    }
+
+    size_t chunk_size_;
+    chunk* head_ = nullptr;
+    chunk* current_ = nullptr;
+    char* cursor_ = nullptr;
+    char* end_ = nullptr;
+    char* last_ = nullptr;
+  };
+
+  //! Keeps one null terminated copy of every distinct key handed to it.
+  /*!
+   * The returned pointers stay valid for as long as the pool lives. This pool is not
+   * thread-safe, use SharedKeyPool to share a pool between threads.
+   */
+  class KeyPool {
+  public:
+    KeyPool() = default;
+    KeyPool(const KeyPool& another) = delete;
+
+    const char* intern(std::string_view key) {
+      if (auto it = keys_.find(key); it != keys_.end()) return it->data();
+      auto data = static_cast<char*>(storage_.allocate(key.size() + 1));
+      std::memcpy(data, key.data(), key.size());
+      data[key.size()] = '\0';
+      keys_.emplace(data, key.size());
+      return data;
+    }
+
+    //! The interned copy of the key or nullptr if it was never interned.
+    const char* find(std::string_view key) const {
+      if (auto it = keys_.find(key); it != keys_.end()) return it->data();
+      return nullptr;
+    }
+
+    size_t size() const noexcept { return keys_.size(); }
+
+  private:
+    ArenaAllocator storage_;
+    std::unordered_set<std::string_view> keys_;
+  };
+
+  //! A KeyPool that can be shared by documents living on different threads.
+  class SharedKeyPool {
+  public:
+    const char* intern(std::string_view key) {
+      {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        if (auto result = pool_.find(key); result) return result;
+      }
+      std::unique_lock<std::shared_mutex> lock(mutex_);
+      return pool_.intern(key);
+    }
+
+    const char* find(std::string_view key) const {
+      std::shared_lock<std::shared_mutex> lock(mutex_);
+      return pool_.find(key);
+    }
+
+    size_t size() const {
+      std::shared_lock<std::shared_mutex> lock(mutex_);
+      return pool_.size();
+    }
+
+  private:
+    mutable std::shared_mutex mutex_;
+    KeyPool pool_;
+  };
+
+  //! An allocator that also interns object keys in a key pool.
+  /*!
+   * Clove values built with this allocator store keys that do not fit inline as a pointer to
+   * the pooled copy rather than allocating a copy for every member, and lookups with an
+   * interned key come down to a pointer comparison. Every allocator gets its own pool
+   * unless one is passed in, which makes it possible to share a pool between documents.
+   *
+   * @code
+   * auto pool = std::make_shared<SharedKeyPool>();
+   * using Allocator = InterningAllocator<CAllocator, SharedKeyPool>;
+   * GenericCloveDocument<Allocator> first(std::make_shared<Allocator>(pool));
+   * GenericCloveDocument<Allocator> second(std::make_shared<Allocator>(pool));
+   * @endcode
+   */
+  template<GARLIC_ALLOCATOR Allocator = CAllocator, typename Pool = KeyPool>
+  class InterningAllocator : public Allocator {
+  public:
+    using PoolType = Pool;
+
+    InterningAllocator() : pool_(std::make_shared<Pool>()) {}
+    explicit InterningAllocator(std::shared_ptr<Pool> pool) : pool_(std::move(pool)) {}
+
+    const char* intern(std::string_view key) { return pool_->intern(key); }
+
+    Pool& get_pool() noexcept { return *pool_; }
+
+  private:
+    std::shared_ptr<Pool> pool_;
+  };
+
+  namespace internal {
+    template<typename, class = void>
+    static constexpr bool has_intern_method = false;
+
+    template<typename Allocator>
+    static constexpr bool has_intern_method<
+      Allocator,
+      std::void_t<decltype(std::declval<Allocator>().intern(std::string_view{}))>> = true;
+  }
+
 }
 
 #endif /* end of include guard: GARLIC_ALLOCATORS_H */
@@ -0,0 +1,50 @@
+#ifndef GARLIC_BATCH_H
+#define GARLIC_BATCH_H
+
+/*! @file batch.h
+ *  @brief Validation of many independent layers at once on a ThreadPool.
+ */
+
+#include <iterator>
+#include <vector>
+
+#include "constraints.h"
+#include "parallel.h"
+
+namespace garlic {
+
+  //! Validates every layer of a range against the model, each on whichever thread of the pool is free.
+  /*! Layers are tested with quick_test() and only the ones that fail it are validated again to
+   *  make a detailed result, valid layers never allocate. The pool steals work between its
+   *  threads, so a few large layers do not keep the others waiting.
+   *
+   *  @param documents any range with random access iterators whose items are layers, like a
+   *                   std::vector<CloveDocument>.
+   *  @return a result for every layer, in the same order as the range.
+   *
+   *  @code
+   *  std::vector<CloveDocument> documents = load_documents();
+   *  auto results = validate_batch(*module.get_model("User"), documents);
+   *  @endcode
+   *
+   *  @note Models, fields and constraints are only read while validating, they must not change
+   *        until the batch is done.
+   */
+  template<typename Range>
+  std::vector<ConstraintResult>
+  validate_batch(const Model& model, const Range& documents, ThreadPool& pool = ThreadPool::shared()) {
+    auto begin = std::begin(documents);
+    auto count = static_cast<size_t>(std::distance(begin, std::end(documents)));
+    std::vector<ConstraintResult> results;
+    results.reserve(count);
+    for (size_t index = 0; index < count; ++index) results.push_back(ConstraintResult::ok());
+    pool.run(count, [&model, &begin, &results](size_t index) {
+        const auto& document = begin[index];
+        if (!model.quick_test(document)) results[index] = model.validate(document);
+        });
+    return results;
+  }
+
+}
+
+#endif /* end of include guard: GARLIC_BATCH_H */
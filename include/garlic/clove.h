@@ -8,9 +8,13 @@
  *  CloveView view = doc.get_view();  // a view to the doc. (conforms to garlic::ViewLayer)
  *  CloveRef ref = doc.get_reference();  // get a reference to the doc. (conforms to garlic::RefLayer)
  *  CloveValue value(doc);  // use the allocator of the document root. (conforms to garlic::RefLayer)
+ *  GenericCloveDocument<ArenaAllocator> arena_doc;  // every node comes out of one arena, freed at once.
  *  @endcode
  */
 
+#include <bit>
+#include <functional>
+
 #include "garlic.h"
 #include "allocators.h"
 #include "layer.h"
@@ -38,15 +42,139 @@ namespace garlic {
     using Object = Array<MemberPair<GenericData>, SizeType>;
     using AllocatorType = Allocator;
 
-    TypeFlag type = TypeFlag::Null;
+    enum flags : uint8_t {
+      none          = 0x0,
+      inline_string  = 0x1 << 0,  //!< the string lives in short_string rather than the allocator.
+      indexed_object = 0x1 << 1,  //!< the hash index after the member array is up to date.
+      pooled_string  = 0x1 << 2,  //!< the string points to an interned key owned by a key pool.
+    };
+
+    //! Strings up to this length are stored inside the value and never touch the allocator.
+    /*!
+     * The last byte of short_string holds the unused capacity, so it doubles as the null
+     * terminator when the string uses every byte.
+     */
+    static constexpr SizeType short_string_capacity = sizeof(List) - 1;
+
+    //! The type of an integer value along with every wider integer type that holds it.
+    /*! Integers too wide for an int can be read as doubles too, the way they were stored before
+     *  clove had 64 bit integers.
+     */
+    static constexpr TypeFlag integer_type(int64_t value) noexcept {
+      uint16_t type = TypeFlag::Int64;
+      if (value >= 0) type |= TypeFlag::UInt64;
+      if (value >= INT32_MIN && value <= INT32_MAX) type |= TypeFlag::Integer;
+      else type |= TypeFlag::Double;
+      return static_cast<TypeFlag>(type);
+    }
+
+    TypeFlag type = TypeFlag::Null;  // integers keep every integer type they can be read as.
+    flags flag = flags::none;
     union {
       double dvalue;
-      int integer;
+      int64_t integer;  // values of UInt64 keep their bits here.
       bool boolean;
       StringData<SizeType> string;
+      char short_string[short_string_capacity + 1];
       List list;
       Object object;
     };
+
+    const char* string_data() const noexcept {
+      return flag & flags::inline_string ? short_string : string.data;
+    }
+
+    SizeType string_length() const noexcept {
+      if (flag & flags::inline_string) {
+        return short_string_capacity - static_cast<SizeType>(short_string[short_string_capacity]);
+      }
+      return string.length;
+    }
+
+    bool string_equals(std::string_view value) const noexcept {
+      if (string_length() != value.size()) return false;
+      auto data = string_data();
+      return data == value.data() || !std::memcmp(data, value.data(), value.size());
+    }
+
+    //! Number of slots in the hash index of an object with the given capacity.
+    static constexpr SizeType index_size(SizeType capacity) noexcept {
+      return std::bit_ceil(static_cast<SizeType>(capacity * 2));
+    }
+
+    //! The hash index is an open addressing table of member positions (plus one) right
+    //! after the member array, only present for objects with a large enough capacity.
+    SizeType* member_index() const noexcept {
+      return reinterpret_cast<SizeType*>(object.data + object.capacity);
+    }
+
+    //! Position of the member with the given key, or the length of the object if missing.
+    SizeType member_position(std::string_view key) const noexcept {
+      if (flag & flags::indexed_object) {
+        auto index = member_index();
+        SizeType mask = index_size(object.capacity) - 1;
+        for (auto slot = std::hash<std::string_view>{}(key) & mask; index[slot]; slot = (slot + 1) & mask) {
+          if (object.data[index[slot] - 1].key.string_equals(key)) return index[slot] - 1;
+        }
+        return object.length;
+      }
+      for (SizeType position = 0; position < object.length; ++position) {
+        if (object.data[position].key.string_equals(key)) return position;
+      }
+      return object.length;
+    }
+
+    void index_member(SizeType position) noexcept {
+      auto index = member_index();
+      const auto& key = object.data[position].key;
+      SizeType mask = index_size(object.capacity) - 1;
+      auto slot = std::hash<std::string_view>{}({key.string_data(), key.string_length()}) & mask;
+      while (index[slot]) slot = (slot + 1) & mask;
+      index[slot] = position + 1;
+    }
+
+    void rebuild_index() noexcept {
+      std::memset(member_index(), 0, index_size(object.capacity) * sizeof(SizeType));
+      for (SizeType position = 0; position < object.length; ++position) this->index_member(position);
+      flag = static_cast<flags>(flag | flags::indexed_object);
+    }
+  };
+
+  //! Decides how much room clove lists and objects get when they need to grow.
+  /*!
+   * Lists and objects do not allocate anything until the first item is added, at which
+   * point they get room for InitialCapacity items. After that the capacity is multiplied
+   * by GrowthNumerator / GrowthDenominator every time it runs out.
+   *
+   * Objects whose capacity reaches IndexThreshold members also keep a hash index next to
+   * their member array so find_member() no longer scans every member. The index is kept up
+   * to date as members are added and removed; handing out mutable member iterators through
+   * begin_member() or get_object() marks it stale (keys may get renamed) and the next
+   * find_member() on a reference rebuilds it. Views fall back to a linear scan meanwhile.
+   *
+   * @code
+   * // start with 16 slots and double the capacity every time.
+   * using Document = GenericCloveDocument<CAllocator, unsigned, CloveGrowthPolicy<16, 2, 1>>;
+   * @endcode
+   */
+  template<
+    unsigned InitialCapacity = 4,
+    unsigned GrowthNumerator = 3,
+    unsigned GrowthDenominator = 2,
+    unsigned IndexThreshold = 16>
+  struct CloveGrowthPolicy {
+    static_assert(InitialCapacity > 0, "initial capacity must be positive.");
+    static_assert(GrowthNumerator > GrowthDenominator, "growth factor must be greater than one.");
+
+    static constexpr unsigned index_threshold = IndexThreshold;
+
+    template<typename SizeType>
+    static constexpr SizeType next_capacity(SizeType capacity) noexcept {
+      if (capacity < InitialCapacity) return InitialCapacity;
+      SizeType grown = capacity / GrowthDenominator * GrowthNumerator
+        + capacity % GrowthDenominator * GrowthNumerator / GrowthDenominator;
+      return grown > capacity ? grown : capacity + 1;
+    }
   };
 
   template<typename Layer, typename Iterator>
@@ -114,16 +242,25 @@ namespace garlic {
     bool is_object() const noexcept { return data_.type & TypeFlag::Object; }
     bool is_list() const noexcept { return data_.type & TypeFlag::List; }
     bool is_bool() const noexcept { return data_.type & TypeFlag::Boolean; }
-
-    int get_int() const { return data_.integer; }
-    double get_double() const { return data_.dvalue; }
+    bool is_int64() const noexcept { return data_.type & TypeFlag::Int64; }
+    bool is_uint64() const noexcept { return data_.type & TypeFlag::UInt64; }
+    TypeFlag get_type() const noexcept { return data_.type; }
+
+    int get_int() const { return static_cast<int>(data_.integer); }
+    int64_t get_int64() const { return data_.integer; }
+    uint64_t get_uint64() const { return static_cast<uint64_t>(data_.integer); }
+    double get_double() const {
+      if (data_.type & TypeFlag::Int64) return static_cast<double>(data_.integer);
+      if (data_.type & TypeFlag::UInt64) return static_cast<double>(static_cast<uint64_t>(data_.integer));
+      return data_.dvalue;
+    }
     bool get_bool() const { return data_.boolean; }
-    const char* get_cstr() const { return data_.string.data; }
+    const char* get_cstr() const { return data_.string_data(); }
     std::string get_string() const {
-      return std::string{data_.string.data, data_.string.length};
+      return std::string{data_.string_data(), data_.string_length()};
     }
     std::string_view get_string_view() const {
-      return std::string_view{data_.string.data, data_.string.length};
+      return std::string_view{data_.string_data(), data_.string_length()};
     }
 
     ConstValueIterator begin_list() const { return ConstValueIterator({data_.list.data}); }
@@ -137,12 +274,12 @@ namespace garlic {
       return ConstMemberIterator({data_.object.data + data_.object.length});
     }
     ConstMemberIterator find_member(text key) const {
-      return std::find_if(this->begin_member(), this->end_member(), [&key](auto item) {
-        return strncmp(item.key.get_cstr(), key.data(), key.size()) == 0;
+      return ConstMemberIterator({
+        data_.object.data + data_.member_position(std::string_view{key.data(), key.size()})
       });
     }
     ConstMemberIterator find_member(const GenericCloveView& value) const {
-      return this->find_member(value.get_cstr());
+      return this->find_member(value.get_string_view());
     }
     auto get_object() const { return ConstMemberRange<GenericCloveView>{*this}; }
 
@@ -154,12 +291,16 @@ namespace garlic {
   };
 
 
-  template<GARLIC_ALLOCATOR Allocator, typename SizeType = unsigned>
-  class GenericCloveRef : public GenericCloveView<Allocator> {
+  template<
+    GARLIC_ALLOCATOR Allocator,
+    typename SizeType = unsigned,
+    typename GrowthPolicy = CloveGrowthPolicy<>>
+  class GenericCloveRef : public GenericCloveView<Allocator, SizeType> {
   public:
     using ViewType = GenericCloveView<Allocator, SizeType>;
     using DataType = typename ViewType::DataType;
     using AllocatorType = Allocator;
+    using GrowthPolicyType = GrowthPolicy;
     using ProviderValueIterator = typename ViewType::ProviderValueIterator;
     using ProviderMemberIterator = typename ViewType::ProviderMemberIterator;
     using ValueIterator = RandomAccessIterator<
@@ -180,13 +321,11 @@ namespace garlic {
 
 
     void set_string(const char* str) {
-      this->prepare_string(strlen(str));
-      strcpy(this->data_.string.data, str);
+      strcpy(this->prepare_string(strlen(str)), str);
     }
 
     void set_string(text value) {
-      this->prepare_string(value.size());
-      strncpy(this->data_.string.data, value.data(), value.size());
+      strncpy(this->prepare_string(value.size()), value.data(), value.size());
     }
 
     void set_double(double value) {
@@ -196,9 +335,20 @@ namespace garlic {
     }
     void set_int(int value) {
       this->clean();
-      this->data_.type = TypeFlag::Integer;
+      this->data_.type = DataType::integer_type(value);
       this->data_.integer = value;
     }
+    void set_int64(int64_t value) {
+      this->clean();
+      this->data_.type = DataType::integer_type(value);
+      this->data_.integer = value;
+    }
+    void set_uint64(uint64_t value) {
+      if (value <= INT64_MAX) return this->set_int64(static_cast<int64_t>(value));
+      this->clean();
+      this->data_.type = static_cast<TypeFlag>(TypeFlag::UInt64 | TypeFlag::Double);
+      this->data_.integer = static_cast<int64_t>(value);
+    }
     void set_bool(bool value) {
       this->clean();
       this->data_.type = TypeFlag::Boolean;
@@ -212,25 +362,36 @@ namespace garlic {
       if (this->is_list()) return;
       this->clean();
       this->data_.type = TypeFlag::List;
-      this->data_.list.data = reinterpret_cast<typename DataType::List::Container>(
-          allocator_.allocate(256 * sizeof(DataType))
-      );
+      this->data_.list.data = nullptr;
       this->data_.list.length = 0;
-      this->data_.list.capacity = 16;
+      this->data_.list.capacity = 0;
     }
     void set_object() {
       if (this->is_object()) return;
       this->clean();
       this->data_.type = TypeFlag::Object;
-      this->data_.object.data = reinterpret_cast<typename DataType::Object::Container>(
-          allocator_.allocate(16 * sizeof(MemberPair<DataType>))
-      );
+      this->data_.flag = DataType::flags::none;
+      this->data_.object.data = nullptr;
       this->data_.object.length = 0;
-      this->data_.object.capacity = 16;
+      this->data_.object.capacity = 0;
+    }
+
+    //! Makes room for at least capacity items (or members) in a list (or an object).
+    /*!
+     * Has no effect on other types or when there is already enough room.
+     */
+    void reserve(SizeType capacity) {
+      if (this->is_list()) {
+        if (capacity > this->data_.list.capacity) this->resize_list(capacity);
+      } else if (this->is_object()) {
+        if (capacity > this->data_.object.capacity) this->resize_members(capacity);
+      }
     }
 
     GenericCloveRef& operator = (double value) { this->set_double(value); return *this; }
     GenericCloveRef& operator = (int value) { this->set_int(value); return *this; }
+    GenericCloveRef& operator = (int64_t value) { this->set_int64(value); return *this; }
+    GenericCloveRef& operator = (uint64_t value) { this->set_uint64(value); return *this; }
     GenericCloveRef& operator = (bool value) { this->set_bool(value); return *this; }
     GenericCloveRef& operator = (text value) { this->set_string(value); return *this; }
 
@@ -242,7 +403,11 @@ namespace garlic {
     }
     ListRange<GenericCloveRef> get_list() { return ListRange<GenericCloveRef>{*this}; }
 
-    MemberIterator begin_member() { return MemberIterator({data_.object.data, &allocator_}); }
+    MemberIterator begin_member() {
+      // keys can be renamed through these iterators so the index has to be rebuilt later.
+      data_.flag = static_cast<typename DataType::flags>(data_.flag & ~DataType::flags::indexed_object);
+      return MemberIterator({data_.object.data, &allocator_});
+    }
     MemberIterator end_member() {
       return MemberIterator({
         data_.object.data + data_.object.length,
@@ -290,6 +455,16 @@ namespace garlic {
       GenericCloveRef(data, allocator_).set_int(value);
       this->push_back(std::move(data));
     }
+    void push_back(int64_t value) {
+      DataType data;
+      GenericCloveRef(data, allocator_).set_int64(value);
+      this->push_back(std::move(data));
+    }
+    void push_back(uint64_t value) {
+      DataType data;
+      GenericCloveRef(data, allocator_).set_uint64(value);
+      this->push_back(std::move(data));
+    }
     void push_back(bool value) {
       DataType data;
       GenericCloveRef(data, allocator_).set_bool(value);
@@ -313,8 +488,12 @@ namespace garlic {
 
     // member functions
     MemberIterator find_member(text key) {
-      return std::find_if(this->begin_member(), this->end_member(), [&key](auto item) {
-        return key.compare(item.key.get_cstr()) == 0;
+      if (!(data_.flag & DataType::flags::indexed_object) && this->has_member_index()) {
+        data_.rebuild_index();
+      }
+      return MemberIterator({
+        data_.object.data + data_.member_position(std::string_view{key.data(), key.size()}),
+        &allocator_
       });
     }
 
@@ -329,9 +508,10 @@ namespace garlic {
       this->check_members();
       this->data_.object.data[this->data_.object.length] = MemberPair<DataType>{std::move(key), std::move(value)};
       this->data_.object.length++;
+      if (data_.flag & DataType::flags::indexed_object) data_.index_member(data_.object.length - 1);
     }
     void add_member(text key, DataType&& value) {
-      DataType data; GenericCloveRef(data, allocator_).set_string(key);
+      DataType data; GenericCloveRef(data, allocator_).set_key(key);
       this->add_member(std::move(data), std::move(value));
     }
     void add_member(text key) {
@@ -356,6 +536,14 @@ namespace garlic {
       DataType data; GenericCloveRef(data, allocator_).set_int(value);
       this->add_member(key, std::move(data));
     }
+    void add_member(text key, int64_t value) {
+      DataType data; GenericCloveRef(data, allocator_).set_int64(value);
+      this->add_member(key, std::move(data));
+    }
+    void add_member(text key, uint64_t value) {
+      DataType data; GenericCloveRef(data, allocator_).set_uint64(value);
+      this->add_member(key, std::move(data));
+    }
     void remove_member(text key) {
       auto it = this->find_member(key);
       if (it != this->end_member()) this->erase_member(it);
@@ -368,6 +556,8 @@ namespace garlic {
           static_cast<void*>(position.get_inner_iterator() + 1),
           static_cast<SizeType>(this->end_member().get_inner_iterator() - position.get_inner_iterator() - 1) * sizeof(MemberPair<DataType>)
       );
+      this->data_.object.length--;
+      if (data_.flag & DataType::flags::indexed_object) data_.rebuild_index();
     }
 
     GenericCloveRef get_reference() { return GenericCloveRef(data_, allocator_); }
@@ -380,38 +570,79 @@ namespace garlic {
     void check_list() {
       // make sure we have enough space for another item.
       if (this->data_.list.length >= this->data_.list.capacity) {
-        auto new_capacity = this->data_.list.capacity + (this->data_.list.capacity + 1) / 2;
-        this->data_.list.data = reinterpret_cast<typename DataType::List::Container>(
-          allocator_.reallocate(
-            this->data_.list.data,
-            this->data_.list.capacity * sizeof(DataType),
-            new_capacity * sizeof(DataType))
-        );
-        this->data_.list.capacity = new_capacity;
+        this->resize_list(GrowthPolicy::next_capacity(this->data_.list.capacity));
       }
     }
 
     void check_members() {
       // make sure we have enough space for another member.
       if (this->data_.object.length >= this->data_.object.capacity) {
-        auto new_capacity = this->data_.object.capacity + (this->data_.object.capacity + 1) / 2;
-        this->data_.object.data = reinterpret_cast<typename DataType::Object::Container>(
-          allocator_.reallocate(
-            this->data_.object.data,
-            this->data_.object.capacity * sizeof(DataType),
-            new_capacity * sizeof(DataType))
-        );
-        this->data_.object.capacity = new_capacity;
+        this->resize_members(GrowthPolicy::next_capacity(this->data_.object.capacity));
       }
     }
 
-    inline void prepare_string(SizeType length) {
+    void resize_list(SizeType capacity) {
+      this->data_.list.data = reinterpret_cast<typename DataType::List::Container>(
+        allocator_.reallocate(
+          this->data_.list.data,
+          this->data_.list.capacity * sizeof(DataType),
+          capacity * sizeof(DataType))
+      );
+      this->data_.list.capacity = capacity;
+    }
+
+    void resize_members(SizeType capacity) {
+      this->data_.object.data = reinterpret_cast<typename DataType::Object::Container>(
+        allocator_.reallocate(
+          this->data_.object.data,
+          members_size(this->data_.object.capacity),
+          members_size(capacity))
+      );
+      this->data_.object.capacity = capacity;
+      if (this->has_member_index()) data_.rebuild_index();
+    }
+
+    inline bool has_member_index() const noexcept {
+      return this->is_object() && this->data_.object.capacity >= GrowthPolicy::index_threshold;
+    }
+
+    static constexpr size_t members_size(SizeType capacity) noexcept {
+      auto size = capacity * sizeof(MemberPair<DataType>);
+      if (capacity >= GrowthPolicy::index_threshold) size += DataType::index_size(capacity) * sizeof(SizeType);
+      return size;
+    }
+
+    inline void set_key(text key) {
+      if constexpr (internal::has_intern_method<AllocatorType>) {
+        // short keys are stored inline which is cheaper than going through the pool.
+        if (key.size() > DataType::short_string_capacity) {
+          this->clean();
+          this->data_.type = TypeFlag::String;
+          this->data_.flag = DataType::flags::pooled_string;
+          this->data_.string.length = key.size();
+          this->data_.string.data = const_cast<char*>(
+              allocator_.intern(std::string_view{key.data(), key.size()}));
+          return;
+        }
+      }
+      this->set_string(key);
+    }
+
+    inline char* prepare_string(SizeType length) {
       this->clean();
       this->data_.type = TypeFlag::String;
+      if (length <= DataType::short_string_capacity) {
+        this->data_.flag = DataType::flags::inline_string;
+        this->data_.short_string[DataType::short_string_capacity] = DataType::short_string_capacity - length;
+        this->data_.short_string[length] = '\0';  // make it null terminated.
+        return this->data_.short_string;
+      }
+      this->data_.flag = DataType::flags::none;
       this->data_.string.length = length;
       this->data_.string.data = reinterpret_cast<char*>(
           allocator_.allocate(sizeof(char) * (length + 1)));
       this->data_.string.data[length] = '\0';  // make it null terminated.
+      return this->data_.string.data;
     }
 
     void clean() {
@@ -419,7 +650,9 @@ namespace garlic {
       switch (data_.type) {
       case TypeFlag::String:
         {
-          allocator_.free(const_cast<char*>(data_.string.data));
+          if (!(data_.flag & (DataType::flags::inline_string | DataType::flags::pooled_string))) {
+            allocator_.free(data_.string.data);
+          }
         }
         break;
       case TypeFlag::Object:
@@ -444,19 +677,22 @@ namespace garlic {
   };
 
 
-  template<GARLIC_ALLOCATOR Allocator, typename SizeType = unsigned>
-  class GenericCloveDocument : public GenericCloveRef<Allocator, SizeType> {
+  template<
+    GARLIC_ALLOCATOR Allocator,
+    typename SizeType = unsigned,
+    typename GrowthPolicy = CloveGrowthPolicy<>>
+  class GenericCloveDocument : public GenericCloveRef<Allocator, SizeType, GrowthPolicy> {
   public:
     using DataType = GenericData<Allocator, SizeType>;
     using ViewType = GenericCloveView<Allocator, SizeType>;
-    using ReferenceType = GenericCloveRef<Allocator, SizeType>;
-    using DocumentType = GenericCloveDocument<Allocator, SizeType>;
+    using ReferenceType = GenericCloveRef<Allocator, SizeType, GrowthPolicy>;
+    using DocumentType = GenericCloveDocument<Allocator, SizeType, GrowthPolicy>;
 
     explicit GenericCloveDocument(
         std::shared_ptr<Allocator> allocator
         ) : allocator_(allocator), ReferenceType(data_, *allocator) {}
     GenericCloveDocument(
-        ) : allocator_(std::make_shared<Allocator>()), ReferenceType(data_, *allocator_) {}
+        ) : GenericCloveDocument(std::make_shared<Allocator>()) {}
     ~GenericCloveDocument() { this->get_reference().set_null(); }
 
     Allocator& get_allocator() { return *allocator_; }
@@ -467,13 +703,16 @@ namespace garlic {
   };
 
 
-  template<GARLIC_ALLOCATOR Allocator, typename SizeType = unsigned>
-  class GenericCloveValue : public GenericCloveRef<Allocator, SizeType> {
+  template<
+    GARLIC_ALLOCATOR Allocator,
+    typename SizeType = unsigned,
+    typename GrowthPolicy = CloveGrowthPolicy<>>
+  class GenericCloveValue : public GenericCloveRef<Allocator, SizeType, GrowthPolicy> {
   public:
-    using DataType = GenericData<Allocator>;
-    using ViewType = GenericCloveView<Allocator>;
-    using ReferenceType = GenericCloveRef<Allocator>;
-    using DocumentType = GenericCloveDocument<Allocator>;
+    using DataType = GenericData<Allocator, SizeType>;
+    using ViewType = GenericCloveView<Allocator, SizeType>;
+    using ReferenceType = GenericCloveRef<Allocator, SizeType, GrowthPolicy>;
+    using DocumentType = GenericCloveDocument<Allocator, SizeType, GrowthPolicy>;
 
     explicit GenericCloveValue(
         DocumentType& root) : ReferenceType(data_, root.get_allocator()) {}
@@ -4,17 +4,45 @@
 //! @file constraints.h @brief Contains constraints, built-in constraint tags, fields and models.
 
 #include <algorithm>
+#include <bit>
+#include <memory>
 #include <unordered_set>
-#include <regex>
+#include <vector>
 
 #include "layer.h"
 #include "utility.h"
+#include "allocators.h"
 #include "containers.h"
+#include "parallel.h"
+#include "profiling.h"
+#include "regex.h"
 
 
 namespace garlic {
 
+  namespace internal {
+    //! The arena failure results of this thread are made in, if any.
+    inline thread_local ArenaAllocator* result_arena = nullptr;
+
+    //! Makes failure results take their memory from an arena until the scope ends.
+    class result_arena_scope {
+    public:
+      explicit result_arena_scope(ArenaAllocator& arena) noexcept : previous_(result_arena) {
+        result_arena = &arena;
+      }
+      result_arena_scope(const result_arena_scope&) = delete;
+      ~result_arena_scope() { result_arena = previous_; }
+
+    private:
+      ArenaAllocator* previous_;
+    };
+  }
+
   //! Result of a constriant test.
+  /*! Details and names of failures are allocated one by one unless the test runs with an
+   *  ArenaAllocator, see Model::validate(), Field::validate() and Constraint::test(), in which
+   *  case the whole tree is carved out of the arena and released at once by resetting it.
+   */
   struct ConstraintResult {
 
     using constraint_sequence = sequence<ConstraintResult>;
@@ -69,7 +97,7 @@ namespace garlic {
         text&& name,
         ConstraintResult&& inner_detail,
         text&& reason = text::no_text()) noexcept {
-      sequence<ConstraintResult> details(1);
+      auto details = make_details(1);
       details.push_back(std::move(inner_detail));
       return ConstraintResult {
         .details = std::move(details),
@@ -88,6 +116,31 @@ namespace garlic {
       };
     }
 
+    //! @return an empty sequence of details, in the arena of the current test if it has one.
+    /*! With no capacity, memory is only taken once the first detail is added. */
+    static inline constraint_sequence make_details(unsigned capacity = 0) noexcept {
+      if (auto arena = internal::result_arena; arena) return constraint_sequence(capacity, *arena);
+      return constraint_sequence(capacity);
+    }
+
+    //! @return a copy of the value, a view into the arena of the current test if it has one.
+    static inline text make_text(std::string_view value) noexcept {
+      if (auto arena = internal::result_arena; arena) {
+        auto data = static_cast<char*>(arena->allocate(value.size() + 1));
+        std::memcpy(data, value.data(), value.size());
+        data[value.size()] = '\0';
+        return text(data, value.size());
+      }
+      return text::copy(value);
+    }
+
+    //! @return the name of the detail for an item of a list.
+    static inline text index_text(size_t index) noexcept {
+      char buffer[24];
+      auto end = std::to_chars(buffer, buffer + sizeof(buffer), index).ptr;
+      return make_text(std::string_view(buffer, end - buffer));
+    }
+
   };
 
   class constraint_context {
@@ -114,7 +167,7 @@ namespace garlic {
     template<bool Field = false, bool Leaf = true>
     auto fail() const noexcept -> ConstraintResult {
       return ConstraintResult {
-        .details = (Leaf ? sequence<ConstraintResult>::no_sequence() : sequence<ConstraintResult>()),
+        .details = (Leaf ? sequence<ConstraintResult>::no_sequence() : ConstraintResult::make_details()),
         .name = name,
         .reason = message,
         .flag = (Field ? ConstraintResult::flags::field : ConstraintResult::flags::none)
@@ -125,7 +178,7 @@ namespace garlic {
     auto fail(const text& message) const noexcept -> ConstraintResult {
       if (this->message.empty())
         return ConstraintResult {
-          .details = (Leaf ? sequence<ConstraintResult>::no_sequence() : sequence<ConstraintResult>()),
+          .details = (Leaf ? sequence<ConstraintResult>::no_sequence() : ConstraintResult::make_details()),
           .name = name,
           .reason = message,
           .flag = (Field ? ConstraintResult::flags::field : ConstraintResult::flags::none)
@@ -145,7 +198,7 @@ namespace garlic {
 
     template<bool Field = false>
     auto fail(const text& message, ConstraintResult&& inner_detail) const noexcept {
-      sequence<ConstraintResult> details(1);
+      auto details = ConstraintResult::make_details(1);
       details.push_back(std::move(inner_detail));
       return this->fail<Field>(message, std::move(details));
     }
@@ -305,6 +358,13 @@ namespace garlic {
     template<GARLIC_VIEW Layer>
     inline ConstraintResult test(const Layer& value) const noexcept;
 
+    //! Same as test() but the result is made in the arena, it has to be gone before the arena is reset.
+    template<GARLIC_VIEW Layer>
+    inline ConstraintResult test(const Layer& value, ArenaAllocator& arena) const noexcept {
+      internal::result_arena_scope scope(arena);
+      return this->test(value);
+    }
+
     //! Very similar to Constraint::test() but it only returns a boolean.
     /*! @tparam Layer any readable layer that conforms to the garlic::ViewLayer concept.
      */
@@ -319,6 +379,10 @@ namespace garlic {
       return *context_;
     }
 
+    //! @return whether or not the constraint was made with the Tag.
+    template<typename Tag>
+    inline bool is() const noexcept;
+
     template<typename Tag>
     inline const auto& context_for() const noexcept {
       return *reinterpret_cast<typename Tag::context_type*>(context_.get());
@@ -333,6 +397,9 @@ namespace garlic {
     friend inline Constraint make_constraint(Args&&...) noexcept;
   };
 
+  template<typename Tag, typename... Args>
+  inline Constraint make_constraint(Args&&... args) noexcept;
+
 
   //! Run a number of constraints on a layer.
   /*! @tparam Layer any readable layer that conforms to garlic::ViewLayer concept.
@@ -420,6 +487,14 @@ namespace garlic {
           if (layer.is_int()) { return context.ok(); }
           else return context.fail("Expected integer type.");
         }
+        case TypeFlag::Int64: {
+          if (garlic::is_int64(layer)) { return context.ok(); }
+          else return context.fail("Expected a 64 bit integer.");
+        }
+        case TypeFlag::UInt64: {
+          if (garlic::is_uint64(layer)) { return context.ok(); }
+          else return context.fail("Expected an unsigned 64 bit integer.");
+        }
         case TypeFlag::String: {
           if (layer.is_string()) { return context.ok(); }
           else return context.fail("Expected string type.");
@@ -444,6 +519,8 @@ namespace garlic {
         case TypeFlag::Boolean: return layer.is_bool();
         case TypeFlag::Double: return layer.is_double();
         case TypeFlag::Integer: return layer.is_int();
+        case TypeFlag::Int64: return garlic::is_int64(layer);
+        case TypeFlag::UInt64: return garlic::is_uint64(layer);
         case TypeFlag::String: return layer.is_string();
         case TypeFlag::List: return layer.is_list();
         case TypeFlag::Object: return layer.is_object();
@@ -483,45 +560,75 @@ namespace garlic {
     template<GARLIC_VIEW Layer>
     static ConstraintResult
     test(const Layer& layer, const Context& context) noexcept {
-      if (layer.is_string()) {
+      auto type = internal::probe_type(layer);
+      if (type.is_string()) {
         auto length = layer.get_string_view().size();
         if (length > context.max || length < context.min) return context.fail("invalid string length.");
-      } else if (layer.is_double()) {
+      } else if (bool passed; range_tag::test_integer(layer, type, context.min, context.max, passed)) {
+        if (!passed) return context.fail("out of range value.");
+      } else if (type.is_double()) {
         auto dvalue = layer.get_double();
         if(dvalue > context.max || dvalue < context.min) return context.fail("out of range value.");
-      } else if (layer.is_int()) {
-        auto ivalue = layer.get_int();
-        if(static_cast<size_type>(ivalue) > context.max || static_cast<size_type>(ivalue) < context.min)
-          return context.fail("out of range value.");
-      } else if (layer.is_list()) {
-        size_type count = garlic::list_size(layer);
-        if (count > context.max)
-          return context.fail("too many items in the list.");
-        if (count < context.min)
-          return context.fail("too few items in the list.");
+      } else if (type.is_list()) {
+        if (auto reason = range_tag::list_size_failure(garlic::list_size(layer), context); reason)
+          return context.fail(reason);
       }
       return context.ok();
     }
 
+    //! Checks integers against the bounds without going through a double, wide ones keep their precision.
+    /*! @return true if the layer holds an integer, with the verdict in passed. */
+    template<GARLIC_VIEW Layer, typename Probe>
+    static inline bool
+    test_integer(const Layer& layer, const Probe& type, size_type min, size_type max, bool& passed) noexcept {
+      if constexpr (internal::has_int64_methods<Layer>) {
+        if (type.is_uint64()) {
+          passed = range_tag::in_range(layer.get_uint64(), min, max);
+          return true;
+        }
+        if (type.is_int64()) {
+          passed = range_tag::in_range(layer.get_int64(), min, max);
+          return true;
+        }
+      }
+      if (type.is_int()) {
+        passed = range_tag::in_range(int64_t{layer.get_int()}, min, max);
+        return true;
+      }
+      return false;
+    }
+
+    //! Compares a signed value against the bounds, a negative value fails the minimum.
+    static inline bool in_range(int64_t value, size_type min, size_type max) noexcept {
+      return value >= 0 && range_tag::in_range(static_cast<uint64_t>(value), min, max);
+    }
+
+    static inline bool in_range(uint64_t value, size_type min, size_type max) noexcept {
+      return value >= min && value <= max;
+    }
+
+    //! @return the reason a list with count items fails the range, or nullptr if it passes.
+    static inline const char*
+    list_size_failure(size_type count, const Context& context) noexcept {
+      if (count > context.max) return "too many items in the list.";
+      if (count < context.min) return "too few items in the list.";
+      return nullptr;
+    }
+
     template<GARLIC_VIEW Layer>
     static bool
     quick_test(const Layer& layer, const Context& context) noexcept {
-      if (layer.is_string()) {
+      auto type = internal::probe_type(layer);
+      if (type.is_string()) {
         auto length = layer.get_string_view().size();
         if (length > context.max || length < context.min) return false;
-      } else if (layer.is_double()) {
+      } else if (bool passed; range_tag::test_integer(layer, type, context.min, context.max, passed)) {
+        return passed;
+      } else if (type.is_double()) {
         auto dvalue = layer.get_double();
         if(dvalue > context.max || dvalue < context.min) return false;
-      } else if (layer.is_int()) {
-        auto ivalue = layer.get_int();
-        if(static_cast<size_type>(ivalue) > context.max || static_cast<size_type>(ivalue) < context.min)
-          return false;
-      } else if (layer.is_list()) {
-        size_type count = garlic::list_size(layer);
-        if (count > context.max)
-          return false;
-        if (count < context.min)
-          return false;
+      } else if (type.is_list()) {
+        return !range_tag::list_size_failure(garlic::list_size(layer), context);
       }
       return true;
 
@@ -531,6 +638,7 @@ namespace garlic {
 
   //! Constraint Tag that passes if a specified regex pattern passes the test.
   /*! @note It passes the test if the layer is not a string type.
+   *  @note Patterns are matched with a regex_matcher, see regex.h for the supported syntax.
    *
    *  @code{.cpp}
    *  make_constraint<regex_tag>(text&& pattern);
@@ -542,9 +650,14 @@ namespace garlic {
       template<typename... Args>
       Context(text&& pattern, text&& name = "regex_constraint", Args&&... args
           ) : constraint_context(std::move(name), std::forward<Args>(args)...),
-              pattern(pattern.data(), pattern.size()) {}
+              pattern(std::string_view{pattern.data(), pattern.size()}) {}
 
-      std::regex pattern;
+      template<typename... Args>
+      Context(regex_matcher&& pattern, text&& name = "regex_constraint", Args&&... args
+          ) : constraint_context(std::move(name), std::forward<Args>(args)...),
+              pattern(std::move(pattern)) {}
+
+      regex_matcher pattern;
     };
 
     using context_type = Context;
@@ -553,7 +666,7 @@ namespace garlic {
     static inline ConstraintResult
     test(const Layer& layer, const Context& context) noexcept {
       if (!layer.is_string()) return context.ok();
-      if (std::regex_match(layer.get_cstr(), context.pattern)) { return context.ok(); }
+      if (context.pattern.match(layer.get_string_view())) { return context.ok(); }
       else { return context.fail("invalid value."); }
     }
 
@@ -561,7 +674,7 @@ namespace garlic {
     static inline bool
     quick_test(const Layer& layer, const Context& context) noexcept {
       if (!layer.is_string()) return true;
-      if (std::regex_match(layer.get_cstr(), context.pattern)) return true;
+      if (context.pattern.match(layer.get_string_view())) return true;
       else return false;
     }
   };
@@ -607,20 +720,29 @@ namespace garlic {
    *  @note If the layer is not a *list*, the test will fail.
    *
    *  @code{.cpp}
-   *  make_constraint<list_tag>(Constraint&& constraint);
+   *  make_constraint<list_tag>(Constraint&& constraint,
+                                bool ignore_details = false,
+                                size_t parallel_threshold = 0);
    *  @endcode
+   *
+   *  @param parallel_threshold lists of layers with random access iterators that have at least
+   *                            this many items are split across ThreadPool::shared(). The result
+   *                            is the same as the serial one, the failure with the lowest index.
+   *                            Zero keeps every list serial.
    */
   struct list_tag {
     struct Context : public constraint_context {
       template<typename... Args>
       Context(
-          Constraint&& constraint, bool ignore_details = false,
+          Constraint&& constraint, bool ignore_details = false, size_t parallel_threshold = 0,
           text&& name = "list_constraint", Args&&... args
           ) : constraint_context(std::move(name), std::forward<Args>(args)...),
-              constraint(std::move(constraint)), ignore_details(ignore_details) {}
+              constraint(std::move(constraint)), ignore_details(ignore_details),
+              parallel_threshold(parallel_threshold) {}
 
       Constraint constraint;
       bool ignore_details;
+      size_t parallel_threshold;
     };
 
     using context_type = Context;
@@ -629,6 +751,14 @@ namespace garlic {
     static ConstraintResult
     test(const Layer& layer, const Context& context) noexcept {
       if (!layer.is_list()) return context.fail("Expected a list.");
+      if constexpr (internal::has_random_access_list_iterator<Layer>) {
+        if (auto count = list_tag::parallel_count(layer, context); count) {
+          auto index = list_tag::first_failure(layer, context, count);
+          if (index == count) return context.ok();
+          if (context.ignore_details) return list_tag::fail<true>(context, index, layer.begin_list()[index]);
+          return list_tag::fail<false>(context, index, layer.begin_list()[index]);
+        }
+      }
       if (context.ignore_details)
         return list_tag::test<true>(layer, context);
       return list_tag::test<false>(layer, context);
@@ -638,12 +768,50 @@ namespace garlic {
     static bool
     quick_test(const Layer& layer, const Context& context) noexcept {
       if (!layer.is_list()) return false;
+      if constexpr (internal::has_random_access_list_iterator<Layer>) {
+        if (auto count = list_tag::parallel_count(layer, context); count)
+          return list_tag::first_failure(layer, context, count) == count;
+      }
       return std::all_of(
           layer.begin_list(), layer.end_list(),
           [&context](const auto& item) { return context.constraint.quick_test(item); }
           );
     }
 
+  private:
+    //! @return the size of the list if it should be split across threads, otherwise zero.
+    template<GARLIC_VIEW Layer>
+    static inline size_t parallel_count(const Layer& layer, const Context& context) noexcept {
+      if (!context.parallel_threshold || ThreadPool::shared().concurrency() == 1) return 0;
+      auto count = garlic::list_size(layer);
+      return count >= context.parallel_threshold ? count : 0;
+    }
+
+    //! @return the lowest index of an item that fails the inner constraint, count if there is none.
+    template<GARLIC_VIEW Layer>
+    static size_t first_failure(const Layer& layer, const Context& context, size_t count) noexcept {
+      auto& pool = ThreadPool::shared();
+      // a few chunks per thread so that threads that finish early help the others.
+      auto grain = std::max<size_t>(256, count / (pool.concurrency() * 4));
+      auto begin = layer.begin_list();
+      return pool.find_first_failure(count, grain, [&context, &begin](size_t index) {
+          return context.constraint.quick_test(begin[index]);
+          });
+    }
+
+    template<bool IgnoreDetails, GARLIC_VIEW Layer>
+    static inline ConstraintResult fail(const Context& context, size_t index, const Layer& item) noexcept {
+      if (IgnoreDetails) {
+        return context.fail(
+            "Invalid value found in the list.",
+            ConstraintResult::leaf_field_failure(ConstraintResult::index_text(index), "invalid value."));
+      }
+      return context.fail(
+          "Invalid value found in the list.",
+          ConstraintResult::field_failure(
+            ConstraintResult::index_text(index), context.constraint.test(item), "invalid value."));
+    }
+
     template<bool IgnoreDetails, GARLIC_VIEW Layer>
     inline static ConstraintResult test(const Layer& layer, const Context& context) noexcept {
       size_t index = 0;
@@ -653,7 +821,7 @@ namespace garlic {
             return context.fail(
                 "Invalid value found in the list.",
                 ConstraintResult::leaf_field_failure(
-                  text::copy(std::to_string(index)),
+                  ConstraintResult::index_text(index),
                   "invalid value."));
           }
         } else {
@@ -662,7 +830,7 @@ namespace garlic {
             return context.fail(
                 "Invalid value found in the list.",
                 ConstraintResult::field_failure(
-                  text::copy(std::to_string(index)),
+                  ConstraintResult::index_text(index),
                   std::move(result),
                   "invalid value."
                   ));
@@ -749,7 +917,7 @@ namespace garlic {
             return context.fail(
                 "Invalid value found in the tuple.",
                 ConstraintResult::leaf_field_failure(
-                  text::copy(std::to_string(index)),
+                  ConstraintResult::index_text(index),
                   "invalid value."
                   ));
           }
@@ -759,7 +927,7 @@ namespace garlic {
             return context.fail(
                 "Invalid value found in the tuple.",
                 ConstraintResult::field_failure(
-                  text::copy(std::to_string(index)),
+                  ConstraintResult::index_text(index),
                   std::move(result),
                   "invalid value."
                   ));
@@ -923,7 +1091,7 @@ namespace garlic {
         else
           return context.fail("Some of the constraints fail on this value.");
       }
-      sequence<ConstraintResult> results;
+      auto results = ConstraintResult::make_details();
       test_constraints(layer, context.constraints, std::back_inserter(results));
       if (results.empty())
         return context.ok();
@@ -941,6 +1109,8 @@ namespace garlic {
    *  @code{.cpp}
    *  make_constraint<string_literal_tag>("text");
    *  make_constraint<int_literal_tag>(12);
+   *  make_constraint<int64_literal_tag>(int64_t{1} << 40);
+   *  make_constraint<uint64_literal_tag>(UINT64_MAX);
    *  make_constraint<double_literal_tag>(10.5);
    *  make_constraint<bool_literal_tag>(false);
    *  make_constraint<null_literal_tag>();
@@ -991,7 +1161,13 @@ namespace garlic {
     template<typename ValueType, GARLIC_VIEW Layer>
     static inline enable_if_int<ValueType>
     validate(const Layer& layer, ValueType expectation) noexcept {
-      return layer.is_int() && expectation == layer.get_int();
+      if constexpr (std::is_unsigned_v<ValueType>) {
+        return garlic::is_uint64(layer) && expectation == garlic::get_uint64(layer);
+      } else if constexpr (sizeof(ValueType) > sizeof(int)) {
+        return garlic::is_int64(layer) && expectation == garlic::get_int64(layer);
+      } else {
+        return layer.is_int() && expectation == layer.get_int();
+      }
     }
 
     template<typename ValueType, GARLIC_VIEW Layer>
@@ -1009,7 +1185,8 @@ namespace garlic {
     template<typename ValueType, GARLIC_VIEW Layer>
     static inline enable_if_string<ValueType>
     validate(const Layer& layer, const ValueType& expectation) noexcept {
-      return layer.is_string() && !expectation.compare(layer.get_cstr());
+      // sizes are compared before any character, no strlen of the layer.
+      return layer.is_string() && layer.get_string_view() == std::string_view(expectation);
     }
     
     template<typename ValueType, GARLIC_VIEW Layer>
@@ -1039,10 +1216,150 @@ namespace garlic {
 
   using string_literal_tag = literal_tag<std::string>;
   using int_literal_tag    = literal_tag<int>;
+  using int64_literal_tag  = literal_tag<int64_t>;
+  using uint64_literal_tag = literal_tag<uint64_t>;
   using double_literal_tag = literal_tag<double>;
   using bool_literal_tag   = literal_tag<bool>;
   using null_literal_tag   = literal_tag<VoidType>;
 
+  /*! @brief Constraint Tag that passes if the layer is one of a set of values.
+   *  @note Accepts the same values as an any_tag over literals of strings, 64 bit integers,
+   *        doubles, booleans and null, with a single perfect hash lookup instead of one test per value.
+   *
+   *  @code{.cpp}
+   *  make_constraint<enum_tag>(std::vector<std::string>{"red", "green"}, std::vector<int64_t>{0, 1});
+   *  make_constraint<enum_tag>(enum_tag::values_type{.doubles = {0.5}, .null = true});
+   *  @endcode
+   */
+  struct enum_tag {
+    //! All the values of an enum, grouped by their type.
+    struct values_type {
+      std::vector<std::string> strings;
+      std::vector<int64_t> integers;
+      std::vector<uint64_t> large_integers;  //!< values past INT64_MAX, the rest are integers.
+      std::vector<double> doubles;
+      std::vector<bool> booleans;
+      bool null = false;
+    };
+
+    struct Context : public constraint_context {
+      //! bits of literals.
+      enum literal_flag : uint8_t {
+        null_value  = 0x1 << 0,
+        false_value = 0x1 << 1,
+        true_value  = 0x1 << 2,
+      };
+
+      template<typename... Args>
+      Context(
+          values_type&& values,
+          text&& name = "enum_constraint", Args&&... args
+          ) : constraint_context(std::move(name), std::forward<Args>(args)...) {
+        for (const auto& value : values.strings) this->strings.emplace(value, VoidType{});
+        for (auto value : values.integers) this->integers.emplace(Context::key(value), VoidType{});
+        for (auto value : values.large_integers) {
+          if (value > static_cast<uint64_t>(INT64_MAX))
+            this->large_integers.emplace(Context::key(value), VoidType{});
+          else
+            this->integers.emplace(Context::key(static_cast<int64_t>(value)), VoidType{});
+        }
+        for (auto value : values.doubles) this->doubles.emplace(Context::key(Context::normalize(value)), VoidType{});
+        for (bool value : values.booleans) literals |= value ? true_value : false_value;
+        if (values.null) literals |= null_value;
+        this->strings.build();
+        this->integers.build();
+        this->large_integers.build();
+        this->doubles.build();
+      }
+
+      template<typename... Args>
+      Context(
+          const std::vector<std::string>& strings, const std::vector<int64_t>& integers = {},
+          text&& name = "enum_constraint", Args&&... args
+          ) : Context(values_type{strings, integers}, std::move(name), std::forward<Args>(args)...) {}
+
+      //! @return the value of an entry of integers.
+      int64_t integer(size_t position) const noexcept { return Context::value<int64_t>(integers.key(position)); }
+
+      //! @return the value of an entry of large_integers.
+      uint64_t large_integer(size_t position) const noexcept {
+        return Context::value<uint64_t>(large_integers.key(position));
+      }
+
+      //! @return the value of an entry of doubles.
+      double real(size_t position) const noexcept { return Context::value<double>(doubles.key(position)); }
+
+      //! numbers are keyed by the bytes of their value.
+      template<typename T>
+      static inline std::string_view key(const T& value) noexcept {
+        return std::string_view{reinterpret_cast<const char*>(&value), sizeof(value)};
+      }
+
+      //! -0.0 and 0.0 compare equal but differ in their bytes.
+      static inline double normalize(double value) noexcept { return value == 0 ? 0.0 : value; }
+
+      perfect_map<VoidType> strings;
+      perfect_map<VoidType> integers;
+      perfect_map<VoidType> large_integers;
+      perfect_map<VoidType> doubles;
+      uint8_t literals = 0;
+
+    private:
+      template<typename T>
+      static inline T value(std::string_view key) noexcept {
+        T result;
+        std::memcpy(&result, key.data(), sizeof(result));
+        return result;
+      }
+    };
+
+    using context_type = Context;
+
+    template<GARLIC_VIEW Layer>
+    static inline ConstraintResult
+    test(const Layer& layer, const Context& context) noexcept {
+      if (enum_tag::contains(layer, context)) return context.ok();
+      return context.fail("invalid value.");
+    }
+
+    template<GARLIC_VIEW Layer>
+    static inline bool
+    quick_test(const Layer& layer, const Context& context) noexcept {
+      return enum_tag::contains(layer, context);
+    }
+
+    template<GARLIC_VIEW Layer>
+    static inline bool
+    contains(const Layer& layer, const Context& context) noexcept {
+      if (!context.strings.empty() && layer.is_string() && enum_tag::find(context.strings, layer.get_string_view()))
+        return true;
+      if (!context.integers.empty() && garlic::is_int64(layer)
+          && enum_tag::find(context.integers, Context::key(garlic::get_int64(layer))))
+        return true;
+      if (!context.large_integers.empty() && garlic::is_uint64(layer)) {
+        auto value = garlic::get_uint64(layer);
+        if (value > static_cast<uint64_t>(INT64_MAX) && enum_tag::find(context.large_integers, Context::key(value)))
+          return true;
+      }
+      if (!context.doubles.empty() && layer.is_double()
+          && enum_tag::find(context.doubles, Context::key(Context::normalize(layer.get_double()))))
+        return true;
+      if (!context.literals) return false;
+      if ((context.literals & Context::null_value) && layer.is_null()) return true;
+      return layer.is_bool() && (context.literals & (layer.get_bool() ? Context::true_value : Context::false_value));
+    }
+
+  private:
+    //! A handful of keys are compared one by one, that is cheaper than hashing the value.
+    static inline bool find(const perfect_map<VoidType>& keys, std::string_view value) noexcept {
+      if (keys.size() > 4) return keys.find_position(value) != perfect_map<VoidType>::npos;
+      for (size_t position = 0; position < keys.size(); ++position) {
+        if (keys.key(position) == value) return true;
+      }
+      return false;
+    }
+  };
+
   //! A named group of Constraint elements.
   class Field {
   public:
@@ -1135,22 +1452,80 @@ namespace garlic {
     //! test the layer with all the constraints in the field.
     template<GARLIC_VIEW Layer>
     ValidationResult validate(const Layer& layer) const noexcept {
-      ValidationResult result;
-      test_constraints(layer, properties_.constraints, std::back_inserter(result.failures));
-      return result;
+      return GARLIC_PROFILE(profiling::scope::field, this, properties_.name, this->validate_layer(layer));
+    }
+
+    //! Same as validate() but the result is made in the arena, it has to be gone before the arena is reset.
+    template<GARLIC_VIEW Layer>
+    ValidationResult validate(const Layer& layer, ArenaAllocator& arena) const noexcept {
+      internal::result_arena_scope scope(arena);
+      return this->validate(layer);
     }
 
     //! perform a quick and efficient test of all constraints in the field.
     template<GARLIC_VIEW Layer>
     bool quick_test(const Layer& layer) const noexcept {
-      return test_constraints_quick(layer, properties_.constraints);
+      return GARLIC_PROFILE(
+          profiling::scope::field, this, properties_.name, test_constraints_quick(layer, properties_.constraints));
     }
 
   protected:
     Properties properties_;
+
+  private:
+    template<GARLIC_VIEW Layer>
+    inline ValidationResult validate_layer(const Layer& layer) const noexcept {
+      ValidationResult result{ConstraintResult::make_details()};
+      test_constraints(layer, properties_.constraints, std::back_inserter(result.failures));
+      return result;
+    }
   };
 
 
+  namespace internal {
+    //! Set of matched field positions in a model, kept on the stack for most models.
+    class field_set {
+    public:
+      static constexpr size_t inline_words = 4;
+
+      explicit field_set(size_t count) : words_(inline_words_) {
+        if (count > inline_words * 64) {
+          heap_words_ = std::make_unique<uint64_t[]>((count + 63) / 64);
+          words_ = heap_words_.get();
+        }
+      }
+
+      inline void set(size_t position) noexcept {
+        words_[position / 64] |= uint64_t{1} << (position % 64);
+      }
+
+      //! @return whether or not every bit in the required mask is set.
+      inline bool covers(const std::vector<uint64_t>& required) const noexcept {
+        for (size_t i = 0; i < required.size(); ++i) {
+          if (required[i] & ~words_[i]) return false;
+        }
+        return true;
+      }
+
+      //! Calls the callable with the position of every required bit that is not set.
+      template<typename Callable>
+      inline void for_each_missing(const std::vector<uint64_t>& required, Callable&& cb) const {
+        for (size_t i = 0; i < required.size(); ++i) {
+          auto missing = (required[i] & words_[i]) ^ required[i];
+          while (missing) {
+            cb(i * 64 + std::countr_zero(missing));
+            missing &= missing - 1;
+          }
+        }
+      }
+
+    private:
+      uint64_t inline_words_[inline_words] = {};
+      std::unique_ptr<uint64_t[]> heap_words_;
+      uint64_t* words_;
+    };
+  }
+
   //! An object to describe a Model.
   /*! A model will contain a table basic_text -> {field: Field, required: bool}
    */
@@ -1195,8 +1570,49 @@ namespace garlic {
           std::move(name),
           FieldDescriptor { .field = std::move(field), .required = required }
           );
+      this->unfreeze();
+    }
+
+    //! Builds a perfect hash table over the field names to speed up validation.
+    /*! Models are meant to stay the same once loaded, so freezing a model replaces the
+     *  hash map lookup of every member with a single probe into a table that has no
+     *  collisions. Adding a field afterwards drops the table until the next freeze().
+     *  @note parsing::load_module() freezes every model it loads.
+     */
+    void freeze() {
+      field_table_.clear();
+      for (const auto& item : properties_.field_map) {
+        field_table_.emplace(std::string_view{item.first.data(), item.first.size()}, item.second);
+      }
+      field_table_.build();
+      required_fields_.assign((field_table_.size() + 63) / 64, 0);
+      for (size_t position = 0; position < field_table_.size(); ++position) {
+        if (field_table_.value(position).required) {
+          required_fields_[position / 64] |= uint64_t{1} << (position % 64);
+        }
+      }
+      frozen_ = true;
+    }
+
+    //! @return whether or not the model is frozen. See freeze()
+    bool frozen() const noexcept { return frozen_; }
+
+    static constexpr size_t npos = perfect_map<FieldDescriptor>::npos;
+
+    //! @return the dense index of the field for a member key, or npos if there is no such field.
+    /*! Indices go from zero to the number of fields and are only available once the model
+     *  is frozen, npos is returned for every key otherwise.
+     */
+    size_t field_index(std::string_view key) const noexcept {
+      return frozen_ ? field_table_.find_position(key) : npos;
     }
 
+    //! @return the name of the field at a dense index. See field_index()
+    std::string_view field_name(size_t index) const noexcept { return field_table_.key(index); }
+
+    //! @return the descriptor of the field at a dense index. See field_index()
+    const FieldDescriptor& field_descriptor(size_t index) const noexcept { return field_table_.value(index); }
+
     //! @return a shared pointer to the Field instance or nullptr if such key is not defined yet.
     template<typename KeyType>
     field_pointer get_field(KeyType&& name) const {
@@ -1229,15 +1645,67 @@ namespace garlic {
     //! Run a quick test on a layer.
     template<GARLIC_VIEW Layer>
     bool quick_test(const Layer& layer) const noexcept {
+      return GARLIC_PROFILE(profiling::scope::model, this, properties_.name, this->quick_test_layer(layer));
+    }
+
+    //! Validate a layer and return a detailed ConstraintResult.
+    template<GARLIC_VIEW Layer>
+    ConstraintResult validate(const Layer& layer) const noexcept {
+      return GARLIC_PROFILE(profiling::scope::model, this, properties_.name, this->validate_layer(layer));
+    }
+
+    //! Same as validate() but the whole result is made in the arena.
+    /*! Resetting the arena releases every failure at once, the result has to be gone by then.
+     *
+     *  @code
+     *  ArenaAllocator arena;
+     *  for (const auto& document : documents) {
+     *    {
+     *      auto result = model->validate(document, arena);
+     *      // report the result.
+     *    }
+     *    arena.reset();
+     *  }
+     *  @endcode
+     */
+    template<GARLIC_VIEW Layer>
+    ConstraintResult validate(const Layer& layer, ArenaAllocator& arena) const noexcept {
+      internal::result_arena_scope scope(arena);
+      return this->validate(layer);
+    }
+
+  protected:
+    Properties properties_;
+
+  private:
+    perfect_map<FieldDescriptor> field_table_;
+    std::vector<uint64_t> required_fields_;
+    bool frozen_ = false;
+
+    template<GARLIC_VIEW Layer>
+    inline bool quick_test_layer(const Layer& layer) const noexcept {
       if (!layer.is_object()) return false;
+      if (frozen_) {
+        internal::field_set matched(field_table_.size());
+        for (const auto& member : layer.get_object()) {
+          auto position = field_table_.find_position(member.key.get_string_view());
+          if (position == field_table_.npos) continue;
+          if (!field_table_.value(position).field->quick_test(member.value)) {
+            return false;
+          }
+          matched.set(position);
+        }
+        return matched.covers(required_fields_);
+      }
       std::unordered_set<text> requirements;
       for (const auto& member : layer.get_object()) {
-        auto it = properties_.field_map.find(member.key.get_cstr());
-        if (it == properties_.field_map.end()) continue;
-        if (!it->second.field->quick_test(member.value)) {
+        auto key = member.key.get_string_view();
+        auto descriptor = this->find_descriptor(key);
+        if (!descriptor) continue;
+        if (!descriptor->field->quick_test(member.value)) {
           return false;
         }
-        requirements.emplace(it->first);
+        requirements.emplace(key);
       }
       for (const auto& item : properties_.field_map) {
         if (auto it = requirements.find(item.first); it != requirements.end()) continue;
@@ -1247,27 +1715,14 @@ namespace garlic {
       return true;
     }
 
-    //! Validate a layer and return a detailed ConstraintResult.
     template<GARLIC_VIEW Layer>
-    ConstraintResult validate(const Layer& layer) const noexcept {
-      sequence<ConstraintResult> details;
+    inline ConstraintResult validate_layer(const Layer& layer) const noexcept {
+      auto details = ConstraintResult::make_details();
       if (layer.is_object()) {
-        // todo : if the container allows for atomic table look up, swap the loop.
-        std::unordered_set<text> requirements;
-        for (const auto& member : layer.get_object()) {
-          auto it = properties_.field_map.find(member.key.get_cstr());
-          if (it != properties_.field_map.end()) {
-            this->test_field(details, member.key, member.value, it->second.field);
-            requirements.emplace(it->first);
-          }
-        }
-        for (const auto& item : properties_.field_map) {
-          if (auto it = requirements.find(item.first); it != requirements.end()) continue;
-          if (!item.second.required) continue;
-          details.push_back(
-              ConstraintResult::leaf_field_failure(
-                item.first.view(),
-                "missing required field!"));
+        if (frozen_) {
+          this->validate_frozen_members(details, layer);
+        } else {
+          this->validate_members(details, layer);
         }
       } else {
         details.push_back(ConstraintResult::leaf_failure("type", "Expected object."));
@@ -1275,7 +1730,7 @@ namespace garlic {
       if (!details.empty()) {
         return ConstraintResult {
           .details = std::move(details),
-          .name = properties_.name.clone(),
+          .name = ConstraintResult::make_text(std::string_view{properties_.name.data(), properties_.name.size()}),
           .reason = text("This model is invalid!"),
           .flag = ConstraintResult::flags::none
         };
@@ -1284,10 +1739,57 @@ namespace garlic {
       return ConstraintResult::ok();
     }
 
-  protected:
-    Properties properties_;
+    inline void unfreeze() noexcept {
+      if (!frozen_) return;
+      field_table_.clear();
+      required_fields_.clear();
+      frozen_ = false;
+    }
+
+    template<GARLIC_VIEW Layer>
+    inline void validate_frozen_members(sequence<ConstraintResult>& details, const Layer& layer) const {
+      internal::field_set matched(field_table_.size());
+      for (const auto& member : layer.get_object()) {
+        auto position = field_table_.find_position(member.key.get_string_view());
+        if (position == field_table_.npos) continue;
+        this->test_field(details, member.key, member.value, field_table_.value(position).field);
+        matched.set(position);
+      }
+      matched.for_each_missing(required_fields_, [this, &details](size_t position) {
+          auto key = field_table_.key(position);
+          details.push_back(
+              ConstraintResult::leaf_field_failure(
+                text(key.data(), key.size()),
+                "missing required field!"));
+          });
+    }
+
+    template<GARLIC_VIEW Layer>
+    inline void validate_members(sequence<ConstraintResult>& details, const Layer& layer) const {
+      std::unordered_set<text> requirements;
+      for (const auto& member : layer.get_object()) {
+        auto key = member.key.get_string_view();
+        if (auto descriptor = this->find_descriptor(key); descriptor) {
+          this->test_field(details, member.key, member.value, descriptor->field);
+          requirements.emplace(key);
+        }
+      }
+      for (const auto& item : properties_.field_map) {
+        if (auto it = requirements.find(item.first); it != requirements.end()) continue;
+        if (!item.second.required) continue;
+        details.push_back(
+            ConstraintResult::leaf_field_failure(
+              item.first.view(),
+              "missing required field!"));
+      }
+    }
+
+    inline const FieldDescriptor* find_descriptor(std::string_view key) const noexcept {
+      if (frozen_) return field_table_.find(key);
+      auto it = properties_.field_map.find(text(key.data(), key.size()));
+      return it != properties_.field_map.end() ? &it->second : nullptr;
+    }
 
-  private:
     template<GARLIC_VIEW Layer>
     inline void
     test_field(
@@ -1451,7 +1953,8 @@ namespace garlic {
   //! Built-in constraint tags.
   using constraint_registry = internal::registry<
     type_tag, range_tag, regex_tag, any_tag, list_tag, tuple_tag, map_tag, all_tag, model_tag, field_tag,
-    string_literal_tag, int_literal_tag, double_literal_tag, bool_literal_tag, null_literal_tag>;
+    string_literal_tag, int_literal_tag, double_literal_tag, bool_literal_tag, null_literal_tag,
+    int64_literal_tag, uint64_literal_tag, enum_tag>;
 
   template<typename Tag, typename... Args>
    Constraint Constraint::make(Args&&... args) noexcept {
@@ -1462,18 +1965,26 @@ namespace garlic {
         std::make_shared<typename Tag::context_type>(std::forward<Args>(args)...));
   }
 
+  template<typename Tag>
+  inline bool
+  Constraint::is() const noexcept {
+    return index_ == constraint_registry::position_of<Tag>();
+  }
+
   template<GARLIC_VIEW Layer>
   inline ConstraintResult
   Constraint::test(const Layer& value) const noexcept {
     static constexpr auto handlers = constraint_registry::test_handlers<Layer>();
-    return handlers[index_](value, context_.get());
+    return GARLIC_PROFILE(
+        profiling::scope::constraint, context_.get(), context_->name, handlers[index_](value, context_.get()));
   }
 
   template<GARLIC_VIEW Layer>
   inline bool
   Constraint::quick_test(const Layer& value) const noexcept {
     static constexpr auto handlers = constraint_registry::quick_test_handlers<Layer>();
-    return handlers[index_](value, context_.get());
+    return GARLIC_PROFILE(
+        profiling::scope::constraint, context_.get(), context_->name, handlers[index_](value, context_.get()));
   }
 
   //! Create a generic Constraint based on a constraint tag.
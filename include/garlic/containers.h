@@ -15,7 +15,15 @@
  *  containers.
  */
 
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 #include "garlic.h"
+#include "allocators.h"
 
 namespace garlic {
 
@@ -80,7 +88,11 @@ namespace garlic {
         const Ch* data, SizeType size,
         text_type type = text_type::reference) : size_(size), type_(type) {
       if (type == text_type::copy && size_) {
-        data_ = strncpy((Ch*)malloc((size_ + 1) * sizeof(Ch)), data, size_ + 1);
+        // data may be a view into a longer string, it is not terminated at size.
+        auto copy = static_cast<Ch*>(malloc((size_ + 1) * sizeof(Ch)));
+        memcpy(copy, data, size_ * sizeof(Ch));
+        copy[size_] = Ch();
+        data_ = copy;
       }
       else
         data_ = data;
@@ -202,6 +214,9 @@ namespace garlic {
   //! A container to store a list of items, similar to std::vector but far more limited.
   /*! This container is mostly used in constrains and modules where only a small number
    *  of elements are stored so it is designed to work with small counts.
+   *
+   *  A sequence made with an ArenaAllocator takes its memory from the arena and never gives it
+   *  back, the items are still destroyed with the sequence.
    */
   template<typename ValueType, typename SizeType = unsigned>
   class sequence {
@@ -218,12 +233,19 @@ namespace garlic {
         items_ = reinterpret_cast<pointer>(std::malloc(capacity_ * sizeof(ValueType)));
     }
 
+    sequence(SizeType initial_capacity, ArenaAllocator& arena
+        ) : capacity_(initial_capacity), size_(0), arena_(&arena) {
+      if (capacity_)
+        items_ = reinterpret_cast<pointer>(arena.allocate(capacity_ * sizeof(ValueType)));
+    }
+
     sequence(std::initializer_list<value_type> list) : sequence(list.size()) {
       push_front(list.begin(), list.end());
     }
 
     sequence(const sequence&) = delete;
-    sequence(sequence&& old) : items_(old.items_), capacity_(old.capacity_), size_(old.size_) {
+    sequence(sequence&& old
+        ) : items_(old.items_), capacity_(old.capacity_), size_(old.size_), arena_(old.arena_) {
       old.capacity_ = 0;
     }
 
@@ -241,10 +263,7 @@ namespace garlic {
 
     void push_front(const_iterator begin, const_iterator end) noexcept {
       auto count = end - begin;
-      if (count > capacity_ - size_) {
-        capacity_ += count;
-        items_ = reinterpret_cast<pointer>(std::realloc(items_, capacity_ * sizeof(ValueType)));
-      }
+      if (count > capacity_ - size_) this->resize(capacity_ + count);
       if (size_)
         memmove(items_ + count, items_, count * sizeof(ValueType));
       for (auto i = 0; i < count; ++i) new (items_ + i) ValueType(begin[i]);
@@ -256,6 +275,7 @@ namespace garlic {
       size_ = old.size_;
       items_ = old.items_;
       capacity_ = old.capacity_;
+      arena_ = old.arena_;
       old.capacity_ = 0;
       return *this;
     };
@@ -284,6 +304,12 @@ namespace garlic {
     //! @return whether or not the sequence is empty.
     inline bool empty() const noexcept { return !size_; }
 
+    //! Destroys all the items but keeps the memory for the items to come.
+    inline void clear() noexcept {
+      for (auto it = items_; it < (items_ + size_); ++it) it->~ValueType();
+      size_ = 0;
+    }
+
     constexpr static inline sequence no_sequence() noexcept {
       return sequence(0);
     }
@@ -292,25 +318,220 @@ namespace garlic {
     pointer items_;
     SizeType capacity_;
     SizeType size_;
+    ArenaAllocator* arena_ = nullptr;
 
   private:
     inline void reserve_item() noexcept {
       if (capacity_ == 0) {
         capacity_ = 8;
-        items_ = reinterpret_cast<pointer>(std::malloc(capacity_ * sizeof(ValueType)));
+        items_ = reinterpret_cast<pointer>(
+            arena_ ? arena_->allocate(capacity_ * sizeof(ValueType)) : std::malloc(capacity_ * sizeof(ValueType)));
         return;
       }
-      if (size_ == capacity_) {
-        capacity_ += (capacity_ + 1) / 2;
-        items_ = reinterpret_cast<pointer>(std::realloc(items_, capacity_ * sizeof(ValueType)));
+      if (size_ == capacity_) this->resize(capacity_ + (capacity_ + 1) / 2);
+    }
+
+    inline void resize(SizeType capacity) noexcept {
+      if (arena_) {
+        auto size = capacity_ ? capacity_ * sizeof(ValueType) : 0;
+        items_ = reinterpret_cast<pointer>(
+            arena_->reallocate(size ? items_ : nullptr, size, capacity * sizeof(ValueType)));
+      } else {
+        items_ = reinterpret_cast<pointer>(std::realloc(capacity_ ? items_ : nullptr, capacity * sizeof(ValueType)));
       }
+      capacity_ = capacity;
     }
 
     inline void destroy() noexcept {
       if (capacity_) {
         for (auto it = items_; it < (items_ + size_); ++it) it->~ValueType();
-        free(items_);
+        if (!arena_) free(items_);
+      }
+    }
+  };
+
+  //! A read-only map from string keys to values where every key has a slot of its own.
+  /*! The map is filled with emplace() and then build() computes a minimal perfect hash over
+   *  the keys (hash and displace): keys are grouped in small buckets and every bucket gets
+   *  a displacement that sends its keys to free slots. A lookup is always one hash, two
+   *  table reads and a single key comparison regardless of the number of keys.
+   *
+   *  Entries keep the order they were added in, so find_position() gives every key a dense index.
+   *  Duplicate keys are dropped when building, keeping the first one.
+   *
+   *  @code
+   *  perfect_map<int> map;
+   *  map.emplace("first", 1);
+   *  map.emplace("second", 2);
+   *  map.build();
+   *  map.find("second");  // pointer to 2.
+   *  map.find("third");  // nullptr.
+   *  @endcode
+   */
+  template<typename ValueType>
+  class perfect_map {
+  public:
+    using value_type = ValueType;
+
+    //! Adds a new entry, build() has to be called before looking up keys.
+    void emplace(std::string_view key, ValueType value) {
+      entries_.push_back(entry{
+          static_cast<uint32_t>(keys_.size()), static_cast<uint32_t>(key.size()), std::move(value)});
+      keys_.append(key);
+      slots_.clear();
+    }
+
+    //! Computes the hash table for the current set of keys.
+    void build() {
+      this->remove_duplicates();
+      slots_.clear();
+      displacements_.clear();
+      if (entries_.empty()) return;
+
+      size_t slot_count = std::bit_ceil(entries_.size() + entries_.size() / 4 + 1);
+      size_t bucket_count = std::bit_ceil(entries_.size() / 4 + 1);
+      for (uint64_t seed = 1;; ++seed) {
+        if (this->try_build(seed, slot_count, bucket_count)) return;
+        if (seed % 8 == 0) slot_count *= 2;  // give up on a tight table after a few seeds.
+      }
+    }
+
+    static constexpr size_t npos = SIZE_MAX;
+
+    //! @return the position of the key in the order entries were added or npos if it is missing.
+    size_t find_position(std::string_view key) const noexcept {
+      if (slots_.empty()) return npos;
+      auto hash = hash_key(key, seed_);
+      auto index = slots_[slot_of(hash, displacements_[hash & (displacements_.size() - 1)])];
+      if (index == empty_slot) return npos;
+      const auto& item = entries_[index];
+      if (item.length != key.size() || std::memcmp(keys_.data() + item.offset, key.data(), key.size()))
+        return npos;
+      return index;
+    }
+
+    //! @return a pointer to the value of the key or nullptr if the key is not in the map.
+    const ValueType* find(std::string_view key) const noexcept {
+      auto position = this->find_position(key);
+      return position == npos ? nullptr : &entries_[position].value;
+    }
+
+    std::string_view key(size_t position) const noexcept {
+      return std::string_view{keys_.data() + entries_[position].offset, entries_[position].length};
+    }
+    const ValueType& value(size_t position) const noexcept { return entries_[position].value; }
+
+    size_t size() const noexcept { return entries_.size(); }
+    bool empty() const noexcept { return entries_.empty(); }
+
+    void clear() noexcept {
+      entries_.clear();
+      keys_.clear();
+      slots_.clear();
+      displacements_.clear();
+    }
+
+  private:
+    struct entry {
+      uint32_t offset;
+      uint32_t length;
+      ValueType value;
+    };
+
+    static constexpr uint32_t empty_slot = UINT32_MAX;
+
+    std::vector<entry> entries_;
+    std::string keys_;
+    std::vector<uint32_t> slots_;
+    std::vector<uint32_t> displacements_;
+    uint64_t seed_ = 0;
+
+    static inline uint64_t mix(uint64_t value) noexcept {
+      value ^= value >> 32;
+      value *= 0xd6e8feb86659fd93ull;
+      value ^= value >> 32;
+      return value;
+    }
+
+    static inline uint64_t hash_key(std::string_view key, uint64_t seed) noexcept {
+      uint64_t hash = seed ^ (key.size() * 0x9e3779b97f4a7c15ull);
+      auto data = key.data();
+      auto size = key.size();
+      for (; size >= 8; data += 8, size -= 8) {
+        uint64_t word;
+        std::memcpy(&word, data, 8);
+        hash = mix(hash ^ word) * 0x9e3779b97f4a7c15ull;
+      }
+      uint64_t tail = 0;
+      std::memcpy(&tail, data, size);
+      return mix(mix(hash ^ tail) * 0x9e3779b97f4a7c15ull);
+    }
+
+    inline size_t slot_of(uint64_t hash, uint64_t displacement) const noexcept {
+      auto step = ((hash * 0x9e3779b97f4a7c15ull) >> 32) | 1;
+      return ((hash >> 32) + displacement * step) & (slots_.size() - 1);
+    }
+
+    void remove_duplicates() {
+      std::unordered_set<std::string_view> seen;
+      for (size_t index = 0; index < entries_.size(); ++index) seen.emplace(this->key(index));
+      if (seen.size() == entries_.size()) return;
+
+      seen.clear();
+      std::vector<entry> unique;
+      std::string keys;
+      for (auto& item : entries_) {
+        auto key = std::string_view{keys_.data() + item.offset, item.length};
+        if (!seen.emplace(key).second) continue;
+        unique.push_back(entry{static_cast<uint32_t>(keys.size()), item.length, std::move(item.value)});
+        keys.append(key);
+      }
+      entries_ = std::move(unique);
+      keys_ = std::move(keys);
+    }
+
+    bool try_build(uint64_t seed, size_t slot_count, size_t bucket_count) {
+      seed_ = seed;
+      slots_.assign(slot_count, empty_slot);
+      displacements_.assign(bucket_count, 0);
+
+      std::vector<uint64_t> hashes(entries_.size());
+      std::vector<std::vector<uint32_t>> buckets(bucket_count);
+      for (uint32_t index = 0; index < entries_.size(); ++index) {
+        hashes[index] = hash_key(this->key(index), seed);
+        buckets[hashes[index] & (bucket_count - 1)].push_back(index);
+      }
+
+      // place the largest buckets first while the table still has plenty of room.
+      std::vector<uint32_t> order(bucket_count);
+      for (uint32_t index = 0; index < bucket_count; ++index) order[index] = index;
+      std::stable_sort(order.begin(), order.end(), [&buckets](auto a, auto b) {
+          return buckets[a].size() > buckets[b].size();
+      });
+
+      std::vector<size_t> placed;
+      for (auto bucket : order) {
+        if (buckets[bucket].empty()) break;
+        bool done = false;
+        for (uint32_t displacement = 0; !done && displacement < (1u << 16); ++displacement) {
+          placed.clear();
+          done = true;
+          for (auto index : buckets[bucket]) {
+            auto slot = slot_of(hashes[index], displacement);
+            if (slots_[slot] != empty_slot || std::find(placed.begin(), placed.end(), slot) != placed.end()) {
+              done = false;
+              break;
+            }
+            placed.push_back(slot);
+          }
+          if (done) {
+            displacements_[bucket] = displacement;
+            for (size_t i = 0; i < placed.size(); ++i) slots_[placed[i]] = buckets[bucket][i];
+          }
+        }
+        if (!done) return false;
       }
+      return true;
     }
   };
 
@@ -32,6 +32,44 @@ namespace garlic {
     }
   };
 
+  template<>
+  struct coder<int64_t> {
+
+    template<GARLIC_VIEW Layer>
+    static inline int64_t
+    decode(Layer&& layer) { return garlic::get_int64(layer); }
+
+    template<GARLIC_REF Layer>
+    static inline void
+    encode(Layer&& layer, int64_t value) { garlic::set_int64(layer, value); }
+
+    template<GARLIC_VIEW Layer, typename Callable>
+    static inline void
+    safe_decode(Layer&& layer, Callable&& cb) {
+      if (garlic::is_int64(layer))
+        cb(garlic::get_int64(layer));
+    }
+  };
+
+  template<>
+  struct coder<uint64_t> {
+
+    template<GARLIC_VIEW Layer>
+    static inline uint64_t
+    decode(Layer&& layer) { return garlic::get_uint64(layer); }
+
+    template<GARLIC_REF Layer>
+    static inline void
+    encode(Layer&& layer, uint64_t value) { garlic::set_uint64(layer, value); }
+
+    template<GARLIC_VIEW Layer, typename Callable>
+    static inline void
+    safe_decode(Layer&& layer, Callable&& cb) {
+      if (garlic::is_uint64(layer))
+        cb(garlic::get_uint64(layer));
+    }
+  };
+
   template<>
   struct coder<bool> {
 
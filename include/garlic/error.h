@@ -12,6 +12,7 @@ namespace garlic {
     Redefinition = 1,
     UndefinedObject = 2,
     InvalidModule = 3,
+    InvalidCompiledModule = 4,
   };
 
   namespace error {
@@ -27,6 +28,8 @@ namespace garlic {
               return "Use of an undefined/unresolved object.";
             case GarlicError::InvalidModule:
               return "Module description is invalid and could not be used to create a Module.";
+            case GarlicError::InvalidCompiledModule:
+              return "Compiled module image is corrupt or was made by an incompatible version.";
             default:
               return "unknown";
           }
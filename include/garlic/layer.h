@@ -6,6 +6,8 @@
  *         make it easier to produce iterators for the container wrappers (providers).
  */
 
+#include <cstdint>
+
 #include "garlic.h"
 #include "containers.h"
 
@@ -21,7 +23,7 @@
 
 namespace garlic {
 
-  enum TypeFlag : uint8_t {
+  enum TypeFlag : uint16_t {
     Null    = 0x1 << 1,
     Boolean = 0x1 << 2,
     String  = 0x1 << 3,
@@ -29,6 +31,8 @@ namespace garlic {
     Double  = 0x1 << 5,
     Object  = 0x1 << 6,
     List    = 0x1 << 7,
+    Int64   = 0x1 << 8,  //!< an integer that fits in 64 bits, ints included.
+    UInt64  = 0x1 << 9,  //!< a non-negative integer that fits in 64 bits unsigned.
   };
 
   template<typename T> using ConstValueIteratorOf = typename std::decay_t<T>::ConstValueIterator;
@@ -74,6 +78,15 @@ namespace garlic {
    *    ConstMemberRange get_object() const;  // must return any object that has begin() and end()
    *
    *    T get_view() const;  // must return a garlic::ViewLayer of the current layer without copying its content.
+   *
+   *    // optional, for integers that do not fit in an int. see garlic::is_int64() and the rest.
+   *    bool is_int64() const;  // true for every int as well.
+   *    bool is_uint64() const;  // true for every non-negative int64 as well.
+   *    int64_t get_int64() const;
+   *    uint64_t get_uint64() const;
+   *
+   *    // optional, every TypeFlag the layer passes an is_*() method for in a single call.
+   *    TypeFlag get_type() const;
    *  }
    *  @endcode
    */
@@ -139,6 +152,10 @@ namespace garlic {
    *    void erase_member(MemberIterator);
    *
    *    T get_reference();  // must return a RefLayer of the current layer without copying its content.
+   *
+   *    // optional, for integers that do not fit in an int. see garlic::set_int64().
+   *    void set_int64(int64_t);
+   *    void set_uint64(uint64_t);
    *  }
    *  @endcode
    */
@@ -285,6 +302,156 @@ namespace garlic {
   };
 #endif
 
+  namespace internal {
+    template<typename, class = void>
+    static constexpr bool has_int64_methods = false;
+
+    template<typename Layer>
+    static constexpr bool has_int64_methods<Layer, std::void_t<
+      decltype(std::declval<const std::decay_t<Layer>&>().is_int64()),
+      decltype(std::declval<const std::decay_t<Layer>&>().is_uint64()),
+      decltype(std::declval<const std::decay_t<Layer>&>().get_int64()),
+      decltype(std::declval<const std::decay_t<Layer>&>().get_uint64())>> = true;
+
+    template<typename, class = void>
+    static constexpr bool has_set_int64_methods = false;
+
+    template<typename Layer>
+    static constexpr bool has_set_int64_methods<Layer, std::void_t<
+      decltype(std::declval<std::decay_t<Layer>&>().set_int64(int64_t{})),
+      decltype(std::declval<std::decay_t<Layer>&>().set_uint64(uint64_t{}))>> = true;
+
+    template<typename, class = void>
+    static constexpr bool has_get_type_method = false;
+
+    template<typename Layer>
+    static constexpr bool has_get_type_method<Layer, std::void_t<
+      decltype(std::declval<const std::decay_t<Layer>&>().get_type())>> = true;
+  }
+
+  //! @return whether or not the layer is an integer that fits in 64 bits, every int is one.
+  /*! @note Layers without the optional is_int64() and get_int64() methods only hold ints. */
+  template<GARLIC_VIEW Layer>
+  static inline bool is_int64(const Layer& layer) noexcept {
+    if constexpr (internal::has_int64_methods<Layer>) return layer.is_int64();
+    else return layer.is_int();
+  }
+
+  //! @return whether or not the layer is a non-negative integer that fits in 64 bits unsigned.
+  template<GARLIC_VIEW Layer>
+  static inline bool is_uint64(const Layer& layer) noexcept {
+    if constexpr (internal::has_int64_methods<Layer>) return layer.is_uint64();
+    else return layer.is_int() && layer.get_int() >= 0;
+  }
+
+  //! @return the value of a layer that passes is_int64().
+  template<GARLIC_VIEW Layer>
+  static inline int64_t get_int64(const Layer& layer) noexcept {
+    if constexpr (internal::has_int64_methods<Layer>) return layer.get_int64();
+    else return layer.get_int();
+  }
+
+  //! @return the value of a layer that passes is_uint64().
+  template<GARLIC_VIEW Layer>
+  static inline uint64_t get_uint64(const Layer& layer) noexcept {
+    if constexpr (internal::has_int64_methods<Layer>) return layer.get_uint64();
+    else return static_cast<uint64_t>(layer.get_int());
+  }
+
+  //! Stores the value as an int whenever it fits.
+  /*! @note Layers without the optional set_int64() method get a double for larger values. */
+  template<GARLIC_REF Layer>
+  static inline void set_int64(Layer&& layer, int64_t value) {
+    if (value >= INT32_MIN && value <= INT32_MAX) layer.set_int(static_cast<int>(value));
+    else if constexpr (internal::has_set_int64_methods<Layer>) layer.set_int64(value);
+    else layer.set_double(static_cast<double>(value));
+  }
+
+  //! @copydoc set_int64()
+  template<GARLIC_REF Layer>
+  static inline void set_uint64(Layer&& layer, uint64_t value) {
+    if (value <= INT32_MAX) layer.set_int(static_cast<int>(value));
+    else if constexpr (internal::has_set_int64_methods<Layer>) layer.set_uint64(value);
+    else layer.set_double(static_cast<double>(value));
+  }
+
+  //! @return every TypeFlag the layer passes an is_*() method for, e.g. Integer | Double | String for some scalars.
+  /*! @note Layers without the optional get_type() method have every predicate called once. */
+  template<GARLIC_VIEW Layer>
+  static inline TypeFlag get_type(const Layer& layer) noexcept {
+    if constexpr (internal::has_get_type_method<Layer>) {
+      return layer.get_type();
+    } else {
+      uint16_t flag = 0;
+      if (layer.is_null()) flag |= TypeFlag::Null;
+      if (layer.is_bool()) flag |= TypeFlag::Boolean;
+      if (layer.is_string()) flag |= TypeFlag::String;
+      if (layer.is_int()) flag |= TypeFlag::Integer;
+      if (layer.is_double()) flag |= TypeFlag::Double;
+      if (layer.is_object()) flag |= TypeFlag::Object;
+      if (layer.is_list()) flag |= TypeFlag::List;
+      if (garlic::is_int64(layer)) flag |= TypeFlag::Int64;
+      if (garlic::is_uint64(layer)) flag |= TypeFlag::UInt64;
+      return static_cast<TypeFlag>(flag);
+    }
+  }
+
+  namespace internal {
+    //! Answers the is_*() questions of a layer, with one get_type() call when the layer has it.
+    /*! Without get_type() every question goes to the layer, so a chain of them still stops at
+     *  the first match instead of asking all of them up front.
+     */
+    template<GARLIC_VIEW Layer, bool = has_get_type_method<Layer>>
+    class type_probe {
+    public:
+      explicit type_probe(const Layer& layer) noexcept : layer_(layer) {}
+
+      inline bool is_null() const noexcept { return layer_.is_null(); }
+      inline bool is_bool() const noexcept { return layer_.is_bool(); }
+      inline bool is_string() const noexcept { return layer_.is_string(); }
+      inline bool is_int() const noexcept { return layer_.is_int(); }
+      inline bool is_double() const noexcept { return layer_.is_double(); }
+      inline bool is_object() const noexcept { return layer_.is_object(); }
+      inline bool is_list() const noexcept { return layer_.is_list(); }
+      inline bool is_int64() const noexcept { return garlic::is_int64(layer_); }
+      inline bool is_uint64() const noexcept { return garlic::is_uint64(layer_); }
+
+    private:
+      const Layer& layer_;
+    };
+
+    /*! The kind of node is cheap to ask any layer, so strings, lists and objects still go to the
+     *  layer. Only the first question that needs the scalar classified calls get_type().
+     */
+    template<GARLIC_VIEW Layer>
+    class type_probe<Layer, true> {
+    public:
+      explicit type_probe(const Layer& layer) noexcept : layer_(layer) {}
+
+      inline bool is_string() const noexcept { return layer_.is_string(); }
+      inline bool is_object() const noexcept { return layer_.is_object(); }
+      inline bool is_list() const noexcept { return layer_.is_list(); }
+      inline bool is_null() const noexcept { return this->type() & TypeFlag::Null; }
+      inline bool is_bool() const noexcept { return this->type() & TypeFlag::Boolean; }
+      inline bool is_int() const noexcept { return this->type() & TypeFlag::Integer; }
+      inline bool is_double() const noexcept { return this->type() & TypeFlag::Double; }
+      inline bool is_int64() const noexcept { return this->type() & TypeFlag::Int64; }
+      inline bool is_uint64() const noexcept { return this->type() & TypeFlag::UInt64; }
+
+    private:
+      const Layer& layer_;
+      mutable uint16_t type_ = 0;  // every layer has at least one type, zero is not asked yet.
+
+      inline uint16_t type() const noexcept {
+        if (!type_) type_ = layer_.get_type();
+        return type_;
+      }
+    };
+
+    template<GARLIC_VIEW Layer>
+    static inline type_probe<Layer> probe_type(const Layer& layer) noexcept { return type_probe<Layer>(layer); }
+  }
+
   /*! @brief A trivial and basic iterator wrapper that conforms to the **IteratorWrapper** concept.
    *
    * The result of the *wrap()* method will be **ValueType { *iterator };**
@@ -52,12 +52,14 @@ namespace garlic {
     constexpr static auto kDefaultFieldTableSize = 16;
 
     /*! Creates an empty module with the following fields already available:
-     *  **string**, **bool**, **list**, **object**, **integer**, **double**
+     *  **string**, **bool**, **list**, **object**, **integer**, **int64**, **uint64**, **double**
      */
     Module() : fields_(kDefaultFieldTableSize) {
       static table<text, field_pointer> static_map = {
         {"string", this->make_field<type_tag>("StringField", TypeFlag::String)},
         {"integer", this->make_field<type_tag>("IntegerField", TypeFlag::Integer)},
+        {"int64", this->make_field<type_tag>("Int64Field", TypeFlag::Int64)},
+        {"uint64", this->make_field<type_tag>("UInt64Field", TypeFlag::UInt64)},
         {"double", this->make_field<type_tag>("DoubleField", TypeFlag::Double)},
         {"list", this->make_field<type_tag>("ListField", TypeFlag::List)},
         {"object", this->make_field<type_tag>("ObjectField", TypeFlag::Object)},
@@ -151,6 +153,11 @@ namespace garlic {
     //! @return a read-only (const) iterator that points to found element or **end_fields()** if not found.
     inline const_field_iterator find_field(const text& name) const { return fields_.find(name); }
 
+    //! Freezes every model in the module, see Model::freeze()
+    void freeze() {
+      for (auto& item : models_) item.second->freeze();
+    }
+
   private:
     template<typename ConstraintTag, typename... Args>
     static inline field_pointer make_field(text&& name, Args&&... args) noexcept {
@@ -0,0 +1,212 @@
+#ifndef GARLIC_PARALLEL_H
+#define GARLIC_PARALLEL_H
+
+/*! @file parallel.h
+ *  @brief A small thread pool to split the validation of large layers across cores.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "garlic.h"
+
+namespace garlic {
+
+  //! A fixed set of worker threads that run the parts of a job together with the calling thread.
+  /*! Every job starts with its parts split into one contiguous range per thread. A thread runs
+   *  the parts of its own range in order and once it is done, it steals the upper half of the
+   *  range of another thread, so jobs with parts of very different costs keep every thread busy
+   *  until the end. The calling thread of run() takes part in its own job, which means jobs can
+   *  be started from within other jobs without running out of threads, a nested job simply runs
+   *  on fewer of them.
+   *
+   *  @code
+   *  ThreadPool pool(4);
+   *  std::vector<int> values(1000);
+   *  pool.run(values.size(), [&values](size_t index) { values[index] = index * index; });
+   *  @endcode
+   */
+  class ThreadPool {
+  public:
+    //! Starts the workers, the calling thread of run() makes up for the last one.
+    explicit ThreadPool(unsigned concurrency = std::thread::hardware_concurrency()) {
+      for (unsigned index = 1; index < concurrency; ++index) {
+        workers_.emplace_back([this]() { this->work(); });
+      }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+      }
+      wake_.notify_all();
+      for (auto& worker : workers_) worker.join();
+    }
+
+    //! @return the number of threads a job can run on, the calling thread included.
+    size_t concurrency() const noexcept { return workers_.size() + 1; }
+
+    //! A pool with a thread for every core, made the first time it is asked for.
+    static ThreadPool& shared() {
+      static ThreadPool pool;
+      return pool;
+    }
+
+    //! Runs the task for every part from 0 to count and waits for all of them to finish.
+    /*! @note The task must not throw, it runs on the workers as well as the calling thread.
+     *  @note Jobs are limited to 2^32 parts.
+     */
+    template<typename Task>
+    void run(size_t count, Task&& task) {
+      if (count == 0) return;
+      if (workers_.empty() || count == 1) {
+        for (size_t part = 0; part < count; ++part) task(part);
+        return;
+      }
+      auto item = std::make_shared<job>(count, std::min(count, this->concurrency()));
+      item->task = [&task](size_t part) { task(part); };
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(item);
+      }
+      wake_.notify_all();
+      auto parts = item->work();
+      std::unique_lock<std::mutex> lock(mutex_);
+      item->finished += parts;
+      done_.wait(lock, [&item]() { return item->finished == item->count; });
+    }
+
+    //! @return the lowest index from 0 to count the predicate does not pass, count if it passes them all.
+    /*! The indices are run in chunks of grain. A chunk stops at its first failure and the chunks
+     *  past the lowest failure found so far are skipped, so the result is the same as the one of
+     *  a serial scan and little work is done after a failure.
+     */
+    template<typename Predicate>
+    size_t find_first_failure(size_t count, size_t grain, Predicate&& passes) {
+      std::atomic<size_t> first = count;
+      this->run((count + grain - 1) / grain, [count, grain, &first, &passes](size_t chunk) {
+          auto end = std::min(count, (chunk + 1) * grain);
+          for (auto index = chunk * grain; index < end && index < first.load(std::memory_order_relaxed); ++index) {
+            if (passes(index)) continue;
+            auto current = first.load();
+            while (index < current && !first.compare_exchange_weak(current, index));
+            return;
+          }
+          });
+      return first.load();
+    }
+
+  private:
+    //! Parts of a job, split in a range per thread.
+    /*! A range is a single atomic word with its first part in the low half and one past its last
+     *  part in the high half, the owner takes parts from the front and thieves cut off the back.
+     */
+    struct job {
+      size_t count;
+      size_t slots;
+      std::function<void(size_t)> task;
+      std::unique_ptr<std::atomic<uint64_t>[]> ranges;
+      std::atomic<size_t> joined = 0;
+      size_t finished = 0;  // guarded by the mutex of the pool.
+
+      job(size_t count, size_t slots
+          ) : count(count), slots(slots), ranges(std::make_unique<std::atomic<uint64_t>[]>(slots)) {
+        for (size_t slot = 0; slot < slots; ++slot) {
+          ranges[slot].store(pack(count * slot / slots, count * (slot + 1) / slots));
+        }
+      }
+
+      //! @return whether or not every part is taken, the threads running them finish the job.
+      bool taken() const noexcept {
+        if (joined.load() >= slots) return true;
+        for (size_t slot = 0; slot < slots; ++slot) {
+          auto range = ranges[slot].load();
+          if (first(range) < last(range)) return false;
+        }
+        return true;
+      }
+
+      //! Runs parts until there is none left to take or steal. @return the number of parts run.
+      size_t work() {
+        auto slot = joined++;
+        if (slot >= slots) return 0;
+        size_t parts = 0;
+        do {
+          for (size_t part; this->take(slot, part); ++parts) task(part);
+        } while (this->steal(slot));
+        return parts;
+      }
+
+    private:
+      static inline uint64_t pack(uint64_t first, uint64_t last) noexcept { return first | last << 32; }
+      static inline size_t first(uint64_t range) noexcept { return range & UINT32_MAX; }
+      static inline size_t last(uint64_t range) noexcept { return range >> 32; }
+
+      bool take(size_t slot, size_t& part) noexcept {
+        auto range = ranges[slot].load();
+        while (first(range) < last(range)) {
+          if (ranges[slot].compare_exchange_weak(range, pack(first(range) + 1, last(range)))) {
+            part = first(range);
+            return true;
+          }
+        }
+        return false;
+      }
+
+      //! Moves the upper half of the range of another thread to this one. @return false if all are empty.
+      bool steal(size_t slot) noexcept {
+        for (size_t offset = 1; offset < slots; ++offset) {
+          auto& victim = ranges[(slot + offset) % slots];
+          auto range = victim.load();
+          while (first(range) < last(range)) {
+            auto middle = first(range) + (last(range) - first(range)) / 2;
+            if (victim.compare_exchange_weak(range, pack(first(range), middle))) {
+              // nobody touches an empty range, it is safe to refill it.
+              ranges[slot].store(pack(middle, last(range)));
+              return true;
+            }
+          }
+        }
+        return false;
+      }
+    };
+
+    std::vector<std::thread> workers_;
+    std::deque<std::shared_ptr<job>> jobs_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    bool stopping_ = false;
+
+    void work() {
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (true) {
+        wake_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+        if (stopping_) return;
+        auto item = jobs_.front();
+        if (item->taken()) {
+          jobs_.pop_front();
+          continue;
+        }
+        lock.unlock();
+        auto parts = item->work();
+        lock.lock();
+        if (parts && (item->finished += parts) == item->count) done_.notify_all();
+      }
+    }
+  };
+
+}
+
+#endif /* end of include guard: GARLIC_PARALLEL_H */
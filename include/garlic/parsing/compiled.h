@@ -0,0 +1,785 @@
+#ifndef GARLIC_PARSING_COMPILED
+#define GARLIC_PARSING_COMPILED
+
+/*! @file parsing/compiled.h
+ *  @brief Dumping and loading Module instances as precompiled binary images.
+ *
+ *  A compiled image holds a fully resolved module: every constraint, field and model with
+ *  all the references between them. Loading one skips the module description entirely,
+ *  there is nothing left to parse or resolve, only records to turn back into objects.
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define GARLIC_COMPILED_USE_MMAP
+#endif
+
+#include "../module.h"
+#include "../error.h"
+
+namespace garlic::parsing {
+
+  namespace compiled {
+
+    //! Bumped every time the layout of the image changes.
+    static constexpr uint32_t version = 5;
+
+    static constexpr char magic[8] = {'G', 'A', 'R', 'L', 'I', 'C', 'M', 'C'};
+
+    //! Written as is, reads back differently on a machine with another byte order.
+    static constexpr uint32_t byte_order_mark = 0x01020304;
+
+    static constexpr uint32_t none = UINT32_MAX;
+
+    //! Stable codes of the constraint tags, independent of their position in constraint_registry.
+    enum class tag_code : uint16_t {
+      type = 1,
+      range = 2,
+      regex = 3,
+      any = 4,
+      list = 5,
+      tuple = 6,
+      map = 7,
+      all = 8,
+      model = 9,
+      field = 10,
+      string_literal = 11,
+      int_literal = 12,
+      double_literal = 13,
+      bool_literal = 14,
+      null_literal = 15,
+      int64_literal = 16,
+      uint64_literal = 17,
+      enum_set = 18,
+    };
+
+    //! A range of items in one of the tables of the image.
+    struct span {
+      uint32_t offset;
+      uint32_t count;
+    };
+
+    //! Every other offset in the image is relative to the beginning of the header.
+    struct header {
+      char magic[8];
+      uint32_t version;
+      uint32_t byte_order;
+      uint64_t size;  // size of the whole image.
+      span strings;  // string records.
+      span characters;  // NUL terminated string data.
+      span operands;  // uint32_t operands of the records.
+      span constraints;
+      span fields;
+      span models;
+      span module_fields;  // pairs of alias and field.
+      span module_models;  // model ids.
+    };
+
+    struct string_record {
+      uint32_t offset;  // into characters.
+      uint32_t length;
+    };
+
+    //! Operands depend on the tag and are documented in writer::add_constraint().
+    struct constraint_record {
+      uint16_t tag;
+      uint8_t fatal;
+      uint8_t reserved;
+      uint32_t name;
+      uint32_t message;
+      span operands;
+    };
+
+    struct field_record {
+      uint32_t name;
+      uint32_t ignore_details;
+      span annotations;  // pairs of strings in operands.
+      span constraints;  // constraint ids in operands.
+    };
+
+    struct model_record {
+      uint32_t name;
+      uint32_t strict;
+      span annotations;  // pairs of strings in operands.
+      span fields;  // triples of key, field id and required in operands.
+    };
+
+    static inline constexpr uint32_t align(uint32_t value) noexcept { return (value + 7) & ~uint32_t{7}; }
+
+    //! Flattens a module into the tables of an image.
+    class writer {
+    public:
+      explicit writer(const Module& module) {
+        this->add_string(std::string_view{});  // string zero is always the empty string.
+        for (auto it = module.begin_models(); it != module.end_models(); ++it) {
+          module_models_.push_back(this->add_model(it->second));
+        }
+        for (auto it = module.begin_fields(); it != module.end_fields(); ++it) {
+          module_fields_.push_back(this->add_string(it->first));
+          module_fields_.push_back(this->add_field(it->second));
+        }
+      }
+
+      //! @return GarlicError::UndefinedObject if the module refers to a field that was never resolved.
+      std::error_code error() const noexcept { return error_; }
+
+      std::string image() const {
+        header head;
+        std::memcpy(head.magic, magic, sizeof(magic));
+        head.version = version;
+        head.byte_order = byte_order_mark;
+
+        std::string result;
+        uint32_t position = align(sizeof(header));
+        auto place = [&position](span& target, size_t count, size_t item_size) {
+          target = span{position, static_cast<uint32_t>(count)};
+          position = align(position + static_cast<uint32_t>(count * item_size));
+        };
+        place(head.strings, strings_.size(), sizeof(string_record));
+        place(head.characters, characters_.size(), 1);
+        place(head.operands, operands_.size(), sizeof(uint32_t));
+        place(head.constraints, constraints_.size(), sizeof(constraint_record));
+        place(head.fields, fields_.size(), sizeof(field_record));
+        place(head.models, models_.size(), sizeof(model_record));
+        place(head.module_fields, module_fields_.size() / 2, 2 * sizeof(uint32_t));
+        place(head.module_models, module_models_.size(), sizeof(uint32_t));
+        head.size = position;
+
+        result.resize(position, '\0');
+        auto write = [&result](const span& target, const void* data, size_t size) {
+          if (size) std::memcpy(result.data() + target.offset, data, size);
+        };
+        write(span{0, 1}, &head, sizeof(header));
+        write(head.strings, strings_.data(), strings_.size() * sizeof(string_record));
+        write(head.characters, characters_.data(), characters_.size());
+        write(head.operands, operands_.data(), operands_.size() * sizeof(uint32_t));
+        write(head.constraints, constraints_.data(), constraints_.size() * sizeof(constraint_record));
+        write(head.fields, fields_.data(), fields_.size() * sizeof(field_record));
+        write(head.models, models_.data(), models_.size() * sizeof(model_record));
+        write(head.module_fields, module_fields_.data(), module_fields_.size() * sizeof(uint32_t));
+        write(head.module_models, module_models_.data(), module_models_.size() * sizeof(uint32_t));
+        return result;
+      }
+
+    private:
+      std::vector<string_record> strings_;
+      std::string characters_;
+      std::vector<uint32_t> operands_;
+      std::vector<constraint_record> constraints_;
+      std::vector<field_record> fields_;
+      std::vector<model_record> models_;
+      std::vector<uint32_t> module_fields_;
+      std::vector<uint32_t> module_models_;
+      std::error_code error_;
+
+      std::unordered_map<std::string, uint32_t> string_ids_;
+      std::unordered_map<const constraint_context*, uint32_t> constraint_ids_;
+      std::unordered_map<const Field*, uint32_t> field_ids_;
+      std::unordered_map<const Model*, uint32_t> model_ids_;
+
+      uint32_t add_string(std::string_view value) {
+        auto [it, inserted] = string_ids_.emplace(value, strings_.size());
+        if (inserted) {
+          strings_.push_back(string_record{
+              static_cast<uint32_t>(characters_.size()), static_cast<uint32_t>(value.size())});
+          characters_.append(value);
+          characters_.push_back('\0');
+        }
+        return it->second;
+      }
+
+      inline uint32_t add_string(const text& value) {
+        return this->add_string(std::string_view{value.data(), value.size()});
+      }
+
+      span add_annotations(const std::unordered_map<text, text>& annotations) {
+        std::vector<uint32_t> items;
+        for (const auto& item : annotations) {
+          items.push_back(this->add_string(item.first));
+          items.push_back(this->add_string(item.second));
+        }
+        return this->add_operands(items);
+      }
+
+      span add_operands(const std::vector<uint32_t>& items) {
+        span result{static_cast<uint32_t>(operands_.size()), static_cast<uint32_t>(items.size())};
+        operands_.insert(operands_.end(), items.begin(), items.end());
+        return result;
+      }
+
+      // Fields and models get their id before anything they refer to, so cycles end on the id.
+      uint32_t add_field(const std::shared_ptr<Field>& field) {
+        if (!field) return this->undefined();
+        if (auto it = field_ids_.find(field.get()); it != field_ids_.end()) return it->second;
+        uint32_t id = fields_.size();
+        field_ids_.emplace(field.get(), id);
+        fields_.emplace_back();
+
+        const auto& properties = field->properties();
+        std::vector<uint32_t> constraints;
+        for (const auto& constraint : properties.constraints) constraints.push_back(this->add_constraint(constraint));
+        auto name = this->add_string(properties.name);
+        auto annotations = this->add_annotations(properties.annotations);
+        fields_[id] = field_record{
+          name, properties.ignore_details, annotations, this->add_operands(constraints)};
+        return id;
+      }
+
+      uint32_t add_model(const std::shared_ptr<Model>& model) {
+        if (!model) return this->undefined();
+        if (auto it = model_ids_.find(model.get()); it != model_ids_.end()) return it->second;
+        uint32_t id = models_.size();
+        model_ids_.emplace(model.get(), id);
+        models_.emplace_back();
+
+        const auto& properties = model->properties();
+        std::vector<uint32_t> fields;
+        for (const auto& item : properties.field_map) {
+          fields.push_back(this->add_string(item.first));
+          fields.push_back(this->add_field(item.second.field));
+          fields.push_back(item.second.required);
+        }
+        auto name = this->add_string(properties.name);
+        auto annotations = this->add_annotations(properties.annotations);
+        models_[id] = model_record{name, properties.strict, annotations, this->add_operands(fields)};
+        return id;
+      }
+
+      inline uint32_t undefined() noexcept {
+        error_ = GarlicError::UndefinedObject;
+        return none;
+      }
+
+      inline uint32_t add_optional_constraint(const Constraint& constraint) {
+        return constraint ? this->add_constraint(constraint) : none;
+      }
+
+      // Constraints are written after the constraints they contain, loading them in order
+      // always finds the inner constraints ready.
+      uint32_t add_constraint(const Constraint& constraint) {
+        const auto& context = constraint.context();
+        if (auto it = constraint_ids_.find(&context); it != constraint_ids_.end()) return it->second;
+
+        std::vector<uint32_t> items;
+        auto add_sequence = [this, &items](const sequence<Constraint>& constraints) {
+          for (const auto& item : constraints) items.push_back(this->add_constraint(item));
+        };
+        tag_code tag;
+        if (constraint.is<type_tag>()) {  // flag
+          tag = tag_code::type;
+          items.push_back(static_cast<uint32_t>(constraint.context_for<type_tag>().flag));
+        } else if (constraint.is<range_tag>()) {  // min (low, high), max (low, high)
+          tag = tag_code::range;
+          const auto& range = constraint.context_for<range_tag>();
+          for (uint64_t value : {uint64_t{range.min}, uint64_t{range.max}}) {
+            items.push_back(static_cast<uint32_t>(value));
+            items.push_back(static_cast<uint32_t>(value >> 32));
+          }
+        } else if (constraint.is<regex_tag>()) {  // pattern
+          tag = tag_code::regex;
+          items.push_back(this->add_string(std::string_view{constraint.context_for<regex_tag>().pattern.pattern()}));
+        } else if (constraint.is<any_tag>()) {  // constraints...
+          tag = tag_code::any;
+          add_sequence(constraint.context_for<any_tag>().constraints);
+        } else if (constraint.is<list_tag>()) {  // constraint, ignore_details, parallel_threshold
+          tag = tag_code::list;
+          const auto& list = constraint.context_for<list_tag>();
+          items.push_back(this->add_optional_constraint(list.constraint));
+          items.push_back(list.ignore_details);
+          items.push_back(static_cast<uint32_t>(std::min<size_t>(list.parallel_threshold, UINT32_MAX)));
+        } else if (constraint.is<tuple_tag>()) {  // strict, ignore_details, constraints...
+          tag = tag_code::tuple;
+          const auto& tuple = constraint.context_for<tuple_tag>();
+          items.push_back(tuple.strict);
+          items.push_back(tuple.ignore_details);
+          add_sequence(tuple.constraints);
+        } else if (constraint.is<map_tag>()) {  // key, value, ignore_details
+          tag = tag_code::map;
+          const auto& map = constraint.context_for<map_tag>();
+          items.push_back(this->add_optional_constraint(map.key));
+          items.push_back(this->add_optional_constraint(map.value));
+          items.push_back(map.ignore_details);
+        } else if (constraint.is<all_tag>()) {  // hide, ignore_details, constraints...
+          tag = tag_code::all;
+          const auto& all = constraint.context_for<all_tag>();
+          items.push_back(all.hide);
+          items.push_back(all.ignore_details);
+          add_sequence(all.constraints);
+        } else if (constraint.is<model_tag>()) {  // model
+          tag = tag_code::model;
+          items.push_back(this->add_model(constraint.context_for<model_tag>().model));
+        } else if (constraint.is<field_tag>()) {  // field, hide, ignore_details
+          tag = tag_code::field;
+          const auto& field = constraint.context_for<field_tag>();
+          items.push_back(field.ref ? this->add_field(*field.ref) : this->undefined());
+          items.push_back(field.hide);
+          items.push_back(field.ignore_details);
+        } else if (constraint.is<string_literal_tag>()) {  // value
+          tag = tag_code::string_literal;
+          items.push_back(this->add_string(std::string_view{constraint.context_for<string_literal_tag>().value}));
+        } else if (constraint.is<int_literal_tag>()) {  // value
+          tag = tag_code::int_literal;
+          items.push_back(static_cast<uint32_t>(constraint.context_for<int_literal_tag>().value));
+        } else if (constraint.is<int64_literal_tag>()) {  // value (low, high)
+          tag = tag_code::int64_literal;
+          auto value = static_cast<uint64_t>(constraint.context_for<int64_literal_tag>().value);
+          items.push_back(static_cast<uint32_t>(value));
+          items.push_back(static_cast<uint32_t>(value >> 32));
+        } else if (constraint.is<uint64_literal_tag>()) {  // value (low, high)
+          tag = tag_code::uint64_literal;
+          auto value = constraint.context_for<uint64_literal_tag>().value;
+          items.push_back(static_cast<uint32_t>(value));
+          items.push_back(static_cast<uint32_t>(value >> 32));
+        } else if (constraint.is<double_literal_tag>()) {  // value (low, high)
+          tag = tag_code::double_literal;
+          uint64_t bits;
+          auto value = constraint.context_for<double_literal_tag>().value;
+          std::memcpy(&bits, &value, sizeof(bits));
+          items.push_back(static_cast<uint32_t>(bits));
+          items.push_back(static_cast<uint32_t>(bits >> 32));
+        } else if (constraint.is<bool_literal_tag>()) {  // value
+          tag = tag_code::bool_literal;
+          items.push_back(constraint.context_for<bool_literal_tag>().value);
+        } else if (constraint.is<enum_tag>()) {
+          // literals, string count, integer count, large integer count, strings...,
+          // integers (low, high)..., large integers (low, high)..., doubles (low, high)...
+          tag = tag_code::enum_set;
+          const auto& set = constraint.context_for<enum_tag>();
+          auto push_wide = [&items](uint64_t value) {
+            items.push_back(static_cast<uint32_t>(value));
+            items.push_back(static_cast<uint32_t>(value >> 32));
+          };
+          items.push_back(set.literals);
+          items.push_back(static_cast<uint32_t>(set.strings.size()));
+          items.push_back(static_cast<uint32_t>(set.integers.size()));
+          items.push_back(static_cast<uint32_t>(set.large_integers.size()));
+          for (size_t index = 0; index < set.strings.size(); ++index)
+            items.push_back(this->add_string(set.strings.key(index)));
+          for (size_t index = 0; index < set.integers.size(); ++index)
+            push_wide(static_cast<uint64_t>(set.integer(index)));
+          for (size_t index = 0; index < set.large_integers.size(); ++index)
+            push_wide(set.large_integer(index));
+          for (size_t index = 0; index < set.doubles.size(); ++index) {
+            uint64_t bits;
+            auto value = set.real(index);
+            std::memcpy(&bits, &value, sizeof(bits));
+            push_wide(bits);
+          }
+        } else {
+          tag = tag_code::null_literal;
+        }
+
+        constraint_record record{
+          static_cast<uint16_t>(tag), context.is_fatal(), 0,
+          this->add_string(context.name), this->add_string(context.message), this->add_operands(items)};
+        uint32_t id = constraints_.size();
+        constraints_.push_back(record);
+        constraint_ids_.emplace(&context, id);
+        return id;
+      }
+    };
+
+    //! Turns the tables of an image back into a module, checking every reference on the way.
+    class reader {
+    public:
+      reader(const char* data, size_t size) : data_(data), size_(size) {}
+
+      std::error_code read(Module& module) {
+        if (size_ < sizeof(header)) return GarlicError::InvalidCompiledModule;
+        std::memcpy(&header_, data_, sizeof(header));
+        if (std::memcmp(header_.magic, magic, sizeof(magic)) ||
+            header_.version != version || header_.byte_order != byte_order_mark || header_.size > size_)
+          return GarlicError::InvalidCompiledModule;
+
+        if (!this->table(header_.strings, strings_) ||
+            !this->table(header_.characters, characters_) ||
+            !this->table(header_.operands, operands_) ||
+            !this->table(header_.constraints, constraint_records_) ||
+            !this->table(header_.fields, field_records_) ||
+            !this->table(header_.models, model_records_) ||
+            header_.module_fields.count > UINT32_MAX / 2 ||  // counts pairs of operands.
+            !this->table(span{header_.module_fields.offset, header_.module_fields.count * 2}, module_fields_) ||
+            !this->table(header_.module_models, module_models_))
+          return GarlicError::InvalidCompiledModule;
+
+        for (uint32_t index = 0; index < header_.strings.count; ++index) {
+          const auto& record = strings_[index];
+          if (uint64_t{record.offset} + record.length >= header_.characters.count ||
+              characters_[record.offset + record.length] != '\0')
+            return GarlicError::InvalidCompiledModule;
+        }
+
+        // empty models and fields first, so constraints can point to any of them.
+        models_.reserve(header_.models.count);
+        for (uint32_t index = 0; index < header_.models.count; ++index) {
+          const auto& record = model_records_[index];
+          Model::Properties properties;
+          if (!this->string(record.name, properties.name) ||
+              !this->annotations(record.annotations, properties.annotations))
+            return GarlicError::InvalidCompiledModule;
+          properties.strict = record.strict;
+          models_.push_back(std::make_shared<Model>(std::move(properties)));
+        }
+        fields_.reserve(header_.fields.count);
+        for (uint32_t index = 0; index < header_.fields.count; ++index) {
+          const auto& record = field_records_[index];
+          Field::Properties properties;
+          if (!this->string(record.name, properties.name) ||
+              !this->annotations(record.annotations, properties.annotations))
+            return GarlicError::InvalidCompiledModule;
+          properties.ignore_details = record.ignore_details;
+          fields_.push_back(std::make_shared<Field>(std::move(properties)));
+        }
+
+        constraints_.reserve(header_.constraints.count);
+        for (uint32_t index = 0; index < header_.constraints.count; ++index) {
+          auto constraint = this->constraint(constraint_records_[index]);
+          if (!constraint) return GarlicError::InvalidCompiledModule;
+          constraints_.push_back(std::move(constraint));
+        }
+
+        for (uint32_t index = 0; index < header_.fields.count; ++index) {
+          const auto& record = field_records_[index];
+          if (!this->valid(record.constraints)) return GarlicError::InvalidCompiledModule;
+          for (uint32_t item = 0; item < record.constraints.count; ++item) {
+            auto id = operands_[record.constraints.offset + item];
+            if (id >= constraints_.size()) return GarlicError::InvalidCompiledModule;
+            fields_[index]->add_constraint(Constraint(constraints_[id]));
+          }
+        }
+
+        for (uint32_t index = 0; index < header_.models.count; ++index) {
+          const auto& record = model_records_[index];
+          if (!this->valid(record.fields) || record.fields.count % 3) return GarlicError::InvalidCompiledModule;
+          for (uint32_t item = 0; item < record.fields.count; item += 3) {
+            const auto* operands = operands_ + record.fields.offset + item;
+            text key;
+            if (!this->string(operands[0], key) || operands[1] >= fields_.size())
+              return GarlicError::InvalidCompiledModule;
+            models_[index]->add_field(std::move(key), fields_[operands[1]], operands[2]);
+          }
+        }
+
+        for (uint32_t index = 0; index < header_.module_models.count; ++index) {
+          auto id = module_models_[index];
+          if (id >= models_.size()) return GarlicError::InvalidCompiledModule;
+          module.add_model(models_[id]);
+        }
+        for (uint32_t index = 0; index < header_.module_fields.count; ++index) {
+          text alias;
+          auto id = module_fields_[index * 2 + 1];
+          if (!this->string(module_fields_[index * 2], alias) || id >= fields_.size())
+            return GarlicError::InvalidCompiledModule;
+          if (module.find_field(alias) == module.end_fields()) module.add_field(std::move(alias), fields_[id]);
+        }
+
+        module.freeze();
+        return std::error_code();
+      }
+
+    private:
+      const char* data_;
+      size_t size_;
+      header header_;
+      const string_record* strings_;
+      const char* characters_;
+      const uint32_t* operands_;
+      const constraint_record* constraint_records_;
+      const field_record* field_records_;
+      const model_record* model_records_;
+      const uint32_t* module_fields_;
+      const uint32_t* module_models_;
+
+      std::vector<std::shared_ptr<Model>> models_;
+      std::vector<std::shared_ptr<Field>> fields_;
+      std::vector<Constraint> constraints_;
+
+      template<typename T>
+      bool table(const span& target, const T*& output) const noexcept {
+        if (target.offset % alignof(T) || uint64_t{target.offset} + uint64_t{target.count} * sizeof(T) > header_.size)
+          return false;
+        output = reinterpret_cast<const T*>(data_ + target.offset);
+        return true;
+      }
+
+      inline bool valid(const span& target) const noexcept {
+        return uint64_t{target.offset} + target.count <= header_.operands.count;
+      }
+
+      // Strings are copied out of the image so the module does not depend on it.
+      bool string(uint32_t id, text& output) const {
+        if (id >= header_.strings.count) return false;
+        const auto& record = strings_[id];
+        output = record.length ? text::copy(characters_ + record.offset, record.length) : text::no_text();
+        return true;
+      }
+
+      bool annotations(const span& target, std::unordered_map<text, text>& output) const {
+        if (!this->valid(target) || target.count % 2) return false;
+        for (uint32_t index = 0; index < target.count; index += 2) {
+          text key, value;
+          if (!this->string(operands_[target.offset + index], key) ||
+              !this->string(operands_[target.offset + index + 1], value))
+            return false;
+          output.emplace(std::move(key), std::move(value));
+        }
+        return true;
+      }
+
+      // Only constraints that come before the current one can be referred to.
+      bool optional_constraint(uint32_t id, uint32_t limit, Constraint& output) const {
+        if (id == none) return true;
+        if (id >= limit) return false;
+        output = constraints_[id];
+        return true;
+      }
+
+      bool constraint_sequence(const uint32_t* ids, uint32_t count, sequence<Constraint>& output) const {
+        for (uint32_t index = 0; index < count; ++index) {
+          if (ids[index] >= constraints_.size()) return false;
+          output.push_back(constraints_[ids[index]]);
+        }
+        return true;
+      }
+
+      Constraint constraint(const constraint_record& record) const {
+        text name, message;
+        if (!this->valid(record.operands) || !this->string(record.name, name) || !this->string(record.message, message))
+          return Constraint::empty();
+        const auto* items = operands_ + record.operands.offset;
+        auto count = record.operands.count;
+        bool fatal = record.fatal;
+        auto limit = constraints_.size();
+        auto wide = [items](uint32_t index) { return uint64_t{items[index]} | uint64_t{items[index + 1]} << 32; };
+
+        switch (static_cast<tag_code>(record.tag)) {
+          case tag_code::type:
+            if (count != 1) break;
+            return make_constraint<type_tag>(
+                static_cast<TypeFlag>(items[0]), std::move(name), std::move(message), fatal);
+          case tag_code::range:
+            if (count != 4) break;
+            return make_constraint<range_tag>(
+                static_cast<range_tag::size_type>(wide(0)), static_cast<range_tag::size_type>(wide(2)),
+                std::move(name), std::move(message), fatal);
+          case tag_code::regex: {
+            text pattern;
+            if (count != 1 || !this->string(items[0], pattern)) break;
+            // patterns compile on their first match, most of a large module is never exercised at once.
+            return make_constraint<regex_tag>(
+                regex_matcher(std::string_view{pattern.data(), pattern.size()}, regex_matcher::deferred),
+                std::move(name), std::move(message), fatal);
+          }
+          case tag_code::any: {
+            sequence<Constraint> constraints(count);
+            if (!this->constraint_sequence(items, count, constraints)) break;
+            return make_constraint<any_tag>(std::move(constraints), std::move(name), std::move(message), fatal);
+          }
+          case tag_code::list: {
+            auto inner = Constraint::empty();
+            if (count != 3 || !this->optional_constraint(items[0], limit, inner)) break;
+            return make_constraint<list_tag>(
+                std::move(inner), static_cast<bool>(items[1]), static_cast<size_t>(items[2]),
+                std::move(name), std::move(message), fatal);
+          }
+          case tag_code::tuple: {
+            if (count < 2) break;
+            sequence<Constraint> constraints(count - 2);
+            if (!this->constraint_sequence(items + 2, count - 2, constraints)) break;
+            return make_constraint<tuple_tag>(
+                std::move(constraints), static_cast<bool>(items[0]), static_cast<bool>(items[1]),
+                std::move(name), std::move(message), fatal);
+          }
+          case tag_code::map: {
+            auto key = Constraint::empty();
+            auto value = Constraint::empty();
+            if (count != 3 || !this->optional_constraint(items[0], limit, key) ||
+                !this->optional_constraint(items[1], limit, value))
+              break;
+            return make_constraint<map_tag>(
+                std::move(key), std::move(value), static_cast<bool>(items[2]),
+                std::move(name), std::move(message), fatal);
+          }
+          case tag_code::all: {
+            if (count < 2) break;
+            sequence<Constraint> constraints(count - 2);
+            if (!this->constraint_sequence(items + 2, count - 2, constraints)) break;
+            return make_constraint<all_tag>(
+                std::move(constraints), static_cast<bool>(items[0]), static_cast<bool>(items[1]),
+                std::move(name), std::move(message), fatal);
+          }
+          case tag_code::model:
+            if (count != 1 || items[0] >= models_.size()) break;
+            return make_constraint<model_tag>(models_[items[0]], std::move(name), std::move(message), fatal);
+          case tag_code::field:
+            if (count != 3 || items[0] >= fields_.size()) break;
+            return make_constraint<field_tag>(
+                fields_[items[0]], static_cast<bool>(items[1]), static_cast<bool>(items[2]),
+                std::move(name), std::move(message), fatal);
+          case tag_code::string_literal: {
+            text value;
+            if (count != 1 || !this->string(items[0], value)) break;
+            return make_constraint<string_literal_tag>(
+                std::string(value.data(), value.size()), std::move(name), std::move(message), fatal);
+          }
+          case tag_code::int_literal:
+            if (count != 1) break;
+            return make_constraint<int_literal_tag>(
+                static_cast<int>(items[0]), std::move(name), std::move(message), fatal);
+          case tag_code::int64_literal:
+            if (count != 2) break;
+            return make_constraint<int64_literal_tag>(
+                static_cast<int64_t>(wide(0)), std::move(name), std::move(message), fatal);
+          case tag_code::uint64_literal:
+            if (count != 2) break;
+            return make_constraint<uint64_literal_tag>(wide(0), std::move(name), std::move(message), fatal);
+          case tag_code::double_literal: {
+            if (count != 2) break;
+            double value;
+            auto bits = wide(0);
+            std::memcpy(&value, &bits, sizeof(value));
+            return make_constraint<double_literal_tag>(value, std::move(name), std::move(message), fatal);
+          }
+          case tag_code::bool_literal:
+            if (count != 1) break;
+            return make_constraint<bool_literal_tag>(
+                static_cast<bool>(items[0]), std::move(name), std::move(message), fatal);
+          case tag_code::null_literal:
+            if (count) break;
+            return make_constraint<null_literal_tag>(std::move(name), std::move(message), fatal);
+          case tag_code::enum_set: {
+            if (count < 4 || items[0] > 0x7 || items[1] > count - 4) break;
+            uint64_t wide_count = (count - 4 - items[1]);
+            if (wide_count % 2 || wide_count / 2 < uint64_t{items[2]} + items[3]) break;
+            enum_tag::values_type values;
+            values.strings.resize(items[1]);
+            bool valid = true;
+            uint32_t index = 4;
+            for (auto& value : values.strings) {
+              text string;
+              valid = valid && this->string(items[index++], string);
+              value.assign(string.data(), string.size());
+            }
+            if (!valid) break;
+            for (uint32_t item = 0; item < items[2]; ++item, index += 2)
+              values.integers.push_back(static_cast<int64_t>(wide(index)));
+            for (uint32_t item = 0; item < items[3]; ++item, index += 2)
+              values.large_integers.push_back(wide(index));
+            for (; index < count; index += 2) {
+              double value;
+              auto bits = wide(index);
+              std::memcpy(&value, &bits, sizeof(value));
+              values.doubles.push_back(value);
+            }
+            if (items[0] & enum_tag::Context::false_value) values.booleans.push_back(false);
+            if (items[0] & enum_tag::Context::true_value) values.booleans.push_back(true);
+            values.null = items[0] & enum_tag::Context::null_value;
+            return make_constraint<enum_tag>(std::move(values), std::move(name), std::move(message), fatal);
+          }
+        }
+        return Constraint::empty();
+      }
+    };
+
+  }
+
+  //! Dumps a fully resolved Module into a versioned, position-independent binary image.
+  /*! The image holds no pointers, only offsets and ids, so it can be written to a file and
+   *  mapped back in any process. Fields and models that are shared or refer to each other
+   *  keep doing so once the image is loaded.
+   *
+   *  @code
+   *  auto image = garlic::parsing::dump_compiled_module(module);
+   *  auto loaded = garlic::parsing::load_compiled_module(image->data(), image->size());
+   *  @endcode
+   *
+   *  @return the image or GarlicError::UndefinedObject if the module refers to a field
+   *          that was never resolved.
+   */
+  static inline tl::expected<std::string, std::error_code>
+  dump_compiled_module(const Module& module) {
+    compiled::writer writer(module);
+    if (auto error = writer.error(); error) return tl::make_unexpected(error);
+    return writer.image();
+  }
+
+  //! Dumps a Module as a binary image into an open and writable file.
+  static inline tl::expected<void, std::error_code>
+  dump_compiled_module(const Module& module, FILE* file) {
+    auto image = dump_compiled_module(module);
+    if (!image) return tl::make_unexpected(image.error());
+    if (fwrite(image->data(), 1, image->size(), file) != image->size())
+      return tl::make_unexpected(std::error_code(errno, std::generic_category()));
+    return tl::expected<void, std::error_code>();
+  }
+
+  //! Loads a Module from a binary image made by dump_compiled_module().
+  /*! @param data pointer to the image, it can be released as soon as this function returns.
+   *              Images that are not aligned to 8 bytes get copied first.
+   *  @param size the size of the image.
+   *  @return the Module or GarlicError::InvalidCompiledModule if the image is corrupt or
+   *          was made by an incompatible version.
+   */
+  static inline tl::expected<Module, std::error_code>
+  load_compiled_module(const void* data, size_t size) noexcept {
+    if (reinterpret_cast<uintptr_t>(data) % alignof(uint64_t)) {
+      std::vector<uint64_t> buffer((size + 7) / 8);
+      std::memcpy(buffer.data(), data, size);
+      return load_compiled_module(buffer.data(), size);
+    }
+    Module module;
+    if (auto error = compiled::reader(static_cast<const char*>(data), size).read(module); error)
+      return tl::make_unexpected(error);
+    return module;
+  }
+
+  //! Loads a Module from a file that holds a binary image made by dump_compiled_module().
+  /*! The file is mapped into memory instead of being read wherever mmap is available.
+   */
+  static inline tl::expected<Module, std::error_code>
+  load_compiled_module(const char* path) noexcept {
+#ifdef GARLIC_COMPILED_USE_MMAP
+    auto descriptor = open(path, O_RDONLY);
+    if (descriptor < 0) return tl::make_unexpected(std::error_code(errno, std::generic_category()));
+    struct stat status;
+    if (fstat(descriptor, &status) < 0) {
+      auto error = std::error_code(errno, std::generic_category());
+      close(descriptor);
+      return tl::make_unexpected(error);
+    }
+    size_t size = status.st_size;
+    if (!size) {
+      close(descriptor);
+      return tl::make_unexpected(GarlicError::InvalidCompiledModule);
+    }
+    auto data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (data == MAP_FAILED) return tl::make_unexpected(std::error_code(errno, std::generic_category()));
+    auto result = load_compiled_module(data, size);
+    munmap(data, size);
+    return result;
+#else
+    auto file = fopen(path, "rb");
+    if (!file) return tl::make_unexpected(std::error_code(errno, std::generic_category()));
+    std::string content;
+    char chunk[4096];
+    for (size_t count; (count = fread(chunk, 1, sizeof(chunk), file));) content.append(chunk, count);
+    fclose(file);
+    return load_compiled_module(content.data(), content.size());
+#endif
+  }
+
+}
+
+#endif /* end of include guard: GARLIC_PARSING_COMPILED */
@@ -45,7 +45,8 @@ namespace garlic::parsing {
     read_constraint(layer, parser, "of", constraint);
     return build_constraint<true, list_tag>(
         layer, "list_constraint",
-        std::move(constraint), get(layer, "ignore_details", false));
+        std::move(constraint), get(layer, "ignore_details", false),
+        static_cast<size_t>(get(layer, "parallel_threshold", 0)));
   }
 
 
@@ -66,11 +67,16 @@ namespace garlic::parsing {
     using SizeType = typename range_tag::size_type;
     SizeType min;
     SizeType max;
+    // bounds past 2^53 only survive as integers.
     get_member(layer, "min", [&min](const auto& v) {
-        if (v.is_double()) min = v.get_double(); else min = v.get_int();
+        if (garlic::is_uint64(v)) min = garlic::get_uint64(v);
+        else if (v.is_double()) min = v.get_double();
+        else min = v.get_int();
         });
     get_member(layer, "max", [&max](const auto& v) {
-        if (v.is_double()) max = v.get_double(); else max = v.get_int();
+        if (garlic::is_uint64(v)) max = garlic::get_uint64(v);
+        else if (v.is_double()) max = v.get_double();
+        else max = v.get_int();
         });
     return build_constraint<false, range_tag>(layer, "range_constraint", std::move(min), std::move(max));
   }
@@ -79,7 +85,7 @@ namespace garlic::parsing {
   template<GARLIC_VIEW Input, typename Parser>
   static Constraint
   parse_regex(const Input& layer, Parser parser) noexcept {
-    return build_constraint<false, regex_tag>(layer, "regex_constraint", get<text>(layer, "pattern"));
+    return build_constraint<false, regex_tag>(layer, "regex_constraint", get<text>(layer, "pattern", ""));
   }
 
 
@@ -124,6 +130,14 @@ namespace garlic::parsing {
           result = build_constraint<false, int_literal_tag>(layer, "literal_constraint", item.get_int());
           return;
         }
+        else if (garlic::is_int64(item)) {
+          result = build_constraint<false, int64_literal_tag>(layer, "literal_constraint", garlic::get_int64(item));
+          return;
+        }
+        else if (garlic::is_uint64(item)) {
+          result = build_constraint<false, uint64_literal_tag>(layer, "literal_constraint", garlic::get_uint64(item));
+          return;
+        }
         else if (item.is_double()) {
           result = build_constraint<false, double_literal_tag>(layer, "literal_constraint", item.get_double());
           return;
@@ -144,6 +158,27 @@ namespace garlic::parsing {
     return result;
   }
 
+  template<GARLIC_VIEW Input, typename Parser>
+  static Constraint
+  parse_enum(const Input& layer, Parser parser) noexcept {
+    enum_tag::values_type values;
+    get_member(layer, "values", [&values](const auto& items) {
+        for (const auto& item : items.get_list()) {
+          if (garlic::is_int64(item)) values.integers.push_back(garlic::get_int64(item));
+          else if (garlic::is_uint64(item)) values.large_integers.push_back(garlic::get_uint64(item));
+          else if (item.is_double()) values.doubles.push_back(item.get_double());
+          else if (item.is_bool() || item.is_null()) {
+            if (item.is_bool()) values.booleans.push_back(item.get_bool());
+            else values.null = true;
+            // yaml scalars such as "no" or "null" are strings as well, keep matching them as such.
+            if (item.is_string()) values.strings.emplace_back(item.get_string_view());
+          }
+          else if (item.is_string()) values.strings.emplace_back(item.get_string_view());
+        }
+        });
+    return build_constraint<false, enum_tag>(layer, "enum_constraint", std::move(values));
+  }
+
 
 
   template<GARLIC_VIEW Input, typename ParserType>
@@ -291,6 +291,7 @@ namespace garlic::parsing {
         {"tuple", &parsing::parse_tuple<Layer>},
         {"map", &parsing::parse_map<Layer>},
         {"literal", &parsing::parse_literal<Layer>},
+        {"enum", &parsing::parse_enum<Layer>},
       };
 
       if (layer.is_string()) {
@@ -387,7 +388,10 @@ namespace garlic::parsing {
         }
       });
 
-      return (field_dependents_.size() ? GarlicError::UndefinedObject : std::error_code());
+      if (field_dependents_.size()) return GarlicError::UndefinedObject;
+
+      module_.freeze();
+      return std::error_code();
     }
   };
 
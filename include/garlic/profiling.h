@@ -0,0 +1,223 @@
+#ifndef GARLIC_PROFILING_H
+#define GARLIC_PROFILING_H
+
+/*! @file profiling.h
+ *  @brief Opt-in counters of how often and for how long constraints, fields and models run.
+ *
+ *  Nothing is recorded unless GARLIC_ENABLE_PROFILING is defined before any garlic header is
+ *  included, in every translation unit of the program. Without it the probes are not compiled
+ *  into Constraint, Field and Model at all.
+ *
+ *  @code
+ *  #define GARLIC_ENABLE_PROFILING
+ *  #include <garlic/garlic.h>
+ *
+ *  model->validate(document);
+ *  garlic::profiling::dump(std::cout, 10);  // the ten that took the most time.
+ *  @endcode
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#ifdef GARLIC_ENABLE_PROFILING
+//! Runs the expression between a pair of clock reads and records it for the key, evaluates to its result.
+#define GARLIC_PROFILE(kind, key, name, ...) (::garlic::profiling::probe(kind, key, name).finish(__VA_ARGS__))
+#else
+#define GARLIC_PROFILE(kind, key, name, ...) (__VA_ARGS__)
+#endif
+
+namespace garlic::profiling {
+
+  //! What a set of counters belongs to.
+  enum class scope : uint8_t {
+    constraint,
+    field,
+    model,
+  };
+
+  inline const char* scope_name(scope kind) noexcept {
+    switch (kind) {
+      case scope::constraint: return "constraint";
+      case scope::field: return "field";
+      case scope::model: return "model";
+    }
+    return "";
+  }
+
+  //! Totals of every constraint, field or model of the same kind and name, across all threads.
+  struct entry {
+    scope kind;
+    std::string name;
+    uint64_t calls = 0;
+    uint64_t failures = 0;
+    uint64_t nanoseconds = 0;  //!< includes the time of everything nested in it.
+  };
+
+  namespace internal {
+    //! Counters written by a single thread and read by anyone taking a report.
+    struct counter {
+      scope kind;
+      std::string name;
+      std::atomic<uint64_t> calls = 0;
+      std::atomic<uint64_t> failures = 0;
+      std::atomic<uint64_t> nanoseconds = 0;
+
+      counter(scope kind, std::string_view name) : kind(kind), name(name) {}
+
+      inline void add(bool failed, uint64_t elapsed) noexcept {
+        // only the owning thread writes, a plain load and store is enough.
+        calls.store(calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (failed) failures.store(failures.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        nanoseconds.store(nanoseconds.load(std::memory_order_relaxed) + elapsed, std::memory_order_relaxed);
+      }
+
+      inline void clear() noexcept {
+        calls.store(0, std::memory_order_relaxed);
+        failures.store(0, std::memory_order_relaxed);
+        nanoseconds.store(0, std::memory_order_relaxed);
+      }
+    };
+
+    //! Counters of a thread by the address of what they count.
+    /*! The owner only locks to add a new key, readers lock to walk the table. */
+    class thread_counters {
+    public:
+      template<typename Name>
+      inline counter& get(scope kind, const void* key, const Name& name) {
+        if (key == last_key_) return *last_;
+        auto it = counters_.find(key);
+        if (it == counters_.end()) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          it = counters_.try_emplace(key, kind, std::string_view(name.data(), name.size())).first;
+        }
+        last_key_ = key;
+        return *(last_ = &it->second);
+      }
+
+      template<typename Callable>
+      void for_each(Callable&& cb) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& item : counters_) cb(item.second);
+      }
+
+    private:
+      std::mutex mutex_;
+      std::unordered_map<const void*, counter> counters_;  // nodes stay in place.
+      const void* last_key_ = nullptr;
+      counter* last_ = nullptr;
+    };
+
+    //! Counters of every thread that ever recorded anything, kept after the thread exits.
+    struct thread_list {
+      std::mutex mutex;
+      std::vector<std::shared_ptr<thread_counters>> threads;
+    };
+
+    inline thread_list& threads() {
+      static thread_list list;
+      return list;
+    }
+
+    inline thread_counters& local() {
+      thread_local auto counters = []() {
+        auto counters = std::make_shared<thread_counters>();
+        auto& list = threads();
+        std::lock_guard<std::mutex> lock(list.mutex);
+        list.threads.push_back(counters);
+        return counters;
+      }();
+      return *counters;
+    }
+
+    template<typename Callable>
+    void for_each_counter(Callable&& cb) {
+      auto& list = threads();
+      std::lock_guard<std::mutex> lock(list.mutex);
+      for (auto& counters : list.threads) counters->for_each(cb);
+    }
+  }
+
+  //! Times a single call and adds it to the counters of the calling thread.
+  class probe {
+  public:
+    template<typename Name>
+    probe(scope kind, const void* key, const Name& name
+        ) : counter_(internal::local().get(kind, key, name)), start_(std::chrono::steady_clock::now()) {}
+
+    //! Records the call as failed if the result converts to false. @return the result.
+    template<typename Result>
+    inline Result finish(Result&& result) noexcept {
+      auto elapsed = std::chrono::steady_clock::now() - start_;
+      counter_.add(
+          !static_cast<bool>(result),
+          std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+      return std::forward<Result>(result);
+    }
+
+  private:
+    internal::counter& counter_;
+    std::chrono::steady_clock::time_point start_;
+  };
+
+  //! @return the totals of every kind and name, the ones that took the most time first.
+  /*! Threads that are still validating may be counted up to their last few calls. */
+  inline std::vector<entry> report() {
+    std::map<std::tuple<scope, std::string_view>, entry> totals;
+    internal::for_each_counter([&totals](const internal::counter& item) {
+        auto& total = totals[{item.kind, item.name}];
+        total.kind = item.kind;
+        if (total.name.empty()) total.name = item.name;
+        total.calls += item.calls.load(std::memory_order_relaxed);
+        total.failures += item.failures.load(std::memory_order_relaxed);
+        total.nanoseconds += item.nanoseconds.load(std::memory_order_relaxed);
+        });
+    std::vector<entry> entries;
+    entries.reserve(totals.size());
+    for (auto& item : totals) {
+      if (item.second.calls) entries.push_back(std::move(item.second));
+    }
+    std::sort(entries.begin(), entries.end(), [](const entry& a, const entry& b) {
+        return a.nanoseconds > b.nanoseconds;
+        });
+    return entries;
+  }
+
+  //! Sets every counter back to zero.
+  /*! @note Counters are kept by address, call it after models are replaced so that new ones
+   *        allocated in the same place are not counted under the names of the old ones.
+   *  @note Calls that are running meanwhile may still be added to the old totals.
+   */
+  inline void reset() {
+    internal::for_each_counter([](internal::counter& item) { item.clear(); });
+  }
+
+  //! Writes the report as a table, at most limit rows of it.
+  inline void dump(std::ostream& output, size_t limit = 20) {
+    auto entries = report();
+    output << std::left << std::setw(12) << "kind" << std::setw(32) << "name"
+      << std::right << std::setw(12) << "calls" << std::setw(12) << "failures"
+      << std::setw(14) << "total (us)" << std::setw(12) << "avg (ns)" << '\n';
+    for (size_t index = 0; index < entries.size() && index < limit; ++index) {
+      const auto& item = entries[index];
+      output << std::left << std::setw(12) << scope_name(item.kind) << std::setw(32) << item.name
+        << std::right << std::setw(12) << item.calls << std::setw(12) << item.failures
+        << std::setw(14) << item.nanoseconds / 1000 << std::setw(12) << item.nanoseconds / item.calls << '\n';
+    }
+  }
+
+}
+
+#endif /* end of include guard: GARLIC_PROFILING_H */
@@ -0,0 +1,660 @@
+#ifndef GARLIC_PROGRAM_H
+#define GARLIC_PROGRAM_H
+
+/*! @file program.h
+ *  @brief Validation of constraints and models by a flat bytecode interpreter.
+ */
+
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "constraints.h"
+#include "containers.h"
+#include "regex.h"
+
+namespace garlic {
+
+  //! The first failure a Program runs into, recorded without making any ConstraintResult.
+  /*! A trace only keeps the failed constraint, a static reason and the path from the layer to the
+   *  failed value as member keys and list indices. Names, the path and a ConstraintResult are made
+   *  only when they are asked for, so rejecting a layer costs about as much as accepting it.
+   *
+   *  clear() keeps the memory of the path, a single trace can be reused for every validation.
+   *
+   *  @code
+   *  FailureTrace trace;
+   *  if (!program.trace(document, trace)) {
+   *    std::cout << trace.path() << ": " << trace.reason() << std::endl;  // items.3.name: invalid value.
+   *  }
+   *  @endcode
+   *
+   *  @note Member keys are views into the layer, the trace is only good for as long as the layer is.
+   */
+  class FailureTrace {
+  public:
+    //! A member key or an index of a list on the way to the failed value.
+    struct segment {
+      std::string_view key;
+      size_t index;
+
+      inline bool is_index() const noexcept { return key.data() == nullptr; }
+    };
+
+    FailureTrace() : segments_(0) {}
+
+    //! @return whether or not a failure is recorded.
+    bool failed() const noexcept { return failed_; }
+
+    //! @return the number of segments in the path.
+    size_t depth() const noexcept { return segments_.size(); }
+
+    //! @return the segment of the path at a depth, the first one is the closest to the root.
+    const segment& at(size_t depth) const noexcept { return segments_[segments_.size() - depth - 1]; }
+
+    //! @return the path to the failed value, keys and indices joined by dots.
+    std::string path() const {
+      std::string result;
+      for (size_t depth = 0; depth < this->depth(); ++depth) {
+        if (depth) result.push_back('.');
+        const auto& item = this->at(depth);
+        if (item.is_index()) result += std::to_string(item.index);
+        else result.append(item.key);
+      }
+      return result;
+    }
+
+    //! @return the name of the failed constraint, or the name of the model for missing fields and non-objects.
+    text name() const noexcept {
+      if (context_) return context_->name;
+      if (model_) return model_->name();
+      return text::no_text();
+    }
+
+    //! @return the custom message of the failed constraint if it has one, otherwise the reason it failed.
+    text reason() const noexcept {
+      if (context_ && !context_->message.empty()) return context_->message;
+      return reason_ ? text(reason_) : text::no_text();
+    }
+
+    //! Makes a ConstraintResult with a field detail for every segment of the path.
+    ConstraintResult result() const noexcept {
+      if (!failed_) return ConstraintResult::ok();
+      auto result = ConstraintResult::leaf_failure(this->name(), this->reason());
+      for (const auto& item : segments_) {
+        auto name = item.is_index() ? std::to_string(item.index) : std::string(item.key);
+        result = ConstraintResult::field_failure(text::copy(name), std::move(result), "invalid value.");
+      }
+      return result;
+    }
+
+    //! Forgets the failure but keeps the memory for the next one.
+    void clear() noexcept {
+      segments_.clear();
+      context_ = nullptr;
+      model_ = nullptr;
+      reason_ = nullptr;
+      failed_ = false;
+    }
+
+  private:
+    friend class Program;
+
+    sequence<segment> segments_;  // the innermost segment comes first.
+    const constraint_context* context_ = nullptr;
+    const Model* model_ = nullptr;
+    const char* reason_ = nullptr;
+    bool failed_ = false;
+
+    inline void fail(const constraint_context* context, const char* reason) noexcept {
+      context_ = context;
+      reason_ = reason;
+      failed_ = true;
+    }
+
+    inline void fail(const Model* model, const char* reason) noexcept {
+      model_ = model;
+      reason_ = reason;
+      failed_ = true;
+    }
+
+    inline void push(std::string_view key) { segments_.push_back(segment{key, 0}); }
+    inline void push(size_t index) { segments_.push_back(segment{std::string_view{}, index}); }
+  };
+
+  //! A Constraint or a Model lowered into a contiguous bytecode program.
+  /*! Constraint::test() dispatches through the constraint registry and then follows a shared
+   *  pointer to every context, nested constraints pointer-chase one level at a time. A Program
+   *  walks the same graph once and lays it out as blocks of instructions in a single array,
+   *  with all of their operands in another one, so that a tight validation loop only touches
+   *  those two arrays, the regex automata and the field tables of the models.
+   *
+   *  A block is a run of instructions that all have to pass for the layer to pass, it ends with
+   *  opcode::pass. The all_tag groups and the constraints of fields are laid out inline, lists,
+   *  tuples, maps and the alternatives of any_tag refer to the blocks of their inner constraints
+   *  and models keep a perfect hash table from member keys to the blocks of their fields, whether
+   *  or not the models themselves are frozen.
+   *
+   *  The interpreter only decides whether or not a layer passes and where it first fails, see
+   *  trace(). The tree evaluator stays the reference implementation and is used to explain
+   *  failures in full in test().
+   *
+   *  @code
+   *  auto program = Program::compile(module.get_model("User"));
+   *  program.quick_test(document);  // same as the model's quick_test().
+   *  program.test(document);  // same as the model's validate().
+   *  @endcode
+   *
+   *  @note A program is a snapshot of the graph it was compiled from, it keeps that graph alive
+   *        but has to be compiled again after the models, fields or constraints change.
+   */
+  class Program {
+  public:
+    //! Instructions that only look at the layer come before opcode::any, see run().
+    enum class opcode : uint8_t {
+      pass,            //!< end of the block, every instruction before it passed.
+      type,            //!< operand: the TypeFlag.
+      range,           //!< operand: index of the minimum and the maximum.
+      regex,           //!< operand: index of the matcher.
+      string_literal,  //!< operand: index of the offset and the size of the string in the characters.
+      int_literal,     //!< operand: index of the value.
+      int64_literal,   //!< operand: index of the value.
+      uint64_literal,  //!< operand: index of the value.
+      double_literal,  //!< operand: index of the bits of the value.
+      bool_literal,    //!< operand: the value.
+      null_literal,
+      enum_set,        //!< operand: index of the set.
+      any,             //!< operand: index of the count followed by the block of every alternative.
+      list,            //!< operand: block of the items.
+      tuple,           //!< operand: index of the count, the strict flag and the block of every item.
+      map,             //!< operand: index of the key block and the value block, either may be none.
+      model,           //!< operand: index of the model.
+      call,            //!< operand: block of a field.
+    };
+
+    struct instruction {
+      opcode code;
+      uint32_t operand;
+    };
+
+    static constexpr uint32_t none = UINT32_MAX;
+
+    //! Compiles a constraint and everything it refers to.
+    static Program compile(const Constraint& constraint) {
+      Program program;
+      program.constraint_ = constraint;
+      compiler builder(program);
+      block_code code;
+      builder.emit(constraint, code);
+      program.entry_ = builder.append(code);
+      builder.finish();
+      return program;
+    }
+
+    //! Compiles a model and everything it refers to.
+    static Program compile(std::shared_ptr<Model> model) {
+      Program program;
+      compiler builder(program);
+      block_code code;
+      code.push(instruction{opcode::model, builder.model(model)}, nullptr);
+      program.entry_ = builder.append(code);
+      builder.finish();
+      program.model_ = std::move(model);
+      return program;
+    }
+
+    //! Runs the program on the layer, same as quick_test() of what it was compiled from.
+    template<GARLIC_VIEW Layer>
+    bool quick_test(const Layer& layer) const noexcept {
+      return this->step(entry_, layer, nullptr);
+    }
+
+    /*! @return an ok result if the program passes the layer, otherwise the result of the
+     *          constraint or the model it was compiled from.
+     */
+    template<GARLIC_VIEW Layer>
+    ConstraintResult test(const Layer& layer) const noexcept {
+      if (this->step(entry_, layer, nullptr)) return ConstraintResult::ok();
+      if (model_) return model_->validate(layer);
+      return constraint_.test(layer);
+    }
+
+    //! Runs the program and records where the layer first fails in the trace, which is cleared first.
+    /*! @return whether or not the layer passes, same as quick_test().
+     *  @note The trace follows the first failing constraint only, the alternatives of any_tag
+     *        are reported as the any_tag constraint itself.
+     */
+    template<GARLIC_VIEW Layer>
+    bool trace(const Layer& layer, FailureTrace& trace) const noexcept {
+      trace.clear();
+      return this->step(entry_, layer, &trace);
+    }
+
+    //! @return the instructions of every block.
+    const std::vector<instruction>& code() const noexcept { return code_; }
+
+  private:
+    //! Table of a model from its member keys to the blocks of their fields.
+    struct model_entry {
+      perfect_map<uint32_t> fields;
+      std::vector<uint64_t> required;
+      const Model* model = nullptr;
+    };
+
+    //! Instructions of a block along with the constraints they come from.
+    struct block_code {
+      std::vector<instruction> code;
+      std::vector<const constraint_context*> sources;
+
+      inline void push(instruction item, const constraint_context* source) {
+        code.push_back(item);
+        sources.push_back(source);
+      }
+    };
+
+    class compiler {
+    public:
+      explicit compiler(Program& program) : program_(program) {}
+
+      //! @return the block of a single constraint, none for an empty constraint.
+      uint32_t block(const Constraint& constraint) {
+        if (!constraint) return none;
+        block_code code;
+        this->emit(constraint, code);
+        return this->append(code);
+      }
+
+      //! @return the index of the model, its fields are compiled by finish().
+      uint32_t model(const std::shared_ptr<Model>& model) {
+        if (auto it = models_.find(model.get()); it != models_.end()) return it->second;
+        auto index = static_cast<uint32_t>(program_.models_.size());
+        program_.models_.emplace_back();
+        program_.anchors_.push_back(model);
+        models_.emplace(model.get(), index);
+        pending_.push_back(model.get());
+        return index;
+      }
+
+      //! Closes the block and appends it to the program. @return where the block starts.
+      uint32_t append(block_code& code) {
+        code.push(instruction{opcode::pass, 0}, nullptr);
+        auto start = static_cast<uint32_t>(program_.code_.size());
+        program_.code_.insert(program_.code_.end(), code.code.begin(), code.code.end());
+        program_.sources_.insert(program_.sources_.end(), code.sources.begin(), code.sources.end());
+        return start;
+      }
+
+      //! Builds the field tables of the models, models are only reserved while compiling so cycles end here.
+      void finish() {
+        while (!pending_.empty()) {
+          auto model = pending_.back();
+          pending_.pop_back();
+          const auto& field_map = model->properties().field_map;
+          model_entry entry;
+          entry.model = model;
+          entry.required.assign((field_map.size() + 63) / 64, 0);
+          for (const auto& [key, descriptor] : field_map) {
+            auto position = entry.fields.size();  // positions follow the order of emplace().
+            if (descriptor.required) entry.required[position / 64] |= uint64_t{1} << (position % 64);
+            entry.fields.emplace(std::string_view{key.data(), key.size()}, this->field(descriptor.field));
+          }
+          entry.fields.build();
+          program_.models_[models_.at(model)] = std::move(entry);
+        }
+      }
+
+      //! Lays out a constraint at the end of a block, all_tag groups are flattened into it.
+      void emit(const Constraint& constraint, block_code& code) {
+        if (!constraint) return;
+        auto& operands = program_.operands_;
+        auto source = &constraint.context();
+        if (constraint.is<type_tag>()) {
+          const auto& context = constraint.context_for<type_tag>();
+          code.push(instruction{opcode::type, static_cast<uint32_t>(context.flag)}, source);
+        } else if (constraint.is<range_tag>()) {
+          const auto& context = constraint.context_for<range_tag>();
+          auto index = this->operand(context.min);
+          this->operand(context.max);
+          code.push(instruction{opcode::range, index}, source);
+        } else if (constraint.is<regex_tag>()) {
+          program_.matchers_.push_back(&constraint.context_for<regex_tag>().pattern);
+          code.push(instruction{opcode::regex, static_cast<uint32_t>(program_.matchers_.size() - 1)}, source);
+        } else if (constraint.is<any_tag>()) {
+          const auto& constraints = constraint.context_for<any_tag>().constraints;
+          std::vector<uint64_t> blocks;
+          for (const auto& item : constraints) blocks.push_back(this->block(item));
+          auto index = this->operand(blocks.size());
+          operands.insert(operands.end(), blocks.begin(), blocks.end());
+          code.push(instruction{opcode::any, index}, source);
+        } else if (constraint.is<list_tag>()) {
+          code.push(instruction{opcode::list, this->block(constraint.context_for<list_tag>().constraint)}, source);
+        } else if (constraint.is<tuple_tag>()) {
+          const auto& context = constraint.context_for<tuple_tag>();
+          std::vector<uint64_t> blocks;
+          for (const auto& item : context.constraints) blocks.push_back(this->block(item));
+          auto index = this->operand(blocks.size());
+          this->operand(context.strict);
+          operands.insert(operands.end(), blocks.begin(), blocks.end());
+          code.push(instruction{opcode::tuple, index}, source);
+        } else if (constraint.is<map_tag>()) {
+          const auto& context = constraint.context_for<map_tag>();
+          auto key = this->block(context.key);
+          auto value = this->block(context.value);
+          auto index = this->operand(key);
+          this->operand(value);
+          code.push(instruction{opcode::map, index}, source);
+        } else if (constraint.is<all_tag>()) {
+          for (const auto& item : constraint.context_for<all_tag>().constraints) this->emit(item, code);
+        } else if (constraint.is<model_tag>()) {
+          code.push(instruction{opcode::model, this->model(constraint.context_for<model_tag>().model)}, source);
+        } else if (constraint.is<field_tag>()) {
+          code.push(instruction{opcode::call, this->field(*constraint.context_for<field_tag>().ref)}, source);
+        } else if (constraint.is<string_literal_tag>()) {
+          const auto& value = constraint.context_for<string_literal_tag>().value;
+          auto index = this->operand(program_.characters_.size());
+          this->operand(value.size());
+          program_.characters_.append(value);
+          code.push(instruction{opcode::string_literal, index}, source);
+        } else if (constraint.is<int_literal_tag>()) {
+          auto value = static_cast<int64_t>(constraint.context_for<int_literal_tag>().value);
+          code.push(instruction{opcode::int_literal, this->operand(static_cast<uint64_t>(value))}, source);
+        } else if (constraint.is<int64_literal_tag>()) {
+          auto value = constraint.context_for<int64_literal_tag>().value;
+          code.push(instruction{opcode::int64_literal, this->operand(static_cast<uint64_t>(value))}, source);
+        } else if (constraint.is<uint64_literal_tag>()) {
+          auto value = constraint.context_for<uint64_literal_tag>().value;
+          code.push(instruction{opcode::uint64_literal, this->operand(value)}, source);
+        } else if (constraint.is<double_literal_tag>()) {
+          auto value = constraint.context_for<double_literal_tag>().value;
+          code.push(instruction{opcode::double_literal, this->operand(std::bit_cast<uint64_t>(value))}, source);
+        } else if (constraint.is<bool_literal_tag>()) {
+          code.push(instruction{opcode::bool_literal, constraint.context_for<bool_literal_tag>().value}, source);
+        } else if (constraint.is<null_literal_tag>()) {
+          code.push(instruction{opcode::null_literal, 0}, source);
+        } else if (constraint.is<enum_tag>()) {
+          program_.sets_.push_back(&constraint.context_for<enum_tag>());
+          code.push(instruction{opcode::enum_set, static_cast<uint32_t>(program_.sets_.size() - 1)}, source);
+        }
+      }
+
+    private:
+      Program& program_;
+      std::unordered_map<const Field*, uint32_t> fields_;
+      std::unordered_map<const Model*, uint32_t> models_;
+      std::vector<const Model*> pending_;
+
+      uint32_t field(const std::shared_ptr<Field>& field) {
+        if (auto it = fields_.find(field.get()); it != fields_.end()) return it->second;
+        block_code code;
+        for (const auto& constraint : field->properties().constraints) this->emit(constraint, code);
+        auto start = this->append(code);
+        program_.anchors_.push_back(field);
+        fields_.emplace(field.get(), start);
+        return start;
+      }
+
+      uint32_t operand(uint64_t value) {
+        program_.operands_.push_back(value);
+        return static_cast<uint32_t>(program_.operands_.size() - 1);
+      }
+    };
+
+    std::vector<instruction> code_;
+    std::vector<const constraint_context*> sources_;  // the constraint of every instruction, only read on failures.
+    std::vector<uint64_t> operands_;
+    std::vector<const regex_matcher*> matchers_;
+    std::vector<const enum_tag::Context*> sets_;
+    std::vector<model_entry> models_;
+    std::string characters_;
+    std::vector<std::shared_ptr<const void>> anchors_;
+    Constraint constraint_ = Constraint::empty();
+    std::shared_ptr<Model> model_;
+    uint32_t entry_ = 0;
+
+    Program() = default;
+
+    // Every test below takes the trace, it is null unless trace() runs the program and it is
+    // only touched once a test fails.
+
+    template<GARLIC_VIEW Layer>
+    bool run(uint32_t pc, const Layer& layer, FailureTrace* trace) const noexcept {
+      for (auto it = code_.data() + pc; it->code != opcode::pass; ++it) {
+        if (it->code < opcode::any) {
+          if (!this->test_scalar(*it, layer)) return this->fail(it, layer, trace);
+        } else if (!this->test_container(it, layer, trace)) return false;
+      }
+      return true;
+    }
+
+    //! Same as run() but the leading scalar instructions of the block run in the calling loop.
+    template<GARLIC_VIEW Layer>
+    inline bool step(uint32_t pc, const Layer& layer, FailureTrace* trace) const noexcept {
+      auto it = code_.data() + pc;
+      for (; it->code != opcode::pass && it->code < opcode::any; ++it) {
+        if (!this->test_scalar(*it, layer)) return this->fail(it, layer, trace);
+      }
+      return it->code == opcode::pass || this->run(static_cast<uint32_t>(it - code_.data()), layer, trace);
+    }
+
+    //! Instructions that only look at the layer itself, small enough to run inline in every loop.
+    template<GARLIC_VIEW Layer>
+    inline bool test_scalar(instruction item, const Layer& layer) const noexcept {
+      switch (item.code) {
+        case opcode::type: return Program::test_type(layer, static_cast<TypeFlag>(item.operand));
+        case opcode::int_literal:
+          return layer.is_int() && static_cast<int64_t>(operands_[item.operand]) == layer.get_int();
+        case opcode::int64_literal:
+          return garlic::is_int64(layer) && static_cast<int64_t>(operands_[item.operand]) == garlic::get_int64(layer);
+        case opcode::uint64_literal:
+          return garlic::is_uint64(layer) && operands_[item.operand] == garlic::get_uint64(layer);
+        case opcode::double_literal:
+          return layer.is_double() && std::bit_cast<double>(operands_[item.operand]) == layer.get_double();
+        case opcode::bool_literal: return layer.is_bool() && static_cast<bool>(item.operand) == layer.get_bool();
+        case opcode::null_literal: return layer.is_null();
+        default: return this->test_value(item, layer);
+      }
+    }
+
+    //! Scalar instructions that need to look at the value of strings, lists and numbers.
+    template<GARLIC_VIEW Layer>
+    bool test_value(instruction item, const Layer& layer) const noexcept {
+      switch (item.code) {
+        case opcode::range: return Program::test_range(layer, operands_[item.operand], operands_[item.operand + 1]);
+        case opcode::regex: return !layer.is_string() || matchers_[item.operand]->match(layer.get_string_view());
+        case opcode::string_literal: {
+          std::string_view value{characters_.data() + operands_[item.operand], operands_[item.operand + 1]};
+          return layer.is_string() && layer.get_string_view() == value;
+        }
+        case opcode::enum_set: return enum_tag::contains(layer, *sets_[item.operand]);
+        default: return true;
+      }
+    }
+
+    //! Instructions that run other blocks.
+    template<GARLIC_VIEW Layer>
+    bool test_container(const instruction* it, const Layer& layer, FailureTrace* trace) const noexcept {
+      switch (it->code) {
+        case opcode::any: return this->test_any(it, layer, trace);
+        case opcode::list: return this->test_list(it, layer, trace);
+        case opcode::tuple: return this->test_tuple(it, layer, trace);
+        case opcode::map: return this->test_map(it, layer, trace);
+        case opcode::model: return this->test_model(models_[it->operand], layer, trace);
+        case opcode::call: return this->step(it->operand, layer, trace);
+        default: return true;
+      }
+    }
+
+    template<GARLIC_VIEW Layer>
+    static inline bool test_type(const Layer& layer, TypeFlag flag) noexcept {
+      switch (flag) {
+        case TypeFlag::Null: return layer.is_null();
+        case TypeFlag::Boolean: return layer.is_bool();
+        case TypeFlag::Double: return layer.is_double();
+        case TypeFlag::Integer: return layer.is_int();
+        case TypeFlag::Int64: return garlic::is_int64(layer);
+        case TypeFlag::UInt64: return garlic::is_uint64(layer);
+        case TypeFlag::String: return layer.is_string();
+        case TypeFlag::List: return layer.is_list();
+        case TypeFlag::Object: return layer.is_object();
+        default: return false;
+      }
+    }
+
+    template<GARLIC_VIEW Layer>
+    static inline bool test_range(const Layer& layer, range_tag::size_type min, range_tag::size_type max) noexcept {
+      auto type = internal::probe_type(layer);
+      if (type.is_string()) {
+        auto length = layer.get_string_view().size();
+        return !(length > max || length < min);
+      } else if (bool passed; range_tag::test_integer(layer, type, min, max, passed)) {
+        return passed;
+      } else if (type.is_double()) {
+        auto dvalue = layer.get_double();
+        return !(dvalue > max || dvalue < min);
+      } else if (type.is_list()) {
+        auto count = garlic::list_size(layer);
+        return !(count > max || count < min);
+      }
+      return true;
+    }
+
+    template<GARLIC_VIEW Layer>
+    bool test_any(const instruction* it, const Layer& layer, FailureTrace* trace) const noexcept {
+      auto operands = operands_.data() + it->operand;
+      for (uint64_t index = 1; index <= operands[0]; ++index) {
+        if (this->step(operands[index], layer, nullptr)) return true;
+      }
+      return this->fail(it, "None of the constraints read this value.", trace);
+    }
+
+    template<GARLIC_VIEW Layer>
+    bool test_list(const instruction* it, const Layer& layer, FailureTrace* trace) const noexcept {
+      if (!layer.is_list()) return this->fail(it, "Expected a list.", trace);
+      auto pc = it->operand;
+      size_t index = 0;
+      if (auto first = code_.data() + pc; first->code < opcode::any && first[1].code == opcode::pass) {
+        // most lists check their items with a single instruction, it stays in a register for the loop.
+        for (auto item = layer.begin_list(); item != layer.end_list(); ++item, ++index) {
+          if (!this->test_scalar(*first, *item)) {
+            this->fail(first, *item, trace);
+            return this->push(index, trace);
+          }
+        }
+        return true;
+      }
+      for (auto item = layer.begin_list(); item != layer.end_list(); ++item, ++index) {
+        if (!this->step(pc, *item, trace)) return this->push(index, trace);
+      }
+      return true;
+    }
+
+    template<GARLIC_VIEW Layer>
+    bool test_tuple(const instruction* it, const Layer& layer, FailureTrace* trace) const noexcept {
+      if (!layer.is_list()) return this->fail(it, "Expected a list (tuple).", trace);
+      auto operands = operands_.data() + it->operand;
+      auto count = operands[0];
+      auto item = layer.begin_list();
+      uint64_t index = 0;
+      for (; index < count && item != layer.end_list(); ++index, ++item) {
+        if (!this->step(operands[2 + index], *item, trace)) return this->push(index, trace);
+      }
+      if (operands[1] && item != layer.end_list()) return this->fail(it, "Too many values in the tuple.", trace);
+      if (index != count) return this->fail(it, "Too few values in the tuple.", trace);
+      return true;
+    }
+
+    template<GARLIC_VIEW Layer>
+    bool test_map(const instruction* it, const Layer& layer, FailureTrace* trace) const noexcept {
+      if (!layer.is_object()) return this->fail(it, "Expected an object.", trace);
+      auto key = operands_[it->operand];
+      auto value = operands_[it->operand + 1];
+      for (const auto& member : layer.get_object()) {
+        if ((key != none && !this->step(key, member.key, trace)) ||
+            (value != none && !this->step(value, member.value, trace))) {
+          return this->push(member.key.get_string_view(), trace);
+        }
+      }
+      return true;
+    }
+
+    template<GARLIC_VIEW Layer>
+    bool test_model(const model_entry& entry, const Layer& layer, FailureTrace* trace) const noexcept {
+      if (!layer.is_object()) {
+        if (trace) trace->fail(entry.model, "Expected object.");
+        return false;
+      }
+      internal::field_set matched(entry.fields.size());
+      for (const auto& member : layer.get_object()) {
+        auto key = member.key.get_string_view();
+        auto position = entry.fields.find_position(key);
+        if (position == entry.fields.npos) continue;
+        if (!this->step(entry.fields.value(position), member.value, trace)) return this->push(key, trace);
+        matched.set(position);
+      }
+      if (matched.covers(entry.required)) return true;
+      if (trace) {
+        matched.for_each_missing(entry.required, [&entry, trace](size_t position) {
+            if (trace->failed()) return;
+            trace->fail(entry.model, "missing required field!");
+            trace->push(entry.fields.key(position));
+            });
+      }
+      return false;
+    }
+
+    //! Records a failed scalar instruction. @return false
+    template<GARLIC_VIEW Layer>
+    inline bool fail(const instruction* it, const Layer& layer, FailureTrace* trace) const noexcept {
+      if (trace) trace->fail(sources_[it - code_.data()], this->scalar_reason(*it, layer));
+      return false;
+    }
+
+    //! Records a failed container instruction. @return false
+    inline bool fail(const instruction* it, const char* reason, FailureTrace* trace) const noexcept {
+      if (trace) trace->fail(sources_[it - code_.data()], reason);
+      return false;
+    }
+
+    //! Adds a segment to the path of a failure found deeper in the layer. @return false
+    template<typename Segment>
+    static inline bool push(Segment segment, FailureTrace* trace) noexcept {
+      if (trace) trace->push(segment);
+      return false;
+    }
+
+    //! @return the same reason the constraint tag would fail a scalar instruction with.
+    template<GARLIC_VIEW Layer>
+    inline const char* scalar_reason(instruction item, const Layer& layer) const noexcept {
+      switch (item.code) {
+        case opcode::type:
+          switch (static_cast<TypeFlag>(item.operand)) {
+            case TypeFlag::Null: return "Expected null.";
+            case TypeFlag::Boolean: return "Expected boolean type.";
+            case TypeFlag::Double: return "Expected double type.";
+            case TypeFlag::Integer: return "Expected integer type.";
+            case TypeFlag::Int64: return "Expected a 64 bit integer.";
+            case TypeFlag::UInt64: return "Expected an unsigned 64 bit integer.";
+            case TypeFlag::String: return "Expected string type.";
+            case TypeFlag::List: return "Expected a list.";
+            case TypeFlag::Object: return "Expected an object.";
+            default: return nullptr;
+          }
+        case opcode::range:
+          if (layer.is_string()) return "invalid string length.";
+          if (layer.is_list()) {
+            range_tag::Context bounds(operands_[item.operand], operands_[item.operand + 1]);
+            return range_tag::list_size_failure(garlic::list_size(layer), bounds);
+          }
+          return "out of range value.";
+        default: return "invalid value.";
+      }
+    }
+  };
+
+}
+
+#endif /* end of include guard: GARLIC_PROGRAM_H */
@@ -0,0 +1,603 @@
+#ifndef GARLIC_REGEX_H
+#define GARLIC_REGEX_H
+
+/*! @file regex.h
+ *  @brief A regular expression matcher that runs patterns as a lazily built DFA.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace garlic {
+
+  namespace internal {
+
+    using regex_byte_set = std::bitset<256>;
+
+    struct regex_node {
+      enum kind_type : uint8_t { empty, bytes, concat, alternate, repeat };
+
+      static constexpr uint32_t unbounded = UINT32_MAX;
+
+      kind_type kind = empty;
+      uint32_t set = 0;  // index of the byte set for bytes nodes.
+      uint32_t min = 0;
+      uint32_t max = 0;
+      std::vector<regex_node> children;
+    };
+
+    //! Parses the subset of the ECMAScript syntax the automaton supports.
+    /*! parse() fails for anything outside the subset as well as malformed patterns,
+     *  leaving it to std::regex to either run them or report the error.
+     */
+    class regex_parser {
+    public:
+      static constexpr size_t max_depth = 128;
+      static constexpr uint32_t max_repeat = 1000;
+
+      explicit regex_parser(std::string_view pattern) : pattern_(pattern), end_(pattern.size()) {}
+
+      bool parse(regex_node& root) {
+        // the whole input is always matched so anchors at either end of the pattern do nothing.
+        if (end_ && pattern_.front() == '^') position_ = 1;
+        if (end_ > position_ && pattern_[end_ - 1] == '$' && !this->is_escaped(end_ - 1)) --end_;
+        if (!this->parse_alternation(root, 0)) return false;
+        return position_ == end_;
+      }
+
+      std::vector<regex_byte_set>& sets() noexcept { return sets_; }
+
+    private:
+      std::string_view pattern_;
+      size_t position_ = 0;
+      size_t end_;
+      std::vector<regex_byte_set> sets_;
+
+      inline bool done() const noexcept { return position_ >= end_; }
+      inline char peek() const noexcept { return pattern_[position_]; }
+
+      inline bool is_escaped(size_t position) const noexcept {
+        size_t count = 0;
+        while (position > count && pattern_[position - count - 1] == '\\') ++count;
+        return count % 2;
+      }
+
+      inline void add_bytes(regex_node& node, const regex_byte_set& set) {
+        node.kind = regex_node::bytes;
+        node.set = sets_.size();
+        sets_.push_back(set);
+      }
+
+      bool parse_alternation(regex_node& node, size_t depth) {
+        if (depth > max_depth) return false;
+        regex_node branch;
+        if (!this->parse_sequence(branch, depth)) return false;
+        if (done() || peek() != '|') {
+          node = std::move(branch);
+          return true;
+        }
+        node.kind = regex_node::alternate;
+        node.children.push_back(std::move(branch));
+        while (!done() && peek() == '|') {
+          ++position_;
+          regex_node next;
+          if (!this->parse_sequence(next, depth)) return false;
+          node.children.push_back(std::move(next));
+        }
+        return true;
+      }
+
+      bool parse_sequence(regex_node& node, size_t depth) {
+        node.kind = regex_node::concat;
+        while (!done() && peek() != '|') {
+          if (peek() == ')') {
+            if (!depth) return false;
+            break;
+          }
+          regex_node atom;
+          if (!this->parse_atom(atom, depth)) return false;
+          if (!this->parse_quantifier(atom)) return false;
+          node.children.push_back(std::move(atom));
+        }
+        if (node.children.empty()) node.kind = regex_node::empty;
+        else if (node.children.size() == 1) node = regex_node(std::move(node.children.front()));
+        return true;
+      }
+
+      bool parse_atom(regex_node& node, size_t depth) {
+        auto c = pattern_[position_++];
+        regex_byte_set set;
+        switch (c) {
+          case '(':
+            if (!done() && peek() == '?') {
+              if (position_ + 1 >= end_ || pattern_[position_ + 1] != ':') return false;
+              position_ += 2;
+            }
+            if (!this->parse_alternation(node, depth + 1)) return false;
+            if (done() || peek() != ')') return false;
+            ++position_;
+            return true;
+          case '[':
+            if (!this->parse_class(set)) return false;
+            break;
+          case '.':
+            set.set();
+            set.reset('\n');
+            set.reset('\r');
+            break;
+          case '\\':
+            if (!this->parse_escape(set)) return false;
+            break;
+          case '*': case '+': case '?': case '{': case '}': case ']': case '^': case '$':
+            return false;
+          default:
+            set.set(static_cast<uint8_t>(c));
+        }
+        this->add_bytes(node, set);
+        return true;
+      }
+
+      bool parse_quantifier(regex_node& atom) {
+        if (done()) return true;
+        uint32_t min, max;
+        switch (peek()) {
+          case '*': min = 0; max = regex_node::unbounded; ++position_; break;
+          case '+': min = 1; max = regex_node::unbounded; ++position_; break;
+          case '?': min = 0; max = 1; ++position_; break;
+          case '{':
+            ++position_;
+            if (!this->parse_count(min)) return false;
+            max = min;
+            if (!done() && peek() == ',') {
+              ++position_;
+              max = regex_node::unbounded;
+              if (!done() && peek() != '}' && !this->parse_count(max)) return false;
+            }
+            if (done() || peek() != '}' || max < min) return false;
+            ++position_;
+            break;
+          default:
+            return true;
+        }
+        // lazy quantifiers only change which match is reported, whole input matches stay the same.
+        if (!done() && peek() == '?') ++position_;
+        if (!done() && (peek() == '*' || peek() == '+' || peek() == '?' || peek() == '{')) return false;
+
+        regex_node node;
+        node.kind = regex_node::repeat;
+        node.min = min;
+        node.max = max;
+        node.children.push_back(std::move(atom));
+        atom = std::move(node);
+        return true;
+      }
+
+      bool parse_count(uint32_t& count) {
+        if (done() || peek() < '0' || peek() > '9') return false;
+        count = 0;
+        while (!done() && peek() >= '0' && peek() <= '9') {
+          count = count * 10 + (peek() - '0');
+          if (count > max_repeat) return false;
+          ++position_;
+        }
+        return true;
+      }
+
+      static inline bool is_word(int c) noexcept {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+      }
+
+      static inline int hex_value(char c) noexcept {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+      }
+
+      //! Parses the escape after a backslash, is_single tells whether it stands for a single byte.
+      bool parse_escape(regex_byte_set& set, bool* is_single = nullptr) {
+        if (done()) return false;
+        auto c = pattern_[position_++];
+        if (is_single) *is_single = false;
+        switch (c) {
+          case 'd': case 'D':
+            for (int b = '0'; b <= '9'; ++b) set.set(b);
+            if (c == 'D') set.flip();
+            return true;
+          case 'w': case 'W':
+            for (int b = 0; b < 256; ++b) if (is_word(b)) set.set(b);
+            if (c == 'W') set.flip();
+            return true;
+          case 's': case 'S':
+            for (auto b : {' ', '\t', '\n', '\v', '\f', '\r'}) set.set(static_cast<uint8_t>(b));
+            if (c == 'S') set.flip();
+            return true;
+          case 't': c = '\t'; break;
+          case 'n': c = '\n'; break;
+          case 'r': c = '\r'; break;
+          case 'f': c = '\f'; break;
+          case 'v': c = '\v'; break;
+          case 'x': {
+            if (position_ + 2 > end_) return false;
+            auto high = hex_value(pattern_[position_]), low = hex_value(pattern_[position_ + 1]);
+            if (high < 0 || low < 0) return false;
+            position_ += 2;
+            c = static_cast<char>(high * 16 + low);
+            break;
+          }
+          default:
+            // back references, word boundaries, control and unicode escapes are left to std::regex.
+            if (is_word(static_cast<uint8_t>(c)) || static_cast<uint8_t>(c) >= 0x80) return false;
+        }
+        if (is_single) *is_single = true;
+        set.set(static_cast<uint8_t>(c));
+        return true;
+      }
+
+      //! Reads a single byte inside a class, fails on class escapes and non-ascii bytes.
+      bool parse_class_byte(uint8_t& byte) {
+        if (done()) return false;
+        if (peek() == '\\') {
+          ++position_;
+          regex_byte_set set;
+          bool is_single;
+          if (!this->parse_escape(set, &is_single) || !is_single) return false;
+          for (unsigned b = 0; b < 256; ++b) {
+            if (set[b]) byte = static_cast<uint8_t>(b);
+          }
+          return true;
+        }
+        byte = static_cast<uint8_t>(pattern_[position_++]);
+        return byte < 0x80;
+      }
+
+      bool parse_class(regex_byte_set& set) {
+        bool negate = false;
+        if (!done() && peek() == '^') {
+          negate = true;
+          ++position_;
+        }
+        if (!done() && peek() == ']') return false;
+        while (!done() && peek() != ']') {
+          if (peek() == '[' && position_ + 1 < end_) {
+            auto next = pattern_[position_ + 1];
+            if (next == ':' || next == '.' || next == '=') return false;
+          }
+          if (peek() == '\\' && position_ + 1 < end_) {
+            auto next = pattern_[position_ + 1];
+            if (next == 'd' || next == 'D' || next == 'w' || next == 'W' || next == 's' || next == 'S') {
+              position_ += 1;
+              regex_byte_set escape;
+              if (!this->parse_escape(escape)) return false;
+              set |= escape;
+              if (position_ + 1 < end_ && peek() == '-' && pattern_[position_ + 1] != ']') return false;
+              continue;
+            }
+          }
+          uint8_t low, high;
+          if (!this->parse_class_byte(low)) return false;
+          high = low;
+          if (position_ + 1 < end_ && peek() == '-' && pattern_[position_ + 1] != ']') {
+            ++position_;
+            if (!this->parse_class_byte(high) || high < low) return false;
+          }
+          for (unsigned b = low; b <= high; ++b) set.set(b);
+        }
+        if (done()) return false;
+        ++position_;
+        if (negate) set.flip();
+        return true;
+      }
+    };
+
+    //! Thompson NFA of a parsed pattern along with the DFA states built from it so far.
+    class regex_automaton {
+    public:
+      static constexpr size_t max_nfa_states = 1 << 15;
+      static constexpr size_t max_dfa_states = 4096;
+
+      //! @return false if the pattern expands to too many states.
+      bool build(const regex_node& root, std::vector<regex_byte_set>&& sets) {
+        sets_ = std::move(sets);
+        match_ = this->add_state(nfa_state::match, 0, 0, 0);
+        auto start = this->compile(root, match_);
+        if (nfa_.size() > max_nfa_states) return false;
+        this->build_byte_classes();
+
+        std::vector<uint32_t> closure;
+        std::vector<bool> seen(nfa_.size());
+        this->add_closure(start, closure, seen);
+        std::sort(closure.begin(), closure.end());
+        dead_ = this->add_dfa_state({});
+        start_ = this->add_dfa_state(std::move(closure));
+        return true;
+      }
+
+      bool match(std::string_view input) const {
+        const dfa_state* state = start_;
+        for (size_t index = 0; index < input.size(); ++index) {
+          auto byte_class = byte_classes_[static_cast<uint8_t>(input[index])];
+          auto next = state->next[byte_class].load(std::memory_order_acquire);
+          if (!next) {
+            next = this->transition(state, byte_class);
+            if (!next) return this->simulate(state->nfa, input.substr(index));
+          }
+          if (next == dead_) return false;
+          state = next;
+        }
+        return state->accepting;
+      }
+
+    private:
+      struct nfa_state {
+        enum kind_type : uint8_t { consume, split, match };
+
+        kind_type kind;
+        uint32_t set;
+        uint32_t out;
+        uint32_t alt;
+      };
+
+      struct dfa_state {
+        std::vector<uint32_t> nfa;  // sorted consuming and matching states.
+        bool accepting;
+        std::unique_ptr<std::atomic<const dfa_state*>[]> next;
+      };
+
+      std::vector<nfa_state> nfa_;
+      std::vector<regex_byte_set> sets_;
+      uint32_t match_;
+
+      uint8_t byte_classes_[256];
+      std::vector<uint8_t> representatives_;
+
+      mutable std::mutex mutex_;
+      mutable std::vector<std::unique_ptr<dfa_state>> states_;
+      mutable std::map<std::vector<uint32_t>, const dfa_state*> state_index_;
+      const dfa_state* start_;
+      const dfa_state* dead_;
+
+      inline uint32_t add_state(nfa_state::kind_type kind, uint32_t set, uint32_t out, uint32_t alt) {
+        nfa_.push_back(nfa_state{kind, set, out, alt});
+        return nfa_.size() - 1;
+      }
+
+      //! Compiles the node so that it continues to next and returns its first state.
+      uint32_t compile(const regex_node& node, uint32_t next) {
+        if (nfa_.size() > max_nfa_states) return next;
+        switch (node.kind) {
+          case regex_node::empty:
+            return next;
+          case regex_node::bytes:
+            return this->add_state(nfa_state::consume, node.set, next, 0);
+          case regex_node::concat:
+            for (auto it = node.children.rbegin(); it != node.children.rend(); ++it) {
+              next = this->compile(*it, next);
+            }
+            return next;
+          case regex_node::alternate: {
+            auto start = this->compile(node.children.back(), next);
+            for (auto it = std::next(node.children.rbegin()); it != node.children.rend(); ++it) {
+              start = this->add_state(nfa_state::split, 0, this->compile(*it, next), start);
+            }
+            return start;
+          }
+          case regex_node::repeat: {
+            const auto& child = node.children.front();
+            auto start = next;
+            if (node.max == regex_node::unbounded) {
+              start = this->add_state(nfa_state::split, 0, 0, next);
+              auto body = this->compile(child, start);
+              nfa_[start].out = body;
+            } else {
+              for (auto count = node.min; count < node.max && nfa_.size() <= max_nfa_states; ++count) {
+                start = this->add_state(nfa_state::split, 0, this->compile(child, start), next);
+              }
+            }
+            for (uint32_t count = 0; count < node.min && nfa_.size() <= max_nfa_states; ++count) {
+              start = this->compile(child, start);
+            }
+            return start;
+          }
+        }
+        return next;
+      }
+
+      //! Splits the bytes into classes that every byte set in the pattern treats the same.
+      void build_byte_classes() {
+        uint16_t ids[256] = {};
+        size_t count = 1;
+        std::vector<int> remap;
+        for (const auto& set : sets_) {
+          remap.assign(count * 2, -1);
+          size_t next_count = 0;
+          for (int byte = 0; byte < 256; ++byte) {
+            auto& id = remap[ids[byte] * 2 + set[byte]];
+            if (id < 0) id = next_count++;
+            ids[byte] = id;
+          }
+          count = next_count;
+        }
+        representatives_.assign(count, 0);
+        for (int byte = 255; byte >= 0; --byte) {
+          byte_classes_[byte] = ids[byte];
+          representatives_[ids[byte]] = byte;
+        }
+      }
+
+      void add_closure(uint32_t state, std::vector<uint32_t>& closure, std::vector<bool>& seen) const {
+        std::vector<uint32_t> stack{state};
+        while (!stack.empty()) {
+          auto index = stack.back();
+          stack.pop_back();
+          if (seen[index]) continue;
+          seen[index] = true;
+          const auto& item = nfa_[index];
+          if (item.kind == nfa_state::split) {
+            stack.push_back(item.alt);
+            stack.push_back(item.out);
+          } else {
+            closure.push_back(index);
+          }
+        }
+      }
+
+      std::vector<uint32_t> step(const std::vector<uint32_t>& from, uint8_t byte) const {
+        std::vector<uint32_t> closure;
+        std::vector<bool> seen(nfa_.size());
+        for (auto index : from) {
+          const auto& item = nfa_[index];
+          if (item.kind == nfa_state::consume && sets_[item.set][byte]) {
+            this->add_closure(item.out, closure, seen);
+          }
+        }
+        std::sort(closure.begin(), closure.end());
+        return closure;
+      }
+
+      const dfa_state* add_dfa_state(std::vector<uint32_t>&& nfa) const {
+        auto state = std::make_unique<dfa_state>();
+        state->accepting = std::binary_search(nfa.begin(), nfa.end(), match_);
+        state->next = std::make_unique<std::atomic<const dfa_state*>[]>(representatives_.size());
+        state->nfa = std::move(nfa);
+        const dfa_state* result = state.get();
+        if (result->nfa.empty()) {
+          for (size_t index = 0; index < representatives_.size(); ++index) state->next[index] = result;
+        }
+        state_index_.emplace(result->nfa, result);
+        states_.push_back(std::move(state));
+        return result;
+      }
+
+      //! @return the next state, or nullptr if the cache is full and it can not be added.
+      const dfa_state* transition(const dfa_state* state, uint8_t byte_class) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (auto next = state->next[byte_class].load(std::memory_order_acquire); next) return next;
+        auto nfa = this->step(state->nfa, representatives_[byte_class]);
+        const dfa_state* next;
+        if (auto it = state_index_.find(nfa); it != state_index_.end()) {
+          next = it->second;
+        } else {
+          if (states_.size() >= max_dfa_states) return nullptr;
+          next = this->add_dfa_state(std::move(nfa));
+        }
+        state->next[byte_class].store(next, std::memory_order_release);
+        return next;
+      }
+
+      //! Runs the rest of the input on the NFA directly once the DFA cache is full.
+      bool simulate(std::vector<uint32_t> current, std::string_view input) const {
+        for (auto c : input) {
+          current = this->step(current, static_cast<uint8_t>(c));
+          if (current.empty()) return false;
+        }
+        return std::binary_search(current.begin(), current.end(), match_);
+      }
+    };
+
+  }
+
+  //! Matches whole strings against a regular expression, the same way std::regex_match does.
+  /*! Patterns made of literals, `.`, character classes, the `\d \w \s` escapes, greedy or lazy
+   *  quantifiers, groups, alternation and anchors at either end are compiled to an NFA whose DFA
+   *  states are built on demand while matching. Once the states an input visits exist, every byte
+   *  costs a single table read, no matter how the pattern is written. Bytes that no part of the
+   *  pattern tells apart share a byte class to keep the transition tables small.
+   *
+   *  Everything else (back references, lookarounds, word boundaries, ...) as well as patterns that
+   *  expand to too many states falls back to std::regex with the ECMAScript grammar.
+   *
+   *  @note match() can be called from several threads at the same time.
+   *
+   *  @code
+   *  regex_matcher matcher("\\d{3}-\\w+");
+   *  matcher.match("123-abc");  // true
+   *  matcher.match("12-abc");  // false
+   *  @endcode
+   */
+  class regex_matcher {
+  public:
+    //! Tag to defer compiling the pattern until its first match.
+    struct deferred_t { explicit deferred_t() = default; };
+    static constexpr deferred_t deferred{};
+
+    //! @throws std::regex_error if the pattern is invalid.
+    explicit regex_matcher(std::string_view pattern) : pattern_(pattern) { compile(); }
+
+    //! Stores the pattern and compiles it on the first match, from whichever thread gets there first.
+    /*! @note A pattern that turns out to be invalid never matches instead of throwing.
+     */
+    regex_matcher(std::string_view pattern, deferred_t)
+      : pattern_(pattern), once_(std::make_unique<std::once_flag>()) {}
+
+    regex_matcher(const regex_matcher& other) : regex_matcher(other.copy()) {}
+    regex_matcher(regex_matcher&& other) noexcept = default;
+
+    regex_matcher& operator = (const regex_matcher& other) {
+      if (this != &other) *this = other.copy();
+      return *this;
+    }
+
+    regex_matcher& operator = (regex_matcher&& other) noexcept = default;
+
+    //! @return whether or not the whole input matches the pattern.
+    bool match(std::string_view input) const {
+      this->ensure_compiled();
+      if (automaton_) return automaton_->match(input);
+      if (fallback_) return std::regex_match(input.begin(), input.end(), *fallback_);
+      return false;
+    }
+
+    //! @return whether or not the pattern runs on the DFA rather than std::regex.
+    bool is_automaton() const {
+      this->ensure_compiled();
+      return automaton_ != nullptr;
+    }
+
+    const std::string& pattern() const noexcept { return pattern_; }
+
+  private:
+    regex_matcher copy() const {
+      if (once_) return regex_matcher(pattern_, deferred);
+      return regex_matcher(pattern_);
+    }
+
+    void ensure_compiled() const {
+      if (once_) std::call_once(*once_, &regex_matcher::compile_deferred, const_cast<regex_matcher*>(this));
+    }
+
+    void compile() {
+      internal::regex_parser parser(pattern_);
+      internal::regex_node root;
+      if (parser.parse(root)) {
+        auto automaton = std::make_unique<internal::regex_automaton>();
+        if (automaton->build(root, std::move(parser.sets()))) {
+          automaton_ = std::move(automaton);
+          return;
+        }
+      }
+      fallback_ = std::make_unique<std::regex>(pattern_);
+    }
+
+    void compile_deferred() noexcept {
+      try { compile(); } catch (const std::regex_error&) {}
+    }
+
+    std::string pattern_;
+    std::unique_ptr<std::once_flag> once_;
+    std::unique_ptr<internal::regex_automaton> automaton_;
+    std::unique_ptr<std::regex> fallback_;
+  };
+
+}
+
+#endif /* end of include guard: GARLIC_REGEX_H */
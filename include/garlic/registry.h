@@ -0,0 +1,208 @@
+#ifndef GARLIC_REGISTRY_H
+#define GARLIC_REGISTRY_H
+
+/*! @file registry.h
+ *  @brief Publishing modules to threads that validate against them while they get replaced.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "module.h"
+
+namespace garlic {
+
+  namespace internal {
+    //! The epoch a thread entered its snapshot at, zero while the thread is not reading.
+    struct alignas(64) registry_slot {
+      std::atomic<uint64_t> epoch = 0;
+      std::atomic<bool> used = false;
+    };
+
+    //! Slots of the threads reading from a registry, they outlive the registry as long as a thread holds one.
+    struct registry_slots {
+      std::mutex mutex;
+      std::vector<std::unique_ptr<registry_slot>> slots;
+
+      registry_slot* acquire() {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& slot : slots) {
+          if (bool used = false; slot->used.compare_exchange_strong(used, true)) return slot.get();
+        }
+        slots.push_back(std::make_unique<registry_slot>());
+        slots.back()->used = true;
+        return slots.back().get();
+      }
+    };
+
+    //! The slot a thread holds in a registry, given back when the thread exits.
+    /*! The slots are only referred to weakly, they go away with the registry and its readers with them. */
+    struct registry_reader {
+      uint64_t registry;
+      std::weak_ptr<registry_slots> owner;
+      registry_slot* slot;
+      unsigned depth = 0;
+
+      registry_reader(uint64_t registry, const std::shared_ptr<registry_slots>& owner
+          ) : registry(registry), owner(owner), slot(owner->acquire()) {}
+      registry_reader(const registry_reader&) = delete;
+      ~registry_reader() {
+        if (auto slots = owner.lock(); slots) slot->used.store(false);
+      }
+    };
+
+    // a list keeps the readers in place for the snapshots that refer to them while others are erased.
+    inline thread_local std::list<registry_reader> registry_readers;
+  }
+
+  //! Publishes immutable snapshots of a Module to threads that keep validating while it gets replaced.
+  /*! Readers pin the current snapshot with read(), which costs a store to a slot of their own and
+   *  a load of the published pointer, no lock and no shared reference count. publish() swaps in
+   *  a new snapshot and retires the old one, which is deleted once every thread that could still
+   *  be reading it has left its snapshot. Retired snapshots are reclaimed by publish() and
+   *  reclaim(), readers never do any of that work.
+   *
+   *  @code
+   *  ModuleRegistry registry;
+   *  registry.publish(load_module());
+   *
+   *  // request threads.
+   *  if (auto module = registry.read(); module) {
+   *    auto model = module->get_model("User");
+   *    model->validate(document);
+   *  }
+   *
+   *  // a reloading thread, readers are never blocked.
+   *  registry.publish(load_module());
+   *  @endcode
+   *
+   *  @note A snapshot must not be held across a call to publish() on the same thread, since
+   *        its module could only be reclaimed after the snapshot is gone.
+   *  @note Models and fields held through a shared pointer outlive the snapshot they came from.
+   */
+  class ModuleRegistry {
+  public:
+    //! Pins the snapshot that was current when it was made, for as long as it lives.
+    class snapshot {
+    public:
+      snapshot(const snapshot&) = delete;
+      snapshot& operator = (const snapshot&) = delete;
+      ~snapshot() {
+        if (--reader_.depth == 0) reader_.slot->epoch.store(0, std::memory_order_release);
+      }
+
+      //! @return whether or not a module was published before the snapshot was made.
+      explicit operator bool () const noexcept { return module_ != nullptr; }
+
+      const Module& operator * () const noexcept { return *module_; }
+      const Module* operator -> () const noexcept { return module_; }
+      const Module* get() const noexcept { return module_; }
+
+    private:
+      friend class ModuleRegistry;
+
+      internal::registry_reader& reader_;
+      const Module* module_;
+
+      snapshot(internal::registry_reader& reader, const Module* module) : reader_(reader), module_(module) {}
+    };
+
+    ModuleRegistry() : id_(next_id()), slots_(std::make_shared<internal::registry_slots>()) {}
+    ModuleRegistry(const ModuleRegistry&) = delete;
+
+    //! Deletes every snapshot, no thread may be reading from the registry anymore.
+    ~ModuleRegistry() {
+      delete current_.load();
+      for (auto& item : retired_) delete item.module;
+    }
+
+    //! @return a snapshot of the last published module. Snapshots can be nested on a thread.
+    snapshot read() const {
+      auto& reader = this->reader();
+      if (reader.depth++ == 0) {
+        // the store has to be visible before the load of the module, and the epoch has to be
+        // read with acquire so the module it was bumped after is visible too, see reclaim().
+        reader.slot->epoch.store(epoch_.load(std::memory_order_acquire));
+      }
+      return snapshot(reader, current_.load());
+    }
+
+    //! Freezes the models of the module, makes it the current snapshot and reclaims what it can.
+    /*! @note Models that are already published have to stay frozen, they are not frozen again. */
+    void publish(Module&& module) {
+      for (auto it = module.begin_models(); it != module.end_models(); ++it) {
+        if (!it->second->frozen()) it->second->freeze();
+      }
+      auto published = new Module(std::move(module));
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (auto old = current_.exchange(published); old) retired_.push_back(retired{old, epoch_.fetch_add(1)});
+      this->reclaim_retired();
+    }
+
+    //! Deletes the retired snapshots no thread can be reading anymore. @return how many are left.
+    size_t reclaim() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      this->reclaim_retired();
+      return retired_.size();
+    }
+
+  private:
+    struct retired {
+      const Module* module;
+      uint64_t epoch;  // the epoch the module was replaced in.
+    };
+
+    uint64_t id_;
+    std::shared_ptr<internal::registry_slots> slots_;
+    std::atomic<const Module*> current_ = nullptr;
+    std::atomic<uint64_t> epoch_ = 1;
+    std::mutex mutex_;
+    std::vector<retired> retired_;
+
+    static uint64_t next_id() noexcept {
+      static std::atomic<uint64_t> counter = 0;
+      return ++counter;
+    }
+
+    // Readers of registries that are gone are dropped on the way, no snapshot can refer to them.
+    internal::registry_reader& reader() const {
+      auto& readers = internal::registry_readers;
+      for (auto it = readers.begin(); it != readers.end();) {
+        if (it->registry == id_) return *it;
+        if (it->owner.expired()) it = readers.erase(it);
+        else ++it;
+      }
+      return readers.emplace_back(id_, slots_);
+    }
+
+    // A reader that loaded a module replaced in epoch E entered at an epoch no later than E, since
+    // it read the epoch before the module and the epoch only moves on after the module is replaced:
+    // an acquire load of a later epoch makes the exchange that came before the bump visible.
+    // Its slot is visible to this scan unless the reader stored it after the scan, in which case
+    // it loads a module newer than every retired one. So a retired module can go once every
+    // reading thread entered after the epoch it was replaced in.
+    void reclaim_retired() {
+      auto oldest = UINT64_MAX;
+      {
+        std::lock_guard<std::mutex> lock(slots_->mutex);
+        for (const auto& slot : slots_->slots) {
+          if (auto epoch = slot->epoch.load(); epoch && epoch < oldest) oldest = epoch;
+        }
+      }
+      auto end = std::remove_if(retired_.begin(), retired_.end(), [oldest](const retired& item) {
+          if (item.epoch >= oldest) return false;
+          delete item.module;
+          return true;
+          });
+      retired_.erase(end, retired_.end());
+    }
+  };
+
+}
+
+#endif /* end of include guard: GARLIC_REGISTRY_H */
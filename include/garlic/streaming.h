@@ -0,0 +1,668 @@
+#ifndef GARLIC_STREAMING_H
+#define GARLIC_STREAMING_H
+
+/*! @file streaming.h
+ *  @brief Validation of documents while they are being read, without loading them first.
+ */
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "clove.h"
+#include "constraints.h"
+
+namespace garlic {
+
+  //! Validates a document from the events of a reader without ever building the document.
+  /*! Readers report the document in order: scalars with null(), boolean(), integer(), real()
+   *  and string(), containers with begin_list()/end_list() and begin_object()/end_object(),
+   *  and the key of every member with key() right before its value.
+   *
+   *  Scalars are tested as soon as they arrive. Constraints that look inside lists and objects
+   *  (list, tuple, map, range on lists, models, fields and the all/any groups) become small tasks
+   *  that collect the results of the items as they complete, so the only state kept is a stack
+   *  of the open containers and the tasks waiting on them. The final result() is the same as
+   *  Model::validate() or Constraint::test() on the loaded document.
+   *
+   *  @note string() and key() expect the text to be followed by a null character, which both
+   *        rapidjson and libyaml guarantee.
+   *
+   *  @code
+   *  StreamValidator validator(module.get_model("User"));
+   *  validator.begin_object();
+   *  validator.key("name");
+   *  validator.string("garlic");
+   *  validator.end_object();
+   *  validator.result().is_valid();
+   *  @endcode
+   */
+  class StreamValidator {
+  public:
+    using model_pointer = std::shared_ptr<Model>;
+
+    //! Validates the stream the same way Model::validate() does.
+    explicit StreamValidator(model_pointer model) : model_(std::move(model)), constraint_(Constraint::empty()) {
+      targets_.push_back(target{target::of_model, false, no_parent, 0, nullptr, model_.get(), nullptr, {}});
+    }
+
+    //! Validates the stream the same way Constraint::test() does.
+    explicit StreamValidator(Constraint constraint) : constraint_(std::move(constraint)) {
+      targets_.push_back(target{target::of_constraint, false, no_parent, 0, &constraint_, nullptr, nullptr, {}});
+    }
+
+    StreamValidator(const StreamValidator&) = delete;
+    StreamValidator& operator = (const StreamValidator&) = delete;
+
+    void null() { this->scalar(DataType{}); }
+
+    void boolean(bool value) {
+      DataType data;
+      data.type = TypeFlag::Boolean;
+      data.boolean = value;
+      this->scalar(data);
+    }
+
+    void integer(int value) { this->integer(static_cast<int64_t>(value)); }
+
+    //! Reported with the same types clove stores the value with.
+    void integer(int64_t value) {
+      DataType data;
+      data.type = DataType::integer_type(value);
+      data.integer = value;
+      this->scalar(data);
+    }
+
+    void integer(uint64_t value) {
+      if (value <= INT64_MAX) return this->integer(static_cast<int64_t>(value));
+      DataType data;
+      data.type = static_cast<TypeFlag>(TypeFlag::UInt64 | TypeFlag::Double);
+      data.integer = static_cast<int64_t>(value);
+      this->scalar(data);
+    }
+
+    void real(double value) {
+      DataType data;
+      data.type = TypeFlag::Double;
+      data.dvalue = value;
+      this->scalar(data);
+    }
+
+    void string(std::string_view value) { this->scalar(string_data(value)); }
+
+    void key(std::string_view key) {
+      auto& frame = frames_[depth_ - 1];
+      frame.key.assign(key);
+      this->collect_targets(frame, frame.index++);
+    }
+
+    void begin_list() { this->begin_container(TypeFlag::List); }
+    void end_list() { this->end_container(); }
+    void begin_object() { this->begin_container(TypeFlag::Object); }
+    void end_object() { this->end_container(); }
+
+    //! @return whether or not the whole document has been read.
+    bool done() const noexcept { return result_.has_value(); }
+
+    //! @return the result of the validation, only available once done() is true.
+    const ConstraintResult& result() const noexcept { return *result_; }
+
+    //! @copydoc result()
+    ConstraintResult& result() noexcept { return *result_; }
+
+  private:
+    using DataType = GenericData<CAllocator>;
+    using View = GenericCloveView<CAllocator>;
+
+    static constexpr uint32_t no_parent = UINT32_MAX;
+
+    //! A value that is about to be read and has to be tested against something.
+    struct target {
+      enum kind_type : uint8_t { of_constraint, of_model, of_member };
+
+      kind_type kind;
+      bool quick;  // only whether or not it passes is needed.
+      uint32_t parent;  // the task waiting on the result.
+      size_t slot;  // position of the result in the parent task.
+      const Constraint* constraint;
+      const Model* model;
+      const Field* field;  // the field of a model member.
+      std::string_view key;  // the key of a model member.
+    };
+
+    enum class task_kind : uint8_t {
+      list, tuple, map, range, model,  // follow the items of a container.
+      all, any, field, member,  // run a number of constraints on the same value.
+    };
+
+    //! How a group of constraints on the same value turns into a single result.
+    enum class group_mode : uint8_t {
+      all,  // passes if every constraint passes the quick test.
+      any,  // passes if one constraint passes the quick test.
+      first_failure,  // reports the first failing constraint.
+      collect,  // reports every failure up to the first fatal one.
+    };
+
+    struct task {
+      task_kind kind;
+      group_mode mode;
+      bool quick;
+      bool settled;  // the outcome is known, items no longer matter.
+      bool any_passed;
+      bool any_failed;
+      uint32_t parent;
+      size_t slot;
+      size_t pending;  // number of constraints in a group still waiting for a result.
+      const Constraint* constraint;
+      const Model* model;
+      const Field* field;
+      const sequence<Constraint>* constraints;
+      std::string key;
+      std::optional<ConstraintResult> failure;
+      std::vector<std::pair<size_t, ConstraintResult>> failures;
+      std::vector<ConstraintResult> details;
+      std::vector<uint64_t> seen;
+      std::unordered_set<const text*> seen_keys;
+    };
+
+    struct frame {
+      bool is_object;
+      size_t index;
+      std::string key;
+      std::vector<uint32_t> tasks;
+    };
+
+    model_pointer model_;
+    Constraint constraint_;
+    std::optional<ConstraintResult> result_;
+    std::vector<target> targets_;
+    std::deque<task> tasks_;
+    std::vector<uint32_t> free_tasks_;
+    std::deque<frame> frames_;
+    size_t depth_ = 0;
+
+    static inline DataType string_data(std::string_view value) noexcept {
+      DataType data;
+      data.type = TypeFlag::String;
+      data.string.length = value.size();
+      data.string.data = const_cast<char*>(value.data());
+      return data;
+    }
+
+    inline void prepare_list_item() {
+      if (!depth_) return;
+      auto& frame = frames_[depth_ - 1];
+      if (!frame.is_object) this->collect_targets(frame, frame.index++);
+    }
+
+    void scalar(const DataType& data) {
+      this->prepare_list_item();
+      View view(data);
+      for (const auto& item : targets_) this->test_value(item, view);
+      targets_.clear();
+    }
+
+    void begin_container(TypeFlag type) {
+      this->prepare_list_item();
+      if (frames_.size() == depth_) frames_.emplace_back();
+      auto& frame = frames_[depth_++];
+      frame.is_object = type == TypeFlag::Object;
+      frame.index = 0;
+
+      // an empty container is enough for the constraints that only look at the type.
+      DataType data;
+      data.type = type;
+      data.list = DataType::List{0, 0, nullptr};
+      View view(data);
+      for (const auto& item : targets_) this->test_container(item, view);
+      targets_.clear();
+    }
+
+    void end_container() {
+      auto& frame = frames_[--depth_];
+      for (auto id : frame.tasks) this->finish(id, frame.index);
+      frame.tasks.clear();
+    }
+
+    void collect_targets(frame& frame, size_t index) {
+      for (auto id : frame.tasks) {
+        auto& item = tasks_[id];
+        if (item.settled) continue;
+        switch (item.kind) {
+          case task_kind::list: {
+            const auto& context = item.constraint->context_for<list_tag>();
+            this->add_target(context.constraint, item.quick || context.ignore_details, id, index);
+            break;
+          }
+          case task_kind::tuple: {
+            const auto& context = item.constraint->context_for<tuple_tag>();
+            if (index < context.constraints.size()) {
+              this->add_target(context.constraints[index], item.quick || context.ignore_details, id, index);
+            }
+            break;
+          }
+          case task_kind::map:
+            this->map_member(id, frame.key, index);
+            break;
+          case task_kind::model:
+            this->model_member(id, frame.key);
+            break;
+          default:
+            break;  // ranges only need the number of items.
+        }
+      }
+    }
+
+    inline void add_target(const Constraint& constraint, bool quick, uint32_t parent, size_t slot) {
+      targets_.push_back(target{target::of_constraint, quick, parent, slot, &constraint, nullptr, nullptr, {}});
+    }
+
+    void map_member(uint32_t id, const std::string& key, size_t index) {
+      auto& item = tasks_[id];
+      const auto& context = item.constraint->context_for<map_tag>();
+      bool quick = item.quick || context.ignore_details;
+      if (context.key) {
+        auto data = string_data(key);
+        View view(data);
+        if (quick) {
+          if (!context.key.quick_test(view)) {
+            item.settled = true;
+            if (!item.quick) item.failure.emplace(context.fail("Object contains invalid key."));
+            return;
+          }
+        } else if (auto result = context.key.test(view); !result.is_valid()) {
+          item.settled = true;
+          item.failure.emplace(context.fail("Object contains invalid key.", std::move(result)));
+          return;
+        }
+      }
+      if (context.value) this->add_target(context.value, quick, id, index);
+    }
+
+    void model_member(uint32_t id, const std::string& key) {
+      auto& item = tasks_[id];
+      const Model::FieldDescriptor* descriptor;
+      if (item.model->frozen()) {
+        auto index = item.model->field_index(key);
+        if (index == Model::npos) return;
+        item.seen[index / 64] |= uint64_t{1} << (index % 64);
+        descriptor = &item.model->field_descriptor(index);
+      } else {
+        auto it = item.model->find_field(text(key.data(), key.size()));
+        if (it == item.model->end_fields()) return;
+        item.seen_keys.emplace(&it->first);
+        descriptor = &it->second;
+      }
+      targets_.push_back(target{target::of_member, item.quick, id, 0, nullptr, nullptr, descriptor->field.get(), key});
+    }
+
+    //! Tests a value that is already complete, a scalar or an empty container.
+    void test_value(const target& item, const View& view) {
+      switch (item.kind) {
+        case target::of_constraint:
+          if (item.quick) {
+            this->report(item.parent, item.slot, item.constraint->quick_test(view));
+          } else {
+            auto result = item.constraint->test(view);
+            auto passed = result.is_valid();
+            this->report(item.parent, item.slot, passed, std::move(result));
+          }
+          break;
+        case target::of_model:
+          if (item.quick) {
+            this->report(item.parent, item.slot, item.model->quick_test(view));
+          } else {
+            auto result = item.model->validate(view);
+            auto passed = result.is_valid();
+            this->report(item.parent, item.slot, passed, std::move(result));
+          }
+          break;
+        case target::of_member: {
+          const auto& field = *item.field;
+          if (item.quick) {
+            this->report(item.parent, item.slot, field.quick_test(view));
+          } else if (field.properties().ignore_details) {
+            if (field.quick_test(view)) this->report(item.parent, item.slot, true);
+            else this->report(
+                item.parent, item.slot, false,
+                member_failure(item.key, field, sequence<ConstraintResult>::no_sequence()));
+          } else {
+            auto result = field.validate(view);
+            if (result.is_valid()) this->report(item.parent, item.slot, true);
+            else this->report(
+                item.parent, item.slot, false, member_failure(item.key, field, std::move(result.failures)));
+          }
+          break;
+        }
+      }
+    }
+
+    //! Tests a container that has just started, the view is an empty container of the same type.
+    void test_container(const target& item, const View& view) {
+      switch (item.kind) {
+        case target::of_constraint:
+          this->test_constraint(item, view);
+          break;
+        case target::of_model:
+          if (!view.is_object()) return this->test_value(item, view);
+          this->open_task(task_kind::model, item, item.model);
+          break;
+        case target::of_member: {
+          const auto& field = *item.field;
+          auto mode = item.quick || field.properties().ignore_details ? group_mode::all : group_mode::collect;
+          this->open_group(task_kind::member, item, field.properties().constraints, mode, view, &field);
+          break;
+        }
+      }
+    }
+
+    void test_constraint(const target& item, const View& view) {
+      const auto& constraint = *item.constraint;
+      if (constraint.is<list_tag>()) {
+        if (!view.is_list()) return this->test_value(item, view);
+        this->open_task(task_kind::list, item);
+      } else if (constraint.is<tuple_tag>()) {
+        if (!view.is_list()) return this->test_value(item, view);
+        this->open_task(task_kind::tuple, item);
+      } else if (constraint.is<map_tag>()) {
+        const auto& context = constraint.context_for<map_tag>();
+        if (!view.is_object() || (!context.key && !context.value)) return this->test_value(item, view);
+        this->open_task(task_kind::map, item);
+      } else if (constraint.is<range_tag>()) {
+        if (!view.is_list()) return this->test_value(item, view);
+        this->open_task(task_kind::range, item);
+      } else if (constraint.is<model_tag>()) {
+        if (!view.is_object()) return this->test_value(item, view);
+        this->open_task(task_kind::model, item, constraint.context_for<model_tag>().model.get());
+      } else if (constraint.is<any_tag>()) {
+        const auto& context = constraint.context_for<any_tag>();
+        this->open_group(task_kind::any, item, context.constraints, group_mode::any, view);
+      } else if (constraint.is<all_tag>()) {
+        const auto& context = constraint.context_for<all_tag>();
+        auto mode = group_mode::collect;
+        if (item.quick) mode = group_mode::all;
+        else if (context.hide) mode = group_mode::first_failure;
+        else if (context.ignore_details) mode = group_mode::all;
+        this->open_group(task_kind::all, item, context.constraints, mode, view);
+      } else if (constraint.is<field_tag>()) {
+        const auto& context = constraint.context_for<field_tag>();
+        const auto& field = **context.ref;
+        auto mode = group_mode::collect;
+        if (item.quick) mode = group_mode::all;
+        else if (context.hide) mode = group_mode::first_failure;
+        else if (context.ignore_details || field.properties().ignore_details) mode = group_mode::all;
+        this->open_group(task_kind::field, item, field.properties().constraints, mode, view);
+      } else {
+        this->test_value(item, view);  // the rest only look at the type of a container.
+      }
+    }
+
+    uint32_t acquire(task_kind kind, const target& item) {
+      uint32_t id;
+      if (free_tasks_.empty()) {
+        id = tasks_.size();
+        tasks_.emplace_back();
+      } else {
+        id = free_tasks_.back();
+        free_tasks_.pop_back();
+      }
+      auto& result = tasks_[id];
+      result.kind = kind;
+      result.quick = item.quick;
+      result.settled = false;
+      result.any_passed = false;
+      result.any_failed = false;
+      result.parent = item.parent;
+      result.slot = item.slot;
+      result.constraint = item.constraint;
+      return id;
+    }
+
+    void release(uint32_t id) {
+      auto& item = tasks_[id];
+      item.key.clear();
+      item.failure.reset();
+      item.failures.clear();
+      item.details.clear();
+      item.seen.clear();
+      item.seen_keys.clear();
+      free_tasks_.push_back(id);
+    }
+
+    void open_task(task_kind kind, const target& item, const Model* model = nullptr) {
+      auto id = this->acquire(kind, item);
+      if (model) {
+        auto& result = tasks_[id];
+        result.model = model;
+        if (model->frozen()) result.seen.assign((model->properties().field_map.size() + 63) / 64, 0);
+      }
+      frames_[depth_ - 1].tasks.push_back(id);
+    }
+
+    void open_group(
+        task_kind kind, const target& item, const sequence<Constraint>& constraints,
+        group_mode mode, const View& view, const Field* field = nullptr) {
+      auto id = this->acquire(kind, item);
+      auto& group = tasks_[id];
+      group.mode = mode;
+      group.constraints = &constraints;
+      group.pending = constraints.size();
+      group.field = field;
+      if (kind == task_kind::member) group.key.assign(item.key);
+      if (constraints.empty()) return this->complete_group(id);
+
+      bool quick = mode == group_mode::all || mode == group_mode::any;
+      for (size_t index = 0; index < constraints.size(); ++index) {
+        this->test_container(
+            target{target::of_constraint, quick, id, index, &constraints[index], nullptr, nullptr, {}}, view);
+      }
+    }
+
+    void report(
+        uint32_t parent, size_t slot, bool passed,
+        ConstraintResult&& result = ConstraintResult::ok()) {
+      if (parent == no_parent) {
+        result_.emplace(std::move(result));
+        return;
+      }
+      auto& item = tasks_[parent];
+      switch (item.kind) {
+        case task_kind::list:
+        case task_kind::tuple:
+        case task_kind::map:
+          if (passed || item.settled) return;
+          item.settled = true;
+          if (!item.quick) item.failure.emplace(this->item_failure(item, slot, std::move(result)));
+          return;
+        case task_kind::model:
+          if (passed) return;
+          if (item.quick) item.settled = true;
+          else item.details.push_back(std::move(result));
+          return;
+        case task_kind::range:
+          return;
+        default:
+          if (passed) item.any_passed = true;
+          else {
+            item.any_failed = true;
+            if (item.mode == group_mode::first_failure || item.mode == group_mode::collect) {
+              item.failures.emplace_back(slot, std::move(result));
+            }
+          }
+          if (--item.pending == 0) this->complete_group(parent);
+          return;
+      }
+    }
+
+    ConstraintResult item_failure(const task& item, size_t index, ConstraintResult&& result) const {
+      if (item.kind == task_kind::map) {
+        const auto& context = item.constraint->context_for<map_tag>();
+        if (context.ignore_details) return context.fail("Object contains invalid value.");
+        return context.fail("Object contains invalid value.", std::move(result));
+      }
+      if (item.kind == task_kind::tuple) {
+        const auto& context = item.constraint->context_for<tuple_tag>();
+        return sequence_failure(
+            context, context.ignore_details, "Invalid value found in the tuple.", index, std::move(result));
+      }
+      const auto& context = item.constraint->context_for<list_tag>();
+      return sequence_failure(
+          context, context.ignore_details, "Invalid value found in the list.", index, std::move(result));
+    }
+
+    static inline ConstraintResult sequence_failure(
+        const constraint_context& context, bool ignore_details, const char* message,
+        size_t index, ConstraintResult&& result) {
+      if (ignore_details) {
+        return context.fail(
+            message,
+            ConstraintResult::leaf_field_failure(ConstraintResult::index_text(index), "invalid value."));
+      }
+      return context.fail(
+          message,
+          ConstraintResult::field_failure(
+            ConstraintResult::index_text(index), std::move(result), "invalid value."));
+    }
+
+    void complete_group(uint32_t id) {
+      auto& group = tasks_[id];
+      bool passed = group.mode == group_mode::any ? group.any_passed : !group.any_failed;
+      auto result = passed || group.quick ? ConstraintResult::ok() : this->group_failure(group);
+      auto parent = group.parent;
+      auto slot = group.slot;
+      this->release(id);
+      this->report(parent, slot, passed, std::move(result));
+    }
+
+    ConstraintResult group_failure(task& group) {
+      std::sort(
+          group.failures.begin(), group.failures.end(),
+          [](const auto& a, const auto& b) { return a.first < b.first; });
+      switch (group.kind) {
+        case task_kind::all: {
+          const auto& context = group.constraint->context_for<all_tag>();
+          if (group.mode == group_mode::first_failure) return std::move(group.failures.front().second);
+          if (group.mode == group_mode::all) return context.fail("Some of the constraints fail on this value.");
+          return context.fail("Some of the constraints fail on this value.", this->collect_failures(group));
+        }
+        case task_kind::any:
+          return group.constraint->context_for<any_tag>().fail("None of the constraints read this value.");
+        case task_kind::field: {
+          const auto& context = group.constraint->context_for<field_tag>();
+          if (group.mode == group_mode::first_failure) return std::move(group.failures.front().second);
+          if (group.mode == group_mode::all) return context.custom_message_fail();
+          return context.custom_message_fail(this->collect_failures(group));
+        }
+        default:
+          if (group.mode == group_mode::all)
+            return member_failure(group.key, *group.field, sequence<ConstraintResult>::no_sequence());
+          return member_failure(group.key, *group.field, this->collect_failures(group));
+      }
+    }
+
+    sequence<ConstraintResult> collect_failures(task& group) {
+      sequence<ConstraintResult> details;
+      for (auto& item : group.failures) {
+        details.push_back(std::move(item.second));
+        if ((*group.constraints)[item.first].context().is_fatal()) break;
+      }
+      return details;
+    }
+
+    static inline ConstraintResult
+    member_failure(std::string_view key, const Field& field, sequence<ConstraintResult>&& details) {
+      return ConstraintResult {
+        .details = std::move(details),
+        .name = text::copy(key),
+        .reason = field.message(),
+        .flag = ConstraintResult::flags::field
+      };
+    }
+
+    //! Reports the result of a container task once the container ends.
+    void finish(uint32_t id, size_t count) {
+      auto& item = tasks_[id];
+      bool passed = !item.settled;
+      auto result = ConstraintResult::ok();
+      switch (item.kind) {
+        case task_kind::tuple:
+          if (passed) {
+            const auto& context = item.constraint->context_for<tuple_tag>();
+            if (context.strict && count > context.constraints.size()) {
+              passed = false;
+              if (!item.quick) result = context.fail("Too many values in the tuple.");
+            } else if (count < context.constraints.size()) {
+              passed = false;
+              if (!item.quick) result = context.fail("Too few values in the tuple.");
+            }
+            break;
+          }
+          [[fallthrough]];
+        case task_kind::list:
+        case task_kind::map:
+          if (!passed && !item.quick) result = std::move(*item.failure);
+          break;
+        case task_kind::range: {
+          const auto& context = item.constraint->context_for<range_tag>();
+          if (auto reason = range_tag::list_size_failure(count, context); reason) {
+            passed = false;
+            if (!item.quick) result = context.fail(reason);
+          }
+          break;
+        }
+        case task_kind::model:
+          passed = this->finish_model(item, result);
+          break;
+        default:
+          break;
+      }
+      auto parent = item.parent;
+      auto slot = item.slot;
+      this->release(id);
+      this->report(parent, slot, passed, std::move(result));
+    }
+
+    bool finish_model(task& item, ConstraintResult& result) {
+      const auto& model = *item.model;
+      if (item.quick && item.settled) return false;
+      if (model.frozen()) {
+        for (size_t index = 0; index < model.properties().field_map.size(); ++index) {
+          if (!model.field_descriptor(index).required) continue;
+          if (item.seen[index / 64] & (uint64_t{1} << (index % 64))) continue;
+          if (item.quick) return false;
+          auto name = model.field_name(index);
+          item.details.push_back(
+              ConstraintResult::leaf_field_failure(text(name.data(), name.size()), "missing required field!"));
+        }
+      } else {
+        for (auto it = model.begin_fields(); it != model.end_fields(); ++it) {
+          if (!it->second.required || item.seen_keys.count(&it->first)) continue;
+          if (item.quick) return false;
+          item.details.push_back(
+              ConstraintResult::leaf_field_failure(it->first.view(), "missing required field!"));
+        }
+      }
+      if (item.details.empty()) return true;
+      if (!item.quick) {
+        sequence<ConstraintResult> details(item.details.size());
+        for (auto& detail : item.details) details.push_back(std::move(detail));
+        result = ConstraintResult {
+          .details = std::move(details),
+          .name = model.name().clone(),
+          .reason = text("This model is invalid!"),
+          .flag = ConstraintResult::flags::none
+        };
+      }
+      return false;
+    }
+  };
+
+}
+
+#endif /* end of include guard: GARLIC_STREAMING_H */
@@ -30,20 +30,24 @@ namespace garlic {
   template<GARLIC_VIEW L1, GARLIC_VIEW L2>
   static inline std::enable_if_t<!is_comparable<L1, L2>::value, bool>
   cmp_layers(const L1& layer1, const L2& layer2) {
-    if (layer1.is_int() && layer2.is_int() && layer1.get_int() == layer2.get_int()) return true;
-    else if (layer1.is_string() && layer2.is_string() && std::strcmp(layer1.get_cstr(), layer2.get_cstr()) == 0) {
+    auto type1 = internal::probe_type(layer1);
+    auto type2 = internal::probe_type(layer2);
+    if (type1.is_int() && type2.is_int() && layer1.get_int() == layer2.get_int()) return true;
+    else if (type1.is_int64() && type2.is_int64() && get_int64(layer1) == get_int64(layer2)) return true;
+    else if (type1.is_uint64() && type2.is_uint64() && get_uint64(layer1) == get_uint64(layer2)) return true;
+    else if (type1.is_string() && type2.is_string() && std::strcmp(layer1.get_cstr(), layer2.get_cstr()) == 0) {
       return true;
     }
-    else if (layer1.is_double() && layer2.is_double() && layer1.get_double() == layer2.get_double()) return true;
-    else if (layer1.is_bool() && layer2.is_bool() && layer1.get_bool() == layer2.get_bool()) return true;
-    else if (layer1.is_null() && layer2.is_null()) return true;
-    else if (layer1.is_list() && layer2.is_list()) {
+    else if (type1.is_double() && type2.is_double() && layer1.get_double() == layer2.get_double()) return true;
+    else if (type1.is_bool() && type2.is_bool() && layer1.get_bool() == layer2.get_bool()) return true;
+    else if (type1.is_null() && type2.is_null()) return true;
+    else if (type1.is_list() && type2.is_list()) {
       return std::equal(
           layer1.begin_list(), layer1.end_list(),
           layer2.begin_list(), layer2.end_list(),
           [](const auto& item1, const auto& item2) { return cmp_layers(item1, item2); }
       );
-    } else if (layer1.is_object() && layer2.is_object()) {
+    } else if (type1.is_object() && type2.is_object()) {
       return std::equal(
           layer1.begin_member(), layer1.end_member(),
           layer2.begin_member(), layer2.end_member(),
@@ -483,22 +487,28 @@ namespace garlic {
   template<GARLIC_VIEW Layer, GARLIC_REF Output>
   static inline void
   copy_layer(Layer&& layer, Output output) {
-    if (layer.is_double()) {
+    auto type = internal::probe_type(layer);
+    // integers too wide for an int are doubles as well, they are copied before a double loses their precision.
+    if (type.is_int64() && !type.is_int()) {
+      set_int64(output, get_int64(layer));
+    } else if (type.is_uint64() && !type.is_int64()) {
+      set_uint64(output, get_uint64(layer));
+    } else if (type.is_double()) {
       output.set_double(layer.get_double());
-    } else if (layer.is_int()) {
+    } else if (type.is_int()) {
       output.set_int(layer.get_int());
-    } else if (layer.is_bool()) {
+    } else if (type.is_bool()) {
       output.set_bool(layer.get_bool());
-    } else if (layer.is_string()) {
+    } else if (type.is_string()) {
       output.set_string(layer.get_cstr());
-    } else if (layer.is_list()) {
+    } else if (type.is_list()) {
       output.set_list();
       for (const auto& item : layer.get_list()) {
           output.push_back_builder(
               [&item](auto ref) { copy_layer(item, ref); }
               );
       }
-    } else if (layer.is_object()) {
+    } else if (type.is_object()) {
       output.set_object();
       for (const auto& pair : layer.get_object()) {
         output.add_member_builder(
@@ -520,7 +530,7 @@ namespace garlic {
     static constexpr bool has_explicit_list_size_method = false;
 
     template<GARLIC_VIEW Layer>
-    static constexpr bool has_explicit_list_size_method<Layer, decltype(std::declval<Layer>().list_size())>  = true;
+    static constexpr bool has_explicit_list_size_method<Layer, std::void_t<decltype(std::declval<Layer>().list_size())>>  = true;
 
     // Use explicit list_size method.
     template<GARLIC_VIEW Layer>
@@ -550,7 +560,7 @@ namespace garlic {
     static constexpr bool has_explicit_string_length_method = false;
 
     template<GARLIC_VIEW Layer>
-    static constexpr bool has_explicit_string_length_method<Layer, decltype(std::declval<Layer>().string_length())>  = true;
+    static constexpr bool has_explicit_string_length_method<Layer, std::void_t<decltype(std::declval<Layer>().string_length())>>  = true;
 
     template<GARLIC_VIEW Layer>
     static inline std::enable_if_t<has_explicit_string_length_method<Layer>, size_t>
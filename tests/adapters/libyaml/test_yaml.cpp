@@ -3,6 +3,8 @@
 #include <algorithm>
 #include <functional>
 #include <deque>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -58,3 +60,176 @@ TEST(YamlCpp, ProtocolTest) {
     assertions.pop_front();
   }
 }
+
+TEST(YamlCpp, ScalarTableTest) {
+  auto result = load(
+      "[12, -7, 2147483648, 1.5, 1e3, .5, 'quoted 12', \"3\", yes, off, y, null, 'null', ~, text, 0x1f, [1, x], {a: 2.5},"
+      " -9223372036854775808, 18446744073709551615, 18446744073709551616]\n");
+  ASSERT_TRUE(result);
+
+  // the view of the document reads the table, a view of the inner document parses every time.
+  auto view = result->get_view();
+  YamlView plain(result->get_inner_document());
+  ASSERT_EQ(std::distance(plain.begin_list(), plain.end_list()), std::distance(view.begin_list(), view.end_list()));
+
+  std::function<void(const YamlView&, const YamlView&)> assert_same = [&assert_same](const auto& a, const auto& b) {
+    SCOPED_TRACE(b.is_string() ? b.get_cstr() : "container");
+    ASSERT_EQ(a.is_null(), b.is_null());
+    ASSERT_EQ(a.is_int(), b.is_int());
+    ASSERT_EQ(a.is_int64(), b.is_int64());
+    ASSERT_EQ(a.is_uint64(), b.is_uint64());
+    ASSERT_EQ(a.get_type(), b.get_type());
+    uint16_t type = 0;
+    for (auto [flag, value] : {
+        std::pair{garlic::TypeFlag::Null, b.is_null()}, {garlic::TypeFlag::Boolean, b.is_bool()},
+        {garlic::TypeFlag::String, b.is_string()}, {garlic::TypeFlag::Integer, b.is_int()},
+        {garlic::TypeFlag::Double, b.is_double()}, {garlic::TypeFlag::Object, b.is_object()},
+        {garlic::TypeFlag::List, b.is_list()}, {garlic::TypeFlag::Int64, b.is_int64()},
+        {garlic::TypeFlag::UInt64, b.is_uint64()}}) {
+      if (value) type |= flag;
+    }
+    ASSERT_EQ(type, b.get_type());
+    ASSERT_EQ(a.is_double(), b.is_double());
+    ASSERT_EQ(a.is_bool(), b.is_bool());
+    ASSERT_EQ(a.is_string(), b.is_string());
+    if (b.is_int()) { ASSERT_EQ(a.get_int(), b.get_int()); }
+    if (b.is_int64()) { ASSERT_EQ(a.get_int64(), b.get_int64()); }
+    if (b.is_uint64()) { ASSERT_EQ(a.get_uint64(), b.get_uint64()); }
+    if (b.is_double()) { ASSERT_EQ(a.get_double(), b.get_double()); }
+    if (b.is_bool()) { ASSERT_EQ(a.get_bool(), b.get_bool()); }
+    if (b.is_list()) {
+      for (auto it = a.begin_list(), other = b.begin_list(); other != b.end_list(); ++it, ++other) {
+        assert_same(*it, *other);
+      }
+    }
+    if (b.is_object()) {
+      for (auto it = a.begin_member(), other = b.begin_member(); other != b.end_member(); ++it, ++other) {
+        assert_same((*it).key, (*other).key);
+        assert_same((*it).value, (*other).value);
+      }
+    }
+  };
+  assert_same(view, plain);
+
+  auto first = view.begin_list()[0];
+  ASSERT_TRUE(first.is_int());
+  ASSERT_EQ(12, first.get_int());
+  ASSERT_FALSE(view.begin_list()[6].is_int());
+  ASSERT_TRUE(view.begin_list()[8].get_bool());
+  ASSERT_FALSE(view.begin_list()[2].is_int());
+  ASSERT_EQ(2147483648, view.begin_list()[2].get_int64());
+  ASSERT_EQ(INT64_MIN, view.begin_list()[18].get_int64());
+  ASSERT_FALSE(view.begin_list()[19].is_int64());
+  ASSERT_EQ(UINT64_MAX, view.begin_list()[19].get_uint64());
+  ASSERT_FALSE(view.begin_list()[20].is_uint64());
+  ASSERT_TRUE(view.begin_list()[20].is_double());
+}
+
+TEST(YamlCpp, SharedDocumentTest) {
+  // the table is built by load(), threads taking their first views at once only read the document.
+  auto result = load("[1, 2.5, yes, null, text, [3, 4]]\n");
+  ASSERT_TRUE(result);
+  std::vector<int> sums(4);
+  std::vector<std::thread> threads;
+  for (size_t index = 0; index < sums.size(); ++index) {
+    threads.emplace_back([&result, &sums, index]() {
+        auto view = result->get_view();
+        for (const auto& item : view.get_list()) {
+          if (item.is_int()) sums[index] += item.get_int();
+          else if (item.is_list()) sums[index] += static_cast<int>(garlic::list_size(item));
+        }
+        });
+  }
+  for (auto& thread : threads) thread.join();
+  ASSERT_EQ(std::count(sums.begin(), sums.end(), 3), sums.size());
+}
+
+TEST(YamlCpp, RecursiveParserTest) {
+  using namespace garlic;
+  CloveDocument doc;
+  ASSERT_TRUE(load(
+        "short: 1\n"
+        "a key that is far too long to be stored inline: {inner key that is long as well: [x, 'y']}\n"
+        "empty_list: []\n"
+        "empty_map: {}\n"
+        "nested: [[], {}, [{}]]\n"
+        "id: 18446744073709551615\n", doc));
+
+  auto view = doc.get_view();
+  ASSERT_EQ(6, std::distance(view.begin_member(), view.end_member()));
+  ASSERT_EQ(1, (*view.find_member("short")).value.get_int());
+  ASSERT_EQ(UINT64_MAX, (*view.find_member("id")).value.get_uint64());
+
+  auto long_key = (*view.find_member("a key that is far too long to be stored inline")).value;
+  auto inner = (*long_key.find_member("inner key that is long as well")).value;
+  ASSERT_EQ(2, std::distance(inner.begin_list(), inner.end_list()));
+  ASSERT_EQ(std::string("y"), inner.begin_list()[1].get_string());
+
+  // empty containers stay empty.
+  auto empty_list = (*view.find_member("empty_list")).value;
+  ASSERT_TRUE(empty_list.is_list());
+  ASSERT_EQ(empty_list.begin_list(), empty_list.end_list());
+  auto empty_map = (*view.find_member("empty_map")).value;
+  ASSERT_TRUE(empty_map.is_object());
+  ASSERT_EQ(empty_map.begin_member(), empty_map.end_member());
+
+  auto nested = (*view.find_member("nested")).value;
+  auto first = nested.begin_list()[0], second = nested.begin_list()[1], third = nested.begin_list()[2];
+  ASSERT_TRUE(first.is_list() && first.begin_list() == first.end_list());
+  ASSERT_TRUE(second.is_object() && second.begin_member() == second.end_member());
+  ASSERT_EQ(1, std::distance(third.begin_list(), third.end_list()));
+
+  ASSERT_FALSE(load("{a: 1, [b]: 2}", doc));
+  ASSERT_FALSE(load("{a: 1, {b: c}: 2}", doc));
+}
+
+TEST(YamlCpp, ValidatingParserTest) {
+  using namespace garlic;
+  auto tag = make_model("Tag");
+  tag->add_field("name", make_field({make_constraint<type_tag>(TypeFlag::String)}));
+  tag->add_field("weight", make_field({make_constraint<type_tag>(TypeFlag::Double)}), false);
+
+  auto model = make_model("Manifest");
+  model->add_field("version", make_field({make_constraint<type_tag>(TypeFlag::Integer)}));
+  model->add_field("name", make_field({make_constraint<regex_tag>("[a-z]+")}));
+  model->add_field("enabled", make_field({make_constraint<type_tag>(TypeFlag::Boolean)}), false);
+  model->add_field("owner", make_field({make_constraint<type_tag>(TypeFlag::Null)}), false);
+  model->add_field("tags", make_field({make_constraint<list_tag>(make_constraint<model_tag>(tag))}), false);
+  model->add_field(
+      "matrix",
+      make_field({make_constraint<list_tag>(make_constraint<list_tag>(make_constraint<range_tag>(1, 2)))}),
+      false);
+  model->freeze();
+
+  auto assert_same_validation = [&model](const char* data) {
+    CloveDocument doc;
+    ASSERT_TRUE(load(data, doc));
+    auto expected = model->validate(doc);
+    auto result = validate(data, model);
+    ASSERT_TRUE(result) << data;
+    ASSERT_EQ(expected.is_valid(), result->is_valid()) << data;
+    ASSERT_EQ(expected.details.size(), result->details.size()) << data;
+    for (size_t index = 0; index < expected.details.size(); ++index) {
+      ASSERT_EQ(expected.details[index].name, (*result).details[index].name);
+      ASSERT_EQ(expected.details[index].details.size(), (*result).details[index].details.size());
+    }
+  };
+
+  assert_same_validation("version: 1\nname: garlic\nenabled: yes\nowner: null\n");
+  assert_same_validation("version: '1'\nname: \"12\"\nenabled: 1\n");
+  assert_same_validation("version: 1.5\nname: Garlic\n");
+  assert_same_validation("name: garlic\ntags: [{name: a}, {name: b, weight: 1.5}]\n");
+  assert_same_validation("version: 2\nname: garlic\ntags:\n  - name: a\n    weight: heavy\n  - {weight: 1}\n");
+  assert_same_validation("version: 2\nname: garlic\nmatrix: [[1, 2], [], [[], 3]]\n");
+  assert_same_validation("version: 2\nname: garlic\nmatrix: [[1], [a, bc, d]]\nextra: {a: [1, {b: 2}]}\n");
+  assert_same_validation("[version, name]\n");
+  assert_same_validation("garlic\n");
+
+  ASSERT_FALSE(validate("version: [1, 2\n", model));
+  ASSERT_FALSE(validate("version: &one 1\nname: *one\n", model));
+
+  // complex keys are rejected the same way load() rejects them.
+  ASSERT_FALSE(validate("{a: 1, [b]: 2}", model));
+  ASSERT_FALSE(validate("{a: 1, {b: c}: 2}", model));
+  ASSERT_FALSE(validate("version: 1\n? [name]\n: garlic\n", model));
+}
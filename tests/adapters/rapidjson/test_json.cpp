@@ -146,3 +146,70 @@ TEST(RapidJson, EqualityTest) {
   ASSERT_TRUE(cmp_layers(JsonRef(doc), JsonView(doc)));
   ASSERT_TRUE(cmp_layers(JsonView(doc), JsonRef(doc)));
 }
+
+
+TEST(RapidJson, ValidationHandlerTest) {
+  auto model = make_model("User");
+  model->add_field("name", make_field({make_constraint<type_tag>(TypeFlag::String)}));
+  model->add_field("tags", make_field({make_constraint<list_tag>(make_constraint<range_tag>(1, 3))}));
+  model->add_field("age", make_field({make_constraint<type_tag>(TypeFlag::Integer)}), false);
+  model->freeze();
+
+  auto validate = [&model](const char* json) {
+    ValidationHandler handler(model);
+    Reader reader;
+    StringStream stream(json);
+    EXPECT_TRUE(reader.Parse(stream, handler));
+    EXPECT_TRUE(handler.done());
+
+    Document doc;
+    doc.Parse(json);
+    auto expected = model->validate(JsonView(doc));
+    EXPECT_EQ(expected.is_valid(), handler.result().is_valid());
+    EXPECT_EQ(expected.details.size(), handler.result().details.size());
+    for (size_t index = 0; index < expected.details.size(); ++index) {
+      EXPECT_EQ(expected.details[index].name, handler.result().details[index].name);
+    }
+    return handler.result().is_valid();
+  };
+
+  ASSERT_TRUE(validate(R"({"name": "garlic", "tags": ["a", "bc"], "age": 12})"));
+  ASSERT_TRUE(validate(R"({"name": "garlic", "tags": []})"));
+  ASSERT_FALSE(validate(R"({"name": "garlic", "tags": ["a", "long tag"]})"));
+  ASSERT_FALSE(validate(R"({"name": 12, "tags": [], "age": 4294967295})"));
+  ASSERT_FALSE(validate(R"({"tags": {"a": 1}})"));
+  ASSERT_FALSE(validate(R"([1, 2, 3])"));
+}
+
+
+TEST(RapidJson, WideIntegers) {
+  const char* json = R"({"ts": 1700000000000, "max": 18446744073709551615, "low": -5000000000})";
+  auto doc = load(json);
+  auto ts = (*doc.find_member("ts")).value;
+  ASSERT_FALSE(ts.is_int());
+  ASSERT_TRUE(ts.is_int64());
+  ASSERT_TRUE(ts.is_double());  // wide integers read as doubles like on every other layer.
+  ASSERT_EQ(ts.get_int64(), 1700000000000);
+
+  // constraints and the stream validator agree with the loaded document.
+  auto model = make_model("Event");
+  model->add_field("ts", make_field({
+    make_constraint<type_tag>(TypeFlag::Double),
+    make_constraint<range_tag>(0, 1700000000000),
+    make_constraint<int64_literal_tag>(1700000000000)}));
+  model->add_field("max", make_field({make_constraint<uint64_literal_tag>(UINT64_MAX)}));
+  model->add_field("low", make_field({make_constraint<int64_literal_tag>(-5000000000)}));
+  model->freeze();
+  ASSERT_TRUE(model->validate(doc).is_valid());
+
+  ValidationHandler handler(model);
+  Reader reader;
+  StringStream stream(json);
+  ASSERT_TRUE(reader.Parse(stream, handler));
+  ASSERT_TRUE(handler.result().is_valid());
+
+  // the values survive a copy to another layer and the trip back to JSON.
+  CloveDocument clove;
+  copy_layer(doc, clove.get_reference());
+  ASSERT_STREQ(dump(clove.get_view()).GetString(), dump(doc).GetString());
+}
@@ -1,11 +1,28 @@
 #include <benchmark/benchmark.h>
 #include <garlic/garlic.h>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <regex>
 #include <string>
 #include <tuple>
+#include <vector>
+#include "garlic/clove.h"
 #include "garlic/constraints.h"
 #include "garlic/adapters/libyaml/parser.h"
 #include "garlic/adapters/rapidjson.h"
+#include "garlic/adapters/yaml-cpp.h"
 #include "garlic/containers.h"
+#include "garlic/regex.h"
+#include "garlic/parsing/compiled.h"
+#include "garlic/parsing/module.h"
+#include "garlic/parsing/numbers.h"
+#include "garlic/batch.h"
+#include "garlic/program.h"
+#include "garlic/registry.h"
 #include "test_utility.h"
 
 
@@ -144,6 +161,752 @@ static void BM_garlic_text(benchmark::State& state) {
 BENCHMARK(BM_garlic_text);
 BENCHMARK(BM_std_string);
 
+template<typename Document>
+static void FillCloveDocument(Document& doc, int count) {
+  doc.set_list();
+  for (auto i = 0; i < count; ++i) {
+    doc.push_back_builder([i](auto item) {
+      item.set_object();
+      item.add_member("id", i);
+      item.add_member("name", "A reasonably long name for a user");
+      item.add_member("score", 12.5);
+      item.add_member_builder("tags", [](auto tags) {
+        tags.set_list();
+        tags.push_back("first tag");
+        tags.push_back("second tag");
+      });
+    });
+  }
+}
+
+static void BM_CloveDocument_CAllocator(benchmark::State& state) {
+  for (auto _ : state) {
+    garlic::CloveDocument doc;
+    FillCloveDocument(doc, state.range(0));
+  }
+}
+
+static void BM_CloveDocument_ArenaAllocator(benchmark::State& state) {
+  auto arena = std::make_shared<garlic::ArenaAllocator>();
+  for (auto _ : state) {
+    {
+      garlic::GenericCloveDocument<garlic::ArenaAllocator> doc(arena);
+      FillCloveDocument(doc, state.range(0));
+    }
+    arena->reset();
+  }
+}
+BENCHMARK(BM_CloveDocument_CAllocator)->Arg(16)->Arg(1024);
+BENCHMARK(BM_CloveDocument_ArenaAllocator)->Arg(16)->Arg(1024);
+
+class CountingAllocator : public garlic::CAllocator {
+public:
+  static inline size_t allocated = 0;
+
+  void* allocate(size_t size) {
+    allocated += size;
+    return CAllocator::allocate(size);
+  }
+
+  void* reallocate(void* original, size_t old_size, size_t new_size) {
+    if (new_size > old_size) allocated += new_size - old_size;
+    return CAllocator::reallocate(original, old_size, new_size);
+  }
+};
+
+template<typename Policy>
+static void BM_CloveMemory_SmallLists(benchmark::State& state) {
+  size_t bytes = 0;
+  for (auto _ : state) {
+    CountingAllocator::allocated = 0;
+    garlic::GenericCloveDocument<CountingAllocator, unsigned, Policy> doc;
+    doc.set_list();
+    for (auto i = 0; i < 100000; ++i) {
+      doc.push_back_builder([](auto item) {
+        item.set_list();
+        item.push_back(1);
+        item.push_back(2);
+        item.push_back(3);
+      });
+    }
+    bytes = CountingAllocator::allocated;
+  }
+  state.counters["BytesPer100k"] = bytes;
+}
+
+template<typename Policy>
+static void BM_CloveMemory_SmallObjects(benchmark::State& state) {
+  size_t bytes = 0;
+  for (auto _ : state) {
+    CountingAllocator::allocated = 0;
+    garlic::GenericCloveDocument<CountingAllocator, unsigned, Policy> doc;
+    doc.set_list();
+    for (auto i = 0; i < 100000; ++i) {
+      doc.push_back_builder([](auto item) {
+        item.set_object();
+        item.add_member("a", 1);
+        item.add_member("b", 2);
+        item.add_member("c", 3);
+      });
+    }
+    bytes = CountingAllocator::allocated;
+  }
+  state.counters["BytesPer100k"] = bytes;
+}
+// CloveGrowthPolicy<16> mirrors the previous fixed initial capacity of 16 slots.
+BENCHMARK_TEMPLATE(BM_CloveMemory_SmallLists, garlic::CloveGrowthPolicy<16>);
+BENCHMARK_TEMPLATE(BM_CloveMemory_SmallLists, garlic::CloveGrowthPolicy<>);
+BENCHMARK_TEMPLATE(BM_CloveMemory_SmallObjects, garlic::CloveGrowthPolicy<16>);
+BENCHMARK_TEMPLATE(BM_CloveMemory_SmallObjects, garlic::CloveGrowthPolicy<>);
+
+template<typename Allocator>
+static void BM_CloveMemory_RepeatedKeys(benchmark::State& state) {
+  size_t bytes = 0;
+  for (auto _ : state) {
+    CountingAllocator::allocated = 0;
+    garlic::GenericCloveDocument<Allocator> doc;
+    doc.set_list();
+    for (auto i = 0; i < 100000; ++i) {
+      doc.push_back_builder([i](auto item) {
+        item.set_object();
+        item.add_member("identifier_of_the_user", i);
+        item.add_member("registration_timestamp", i);
+        item.add_member("last_login_timestamp", i);
+      });
+    }
+    bytes = CountingAllocator::allocated;
+  }
+  state.counters["BytesPer100k"] = bytes;
+}
+BENCHMARK_TEMPLATE(BM_CloveMemory_RepeatedKeys, CountingAllocator);
+BENCHMARK_TEMPLATE(BM_CloveMemory_RepeatedKeys, garlic::InterningAllocator<CountingAllocator>);
+
+template<typename Policy>
+static void BM_CloveFindMember(benchmark::State& state) {
+  garlic::GenericCloveDocument<garlic::CAllocator, unsigned, Policy> doc;
+  std::vector<std::string> keys;
+  doc.set_object();
+  for (auto i = 0; i < state.range(0); ++i) {
+    keys.push_back("field_" + std::to_string(i));
+    doc.add_member(keys.back(), i);
+  }
+  auto view = doc.get_view();
+  for (auto _ : state) {
+    for (const auto& key : keys) {
+      benchmark::DoNotOptimize(view.find_member(key));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+using LinearScanPolicy = garlic::CloveGrowthPolicy<4, 3, 2, std::numeric_limits<unsigned>::max()>;
+BENCHMARK_TEMPLATE(BM_CloveFindMember, LinearScanPolicy)->RangeMultiplier(4)->Range(4, 4096);
+BENCHMARK_TEMPLATE(BM_CloveFindMember, garlic::CloveGrowthPolicy<>)->RangeMultiplier(4)->Range(4, 4096);
+
+static const char* regex_benchmark_pattern = "[a-z][a-z0-9_]{2,31}@\\w+\\.(com|org|net)";
+
+static std::vector<std::string> RegexBenchmarkInputs() {
+  std::vector<std::string> inputs;
+  for (auto i = 0; i < 64; ++i) {
+    inputs.push_back("user_" + std::to_string(i * 7919) + "@example." + (i % 3 ? "com" : "io"));
+  }
+  return inputs;
+}
+
+static void BM_Regex_StdRegex(benchmark::State& state) {
+  std::regex pattern(regex_benchmark_pattern);
+  auto inputs = RegexBenchmarkInputs();
+  for (auto _ : state) {
+    for (const auto& input : inputs) {
+      benchmark::DoNotOptimize(std::regex_match(input.c_str(), pattern));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * inputs.size());
+}
+
+static void BM_Regex_RegexMatcher(benchmark::State& state) {
+  garlic::regex_matcher pattern(regex_benchmark_pattern);
+  auto inputs = RegexBenchmarkInputs();
+  for (auto _ : state) {
+    for (const auto& input : inputs) {
+      benchmark::DoNotOptimize(pattern.match(input));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * inputs.size());
+}
+BENCHMARK(BM_Regex_StdRegex);
+BENCHMARK(BM_Regex_RegexMatcher);
+
+// A module description with a regex field and a model member for every field.
+static std::string GenerateModuleDescription(int field_count) {
+  std::string result = "fields:\n";
+  for (auto i = 0; i < field_count; ++i) {
+    result += "  Field" + std::to_string(i) + ":\n    type: string\n    constraints:\n";
+    result += "      - {type: regex, pattern: \"[a-z]{1," + std::to_string(i % 20 + 1) + "}\\\\d*\"}\n";
+    result += "      - {type: range, min: 1, max: " + std::to_string(i + 10) + "}\n";
+  }
+  result += "models:\n";
+  for (auto i = 0; i < field_count; i += 50) {
+    result += "  Model" + std::to_string(i) + ":\n";
+    for (auto j = i; j < std::min(i + 50, field_count); ++j) {
+      result += "    member" + std::to_string(j) + ": Field" + std::to_string(j) + "\n";
+    }
+  }
+  return result;
+}
+
+static void BM_LoadModule_Yaml(benchmark::State& state) {
+  auto description = GenerateModuleDescription(state.range(0));
+  for (auto _ : state) {
+    auto doc = garlic::adapters::libyaml::load(description.c_str());
+    auto module = garlic::parsing::load_module(doc->get_view());
+    benchmark::DoNotOptimize(module);
+  }
+}
+
+static void BM_LoadModule_Compiled(benchmark::State& state) {
+  auto description = GenerateModuleDescription(state.range(0));
+  auto doc = garlic::adapters::libyaml::load(description.c_str());
+  auto image = *garlic::parsing::dump_compiled_module(*garlic::parsing::load_module(doc->get_view()));
+  for (auto _ : state) {
+    auto module = garlic::parsing::load_compiled_module(image.data(), image.size());
+    benchmark::DoNotOptimize(module);
+  }
+}
+BENCHMARK(BM_LoadModule_Yaml)->Arg(100)->Arg(2000);
+BENCHMARK(BM_LoadModule_Compiled)->Arg(100)->Arg(2000);
+
+// An order with a list of items, every item is checked against a nested model.
+// The second argument of the validation benchmarks is whether or not the models are frozen.
+static std::shared_ptr<garlic::Model> MakeOrderModel(bool frozen) {
+  using namespace garlic;
+  auto item = make_model("Item");
+  item->add_field("name", make_field({make_constraint<type_tag>(TypeFlag::String), make_constraint<range_tag>(1, 32)}));
+  item->add_field("quantity", make_field({make_constraint<type_tag>(TypeFlag::Integer), make_constraint<range_tag>(1, 100)}));
+  item->add_field("tags", make_field({make_constraint<list_tag>(make_constraint<regex_tag>("[a-z]+"))}), false);
+  auto order = make_model("Order");
+  order->add_field("id", make_field({make_constraint<type_tag>(TypeFlag::Integer)}));
+  order->add_field("email", make_field({make_constraint<regex_tag>("\\w+@\\w+\\.com")}));
+  order->add_field("status", make_field({make_constraint<any_tag>(sequence<Constraint>{
+          make_constraint<string_literal_tag>("open"), make_constraint<string_literal_tag>("closed")})}));
+  order->add_field("items", make_field({make_constraint<list_tag>(make_constraint<model_tag>(item))}));
+  if (frozen) {
+    item->freeze();
+    order->freeze();
+  }
+  return order;
+}
+
+// The item at the bad index, if any, gets a quantity out of range.
+static void FillOrderDocument(garlic::CloveDocument& doc, int count, int bad = -1) {
+  doc.set_object();
+  doc.add_member("id", 12);
+  doc.add_member("email", "user@example.com");
+  doc.add_member("status", "open");
+  doc.add_member_builder("items", [count, bad](auto items) {
+      items.set_list();
+      for (auto i = 0; i < count; ++i) {
+        items.push_back_builder([i, bad](auto item) {
+            item.set_object();
+            item.add_member("name", "item");
+            item.add_member("quantity", i == bad ? 0 : i % 100 + 1);
+            item.add_member_builder("tags", [](auto tags) {
+                tags.set_list();
+                tags.push_back("red");
+                tags.push_back("large");
+                });
+            });
+      }
+      });
+}
+
+static void BM_Validate_Tree(benchmark::State& state) {
+  auto model = MakeOrderModel(state.range(1));
+  garlic::CloveDocument doc;
+  FillOrderDocument(doc, state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(model->quick_test(doc));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_Validate_Program(benchmark::State& state) {
+  auto program = garlic::Program::compile(MakeOrderModel(state.range(1)));
+  garlic::CloveDocument doc;
+  FillOrderDocument(doc, state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(program.quick_test(doc));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Validate_Tree)->Args({1000, 0})->Args({1000, 1});
+BENCHMARK(BM_Validate_Program)->Args({1000, 0})->Args({1000, 1});
+
+// The last item of the order has a bad quantity. validate() explains it with a full result, made
+// in the heap or in an arena, while a trace only keeps the failed constraint and the path to it.
+static void BM_Reject_Validate(benchmark::State& state) {
+  auto model = MakeOrderModel(true);
+  garlic::CloveDocument doc;
+  FillOrderDocument(doc, state.range(0), state.range(0) - 1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(model->validate(doc));
+  }
+}
+
+static void BM_Reject_Trace(benchmark::State& state) {
+  auto program = garlic::Program::compile(MakeOrderModel(true));
+  garlic::CloveDocument doc;
+  FillOrderDocument(doc, state.range(0), state.range(0) - 1);
+  garlic::FailureTrace trace;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(program.trace(doc, trace));
+  }
+}
+static void BM_Reject_ValidateArena(benchmark::State& state) {
+  auto model = MakeOrderModel(true);
+  garlic::CloveDocument doc;
+  FillOrderDocument(doc, state.range(0), state.range(0) - 1);
+  garlic::ArenaAllocator arena;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(model->validate(doc, arena));
+    arena.reset();
+  }
+}
+
+BENCHMARK(BM_Reject_Validate)->Arg(16)->Arg(1000);
+BENCHMARK(BM_Reject_ValidateArena)->Arg(16)->Arg(1000);
+BENCHMARK(BM_Reject_Trace)->Arg(16)->Arg(1000);
+
+// A list of records checked serially and split across ThreadPool::shared(), the second argument.
+static void BM_Validate_LargeList(benchmark::State& state) {
+  using namespace garlic;
+  auto record = make_model("Record");
+  record->add_field("id", make_field({make_constraint<type_tag>(TypeFlag::Integer), make_constraint<range_tag>(0, 1 << 30)}));
+  record->add_field("name", make_field({make_constraint<regex_tag>("[a-z]+")}));
+  record->freeze();
+  auto constraint = make_constraint<list_tag>(make_constraint<model_tag>(record), false, state.range(1) ? 4096 : 0);
+  CloveDocument doc;
+  doc.set_list();
+  for (auto i = 0; i < state.range(0); ++i) {
+    doc.get_reference().push_back_builder([i](auto item) {
+        item.set_object();
+        item.add_member("id", i);
+        item.add_member("name", "record");
+        });
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(constraint.quick_test(doc));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Validate_LargeList)->Args({1 << 20, 0})->Args({1 << 20, 1})->UseRealTime();
+
+// Orders of skewed sizes, every tenth one is a hundred times larger, validated one by one and in a batch.
+static std::vector<garlic::CloveDocument> MakeOrderBatch(int count) {
+  std::vector<garlic::CloveDocument> documents(count);
+  for (auto i = 0; i < count; ++i) FillOrderDocument(documents[i], i % 10 ? 10 : 1000, i % 7 ? -1 : 0);
+  return documents;
+}
+
+static void BM_ValidateBatch_Serial(benchmark::State& state) {
+  auto model = MakeOrderModel(true);
+  auto documents = MakeOrderBatch(state.range(0));
+  for (auto _ : state) {
+    for (const auto& document : documents) {
+      if (!model->quick_test(document)) benchmark::DoNotOptimize(model->validate(document));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_ValidateBatch_Pool(benchmark::State& state) {
+  auto model = MakeOrderModel(true);
+  auto documents = MakeOrderBatch(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(garlic::validate_batch(*model, documents));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ValidateBatch_Serial)->Arg(1000)->UseRealTime();
+BENCHMARK(BM_ValidateBatch_Pool)->Arg(1000)->UseRealTime();
+
+
+// Getting hold of the current module on every request, from a shared pointer and from a registry.
+static void BM_Registry_SharedPtr(benchmark::State& state) {
+  garlic::Module module;
+  module.add_model(MakeOrderModel(true));
+  auto current = std::make_shared<garlic::Module>(std::move(module));
+  auto doc = garlic::CloveDocument{};
+  FillOrderDocument(doc, 1);
+  for (auto _ : state) {
+    auto snapshot = std::atomic_load(&current);
+    benchmark::DoNotOptimize(snapshot->get_model("Order")->quick_test(doc));
+  }
+}
+
+static void BM_Registry_Read(benchmark::State& state) {
+  garlic::Module module;
+  module.add_model(MakeOrderModel(true));
+  garlic::ModuleRegistry registry;
+  registry.publish(std::move(module));
+  auto doc = garlic::CloveDocument{};
+  FillOrderDocument(doc, 1);
+  for (auto _ : state) {
+    auto snapshot = registry.read();
+    benchmark::DoNotOptimize(snapshot->get_model("Order")->quick_test(doc));
+  }
+}
+BENCHMARK(BM_Registry_SharedPtr);
+BENCHMARK(BM_Registry_Read);
+
+
+// Synthetic records for the adapter benchmarks. The generator only uses the raw output of
+// std::mt19937, which the standard fixes, so a seed makes the same records on every platform.
+static std::string GenerateRecords(int count, uint32_t seed = 20210901) {
+  std::mt19937 random(seed);
+  auto pick = [&random](uint32_t bound) { return static_cast<int>(random() % bound); };
+  auto word = [&pick](int min, int max) {
+    std::string result;
+    for (auto i = min + pick(max - min + 1); i > 0; --i) result += static_cast<char>('a' + pick(26));
+    return result;
+  };
+  static const char* statuses[] = {"open", "closed", "open", "closed", "open", "closed", "open", "pending"};
+  std::string result = "[";
+  for (auto i = 0; i < count; ++i) {
+    auto name = word(3, 12);
+    if (i) result += ",";
+    result += "{\"id\": " + std::to_string(pick(10000));
+    result += ", \"name\": \"" + name + "\"";
+    result += ", \"email\": \"" + name + (pick(8) ? "@example.com\"" : "@example.org\"");
+    result += ", \"status\": \"" + std::string(statuses[pick(8)]) + "\"";
+    result += ", \"score\": " + std::to_string(pick(1200)) + ".5";
+    result += std::string(", \"active\": ") + (pick(2) ? "true" : "false");
+    result += ", \"tags\": [";
+    for (auto j = pick(4) + 1; j > 0; --j) result += "\"" + word(2, 8) + (j > 1 ? "\", " : "\"");
+    result += "], \"location\": [" + std::to_string(pick(180)) + ", " + std::to_string(pick(360)) + "]";
+    result += ", \"attributes\": {";
+    for (auto j = pick(4) + 1; j > 0; --j) result += "\"k" + std::to_string(j) + "\": \"" + word(1, 6) + (j > 1 ? "\", " : "\"");
+    result += "}, \"parent\": null}";
+  }
+  return result + "]";
+}
+
+static std::shared_ptr<garlic::Model> MakeRecordModel() {
+  using namespace garlic;
+  auto record = make_model("Record");
+  record->add_field("id", make_field({make_constraint<type_tag>(TypeFlag::Integer)}));
+  record->add_field("name", make_field({make_constraint<type_tag>(TypeFlag::String), make_constraint<range_tag>(3, 12)}));
+  record->add_field("email", make_field({make_constraint<regex_tag>("[a-z]+@example\\.com")}));
+  record->add_field("status", make_field({make_constraint<any_tag>(sequence<Constraint>{
+          make_constraint<string_literal_tag>("open"), make_constraint<string_literal_tag>("closed")})}));
+  record->add_field("tags", make_field({make_constraint<list_tag>(make_constraint<regex_tag>("[a-z]+"))}), false);
+  record->add_field("attributes", make_field({make_constraint<map_tag>(
+          make_constraint<regex_tag>("k\\d"), make_constraint<type_tag>(TypeFlag::String))}), false);
+  record->freeze();
+  return record;
+}
+
+// Every built-in tag with the member of a record it is tested on, the whole record if there is none.
+struct ConstraintCase {
+  const char* label;
+  const char* key;
+  garlic::Constraint constraint;
+};
+
+static const std::vector<ConstraintCase>& ConstraintCases() {
+  using namespace garlic;
+  static const std::vector<ConstraintCase> cases = {
+    {"type", "name", make_constraint<type_tag>(TypeFlag::String)},
+    {"range", "id", make_constraint<range_tag>(0, 5000)},
+    {"regex", "email", make_constraint<regex_tag>("[a-z]+@example\\.com")},
+    {"any", "status", make_constraint<any_tag>(sequence<Constraint>{
+        make_constraint<string_literal_tag>("open"), make_constraint<string_literal_tag>("closed")})},
+    {"list", "tags", make_constraint<list_tag>(make_constraint<regex_tag>("[a-z]+"))},
+    {"tuple", "location", make_constraint<tuple_tag>(sequence<Constraint>{
+        make_constraint<type_tag>(TypeFlag::Integer), make_constraint<range_tag>(0, 180)})},
+    {"map", "attributes", make_constraint<map_tag>(
+        make_constraint<regex_tag>("k\\d"), make_constraint<type_tag>(TypeFlag::String))},
+    {"all", "score", make_constraint<all_tag>(sequence<Constraint>{
+        make_constraint<type_tag>(TypeFlag::Double), make_constraint<range_tag>(0, 1000)})},
+    {"model", nullptr, make_constraint<model_tag>(MakeRecordModel())},
+    {"field", "name", make_constraint<field_tag>(make_field("Name", {make_constraint<range_tag>(3, 8)}))},
+    {"string_literal", "status", make_constraint<string_literal_tag>("open")},
+    {"int_literal", "id", make_constraint<int_literal_tag>(7)},
+    {"double_literal", "score", make_constraint<double_literal_tag>(10.5)},
+    {"bool_literal", "active", make_constraint<bool_literal_tag>(true)},
+    {"null_literal", "parent", make_constraint<null_literal_tag>()},
+    {"enum", "status", make_constraint<enum_tag>(std::vector<std::string>{"open", "closed"})},
+  };
+  return cases;
+}
+
+// The adapters the benchmarks run on, each loads the same records.
+struct CloveSource {
+  garlic::CloveDocument doc;
+  explicit CloveSource(const std::string& data) { garlic::adapters::libyaml::load(data.c_str(), doc); }
+  garlic::CloveView view() { return doc.get_view(); }
+};
+
+struct YamlSource {
+  garlic::adapters::libyaml::YamlDocument doc;
+  explicit YamlSource(const std::string& data) : doc(std::move(*garlic::adapters::libyaml::load(data.c_str()))) {}
+  garlic::adapters::libyaml::YamlView view() { return doc.get_view(); }
+};
+
+struct YamlNodeSource {
+  garlic::adapters::yamlcpp::YamlNode node;
+  explicit YamlNodeSource(const std::string& data) : node(garlic::adapters::yamlcpp::Yaml::load(data.c_str())) {}
+  garlic::adapters::yamlcpp::YamlNode view() { return node; }
+};
+
+struct JsonSource {
+  garlic::adapters::rapidjson::JsonDocument doc;
+  explicit JsonSource(const std::string& data) : doc(garlic::adapters::rapidjson::load(data.c_str())) {}
+  garlic::adapters::rapidjson::JsonView view() { return doc.get_view(); }
+};
+
+// The member by the key of every record, or the records themselves without a key.
+template<typename View>
+static std::vector<View> CollectValues(const View& records, const char* key) {
+  std::vector<View> values;
+  for (const auto& record : records.get_list()) {
+    if (!key) {
+      values.push_back(record);
+    } else if (auto it = record.find_member(key); it != record.end_member()) {
+      values.push_back((*it).value);
+    }
+  }
+  return values;
+}
+
+// The first argument is the position of the tag in ConstraintCases(), the second is 0 for quick_test and 1 for test.
+template<typename Source>
+static void BM_Constraint(benchmark::State& state) {
+  const auto& item = ConstraintCases()[state.range(0)];
+  Source source(GenerateRecords(256));
+  auto values = CollectValues(source.view(), item.key);
+  for (auto _ : state) {
+    for (const auto& value : values) {
+      if (state.range(1)) {
+        benchmark::DoNotOptimize(item.constraint.test(value));
+      } else {
+        benchmark::DoNotOptimize(item.constraint.quick_test(value));
+      }
+    }
+  }
+  state.SetLabel(item.label);
+  state.SetItemsProcessed(state.iterations() * values.size());
+}
+
+static void ConstraintArguments(benchmark::internal::Benchmark* benchmark) {
+  for (int64_t index = 0; index < static_cast<int64_t>(ConstraintCases().size()); ++index) {
+    benchmark->Args({index, 0})->Args({index, 1});
+  }
+}
+BENCHMARK_TEMPLATE(BM_Constraint, CloveSource)->Apply(ConstraintArguments);
+BENCHMARK_TEMPLATE(BM_Constraint, YamlSource)->Apply(ConstraintArguments);
+BENCHMARK_TEMPLATE(BM_Constraint, YamlNodeSource)->Apply(ConstraintArguments);
+BENCHMARK_TEMPLATE(BM_Constraint, JsonSource)->Apply(ConstraintArguments);
+
+// An enum of range(0) words next to an any_tag over a string literal per word, half of the values are in the set.
+static void BM_Enum(benchmark::State& state) {
+  using namespace garlic;
+  std::vector<std::string> words;
+  for (int64_t i = 0; i < state.range(0); ++i) words.push_back("value_" + std::to_string(i * 7919));
+  auto constraint = Constraint::empty();
+  if (state.range(1)) {
+    constraint = make_constraint<enum_tag>(words);
+  } else {
+    sequence<Constraint> literals;
+    for (const auto& word : words) literals.push_back(make_constraint<string_literal_tag>(word));
+    constraint = make_constraint<any_tag>(std::move(literals));
+  }
+  std::vector<CloveDocument> values(256);
+  for (size_t i = 0; i < values.size(); ++i) {
+    auto word = i % 2 ? words[(i * 31) % words.size()] : "missing_" + std::to_string(i);
+    values[i].set_string(word.c_str());
+  }
+  for (auto _ : state) {
+    for (const auto& value : values) benchmark::DoNotOptimize(constraint.quick_test(value.get_view()));
+  }
+  state.SetLabel(state.range(1) ? "enum" : "any");
+  state.SetItemsProcessed(state.iterations() * values.size());
+}
+BENCHMARK(BM_Enum)->ArgsProduct({{8, 64, 1024}, {0, 1}});
+
+// Model::quick_test() with an argument of 0, Model::validate() with 1.
+template<typename Source>
+static void BM_Model(benchmark::State& state) {
+  auto model = MakeRecordModel();
+  Source source(GenerateRecords(256));
+  auto records = CollectValues(source.view(), nullptr);
+  for (auto _ : state) {
+    for (const auto& record : records) {
+      if (state.range(0)) {
+        benchmark::DoNotOptimize(model->validate(record));
+      } else {
+        benchmark::DoNotOptimize(model->quick_test(record));
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * records.size());
+}
+BENCHMARK_TEMPLATE(BM_Model, CloveSource)->Arg(0)->Arg(1);
+BENCHMARK_TEMPLATE(BM_Model, YamlSource)->Arg(0)->Arg(1);
+BENCHMARK_TEMPLATE(BM_Model, YamlNodeSource)->Arg(0)->Arg(1);
+BENCHMARK_TEMPLATE(BM_Model, JsonSource)->Arg(0)->Arg(1);
+
+template<typename Source>
+static void BM_CopyLayer(benchmark::State& state) {
+  Source source(GenerateRecords(state.range(0)));
+  auto view = source.view();
+  for (auto _ : state) {
+    garlic::CloveDocument doc;
+    garlic::copy_layer(view, doc.get_reference());
+    benchmark::DoNotOptimize(doc);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_CopyLayer, CloveSource)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_CopyLayer, YamlSource)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_CopyLayer, YamlNodeSource)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_CopyLayer, JsonSource)->Arg(1000);
+
+// Parsing the records with every adapter, libyaml into clove goes through the recursive parser.
+template<typename Source>
+static void BM_Parse(benchmark::State& state) {
+  auto data = GenerateRecords(state.range(0));
+  for (auto _ : state) {
+    Source source(data);
+    benchmark::DoNotOptimize(source);
+  }
+  state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK_TEMPLATE(BM_Parse, CloveSource)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_Parse, YamlSource)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_Parse, YamlNodeSource)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_Parse, JsonSource)->Arg(1000);
+
+// data/performance/module.yaml with every field and model repeated under a suffixed name, the
+// copies still refer to the original definitions.
+static garlic::CloveDocument ScalePerformanceModule(int copies) {
+  garlic::CloveDocument original;
+  auto file = fopen("data/performance/module.yaml", "r");
+  garlic::adapters::libyaml::load(file, original);
+  fclose(file);
+  garlic::CloveDocument doc;
+  doc.set_object();
+  auto view = original.get_view();
+  for (const auto& section : view.get_object()) {
+    doc.get_reference().add_member_builder(section.key.get_cstr(), [&section, copies](auto definitions) {
+        definitions.set_object();
+        for (auto copy = 0; copy < copies; ++copy) {
+          for (const auto& definition : section.value.get_object()) {
+            auto name = std::string(definition.key.get_cstr()) + (copy ? "_" + std::to_string(copy) : "");
+            definitions.add_member_builder(name.c_str(), [&definition](auto ref) {
+                garlic::copy_layer(definition.value, ref);
+                });
+          }
+        }
+        });
+  }
+  return doc;
+}
+
+static void BM_LoadModule_PerformanceFile(benchmark::State& state) {
+  auto doc = ScalePerformanceModule(state.range(0));
+  for (auto _ : state) {
+    auto module = garlic::parsing::load_module(doc.get_view());
+    benchmark::DoNotOptimize(module);
+  }
+}
+BENCHMARK(BM_LoadModule_PerformanceFile)->Arg(1)->Arg(50);
+
+// Numbers as they show up in documents, short decimals with an argument of 0 and the 17 digits
+// it takes to round trip any double with 1.
+static std::vector<std::string> NumberBenchmarkInputs(bool round_trip) {
+  std::mt19937_64 generator(7);
+  std::vector<std::string> inputs;
+  char buffer[32];
+  for (auto i = 0; i < 1024; ++i) {
+    if (round_trip) {
+      std::uniform_real_distribution<double> mantissa(1, 10);
+      std::snprintf(buffer, sizeof(buffer), "%.17g", mantissa(generator) * std::pow(10, int(generator() % 40) - 20));
+    } else {
+      std::snprintf(buffer, sizeof(buffer), "%d.%02d", int(generator() % 100000), int(generator() % 100));
+    }
+    inputs.emplace_back(buffer);
+  }
+  return inputs;
+}
+
+static std::vector<std::string> IntegerBenchmarkInputs() {
+  std::mt19937_64 generator(7);
+  std::vector<std::string> inputs;
+  for (auto i = 0; i < 1024; ++i) inputs.push_back(std::to_string(int64_t(generator() >> (generator() % 64))));
+  return inputs;
+}
+
+static void BM_ParseDouble_Garlic(benchmark::State& state) {
+  auto inputs = NumberBenchmarkInputs(state.range(0));
+  for (auto _ : state) {
+    for (const auto& input : inputs) {
+      double value;
+      benchmark::DoNotOptimize(garlic::parsing::ParseDouble(input.data(), input.size(), value));
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * inputs.size());
+}
+
+static void BM_ParseDouble_Strtod(benchmark::State& state) {
+  auto inputs = NumberBenchmarkInputs(state.range(0));
+  for (auto _ : state) {
+    for (const auto& input : inputs) benchmark::DoNotOptimize(std::strtod(input.c_str(), nullptr));
+  }
+  state.SetItemsProcessed(state.iterations() * inputs.size());
+}
+
+static void BM_ParseDouble_FromChars(benchmark::State& state) {
+  auto inputs = NumberBenchmarkInputs(state.range(0));
+  for (auto _ : state) {
+    for (const auto& input : inputs) {
+      double value;
+      benchmark::DoNotOptimize(std::from_chars(input.data(), input.data() + input.size(), value));
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * inputs.size());
+}
+BENCHMARK(BM_ParseDouble_Garlic)->Arg(0)->Arg(1);
+BENCHMARK(BM_ParseDouble_Strtod)->Arg(0)->Arg(1);
+BENCHMARK(BM_ParseDouble_FromChars)->Arg(0)->Arg(1);
+
+static void BM_ParseInt_Garlic(benchmark::State& state) {
+  auto inputs = IntegerBenchmarkInputs();
+  for (auto _ : state) {
+    for (const auto& input : inputs) {
+      int64_t value;
+      benchmark::DoNotOptimize(garlic::parsing::ParseInt(input.data(), input.size(), value));
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * inputs.size());
+}
+
+static void BM_ParseInt_FromChars(benchmark::State& state) {
+  auto inputs = IntegerBenchmarkInputs();
+  for (auto _ : state) {
+    for (const auto& input : inputs) {
+      int64_t value;
+      benchmark::DoNotOptimize(std::from_chars(input.data(), input.data() + input.size(), value));
+      benchmark::DoNotOptimize(value);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * inputs.size());
+}
+BENCHMARK(BM_ParseInt_Garlic);
+BENCHMARK(BM_ParseInt_FromChars);
+
 //BENCHMARK(BM_LoadRapidJsonDocument_Native);
 //BENCHMARK(BM_LoadRapidJsonDocument_Garlic);
 
@@ -7,8 +7,12 @@
 *****************************************************************************/
 
 #include <gtest/gtest.h>
+#include <thread>
+#include <vector>
 
+#include <garlic/adapters/libyaml.h>
 #include <garlic/clove.h>
+#include <garlic/constraints.h>
 
 #include "test_protocol.h"
 
@@ -18,3 +22,292 @@ TEST(CloveValue, ProtocolTest) {
   test_full_layer(doc);
   test_full_layer(doc.get_reference());
 }
+
+TEST(CloveValue, ArenaProtocolTest) {
+  garlic::GenericCloveDocument<garlic::ArenaAllocator> doc;
+  test_full_layer(doc);
+  test_full_layer(doc.get_reference());
+}
+
+TEST(CloveValue, ArenaReuse) {
+  auto arena = std::make_shared<garlic::ArenaAllocator>(256);
+  const void* first = nullptr;
+  {
+    garlic::GenericCloveDocument<garlic::ArenaAllocator> doc(arena);
+    doc.set_string("some string long enough to need an allocation.");
+    first = doc.get_cstr();
+  }
+  arena->reset();
+  {
+    garlic::GenericCloveDocument<garlic::ArenaAllocator> doc(arena);
+    doc.set_string("another string that should land in the same spot.");
+    ASSERT_EQ(doc.get_cstr(), first);
+    ASSERT_STREQ(doc.get_cstr(), "another string that should land in the same spot.");
+
+    // allocations larger than a chunk get a chunk of their own.
+    std::string large(1024, 'x');
+    doc.set_string(large);
+    ASSERT_EQ(doc.get_string(), large);
+  }
+
+  auto& allocator = *arena;
+  auto block = static_cast<char*>(allocator.allocate(16));
+  std::strcpy(block, "growing");
+  ASSERT_EQ(allocator.reallocate(block, 16, 64), block);  // last block grows in place.
+  auto other = allocator.allocate(16);
+  auto moved = static_cast<char*>(allocator.reallocate(block, 64, 128));
+  ASSERT_NE(moved, block);
+  ASSERT_NE(static_cast<void*>(moved), other);
+  ASSERT_STREQ(moved, "growing");
+}
+
+TEST(CloveValue, GrowthPolicy) {
+  using Policy = garlic::CloveGrowthPolicy<2, 2, 1>;
+  ASSERT_EQ(Policy::next_capacity(0u), 2);
+  ASSERT_EQ(Policy::next_capacity(2u), 4);
+  ASSERT_EQ(garlic::CloveGrowthPolicy<>::next_capacity(4u), 6);
+  ASSERT_EQ(garlic::CloveGrowthPolicy<>::next_capacity(5u), 7);
+
+  garlic::GenericCloveDocument<garlic::CAllocator, unsigned, Policy> doc;
+  test_full_layer(doc);
+
+  doc.set_list();
+  ASSERT_EQ(doc.get_inner_value().list.capacity, 0);
+  for (auto i = 0; i < 5; ++i) doc.push_back(i);
+  ASSERT_EQ(doc.get_inner_value().list.capacity, 8);
+  doc.reserve(20);
+  ASSERT_EQ(doc.get_inner_value().list.capacity, 20);
+  doc.reserve(10);
+  ASSERT_EQ(doc.get_inner_value().list.capacity, 20);
+  ASSERT_EQ((*std::next(doc.begin_list(), 4)).get_int(), 4);
+
+  doc.set_object();
+  doc.reserve(3);
+  ASSERT_EQ(doc.get_inner_value().object.capacity, 3);
+  doc.add_member("a", 1);
+  doc.add_member("b", 2);
+  doc.add_member("c", 3);
+  doc.add_member("d", 4);
+  ASSERT_EQ(doc.get_inner_value().object.capacity, 6);
+  ASSERT_EQ((*doc.find_member("c")).value.get_int(), 3);
+}
+
+TEST(CloveValue, ShortStrings) {
+  garlic::CloveDocument doc;
+  const auto& data = doc.get_inner_value();
+  auto is_inline = [&data]() {
+    return data.string_data() >= reinterpret_cast<const char*>(&data)
+      && data.string_data() < reinterpret_cast<const char*>(&data + 1);
+  };
+
+  std::string value(garlic::CloveDocument::DataType::short_string_capacity, 'a');
+  doc.set_string(value);
+  ASSERT_TRUE(is_inline());
+  ASSERT_EQ(doc.get_string_view(), value);
+  ASSERT_EQ(strlen(doc.get_cstr()), value.size());
+
+  doc.set_string("");
+  ASSERT_TRUE(is_inline());
+  ASSERT_STREQ(doc.get_cstr(), "");
+  ASSERT_EQ(doc.get_string_view().size(), 0);
+
+  value.push_back('b');
+  doc.set_string(value.c_str());
+  ASSERT_FALSE(is_inline());
+  ASSERT_EQ(doc.get_string(), value);
+
+  doc.set_object();
+  doc.add_member("id", 12);
+  auto key_data = &(*doc.get_inner_value().object.data).key;
+  ASSERT_EQ((*doc.begin_member()).key.get_cstr(), key_data->short_string);
+  ASSERT_EQ((*doc.find_member("id")).value.get_int(), 12);
+}
+
+TEST(CloveValue, WideIntegers) {
+  const int64_t large = int64_t{1} << 40;
+  garlic::CloveDocument doc;
+
+  doc.set_int64(-12);  // stored as an int whenever it fits.
+  ASSERT_TRUE(doc.is_int());
+  ASSERT_TRUE(doc.is_int64());
+  ASSERT_FALSE(doc.is_uint64());
+  ASSERT_EQ(doc.get_int(), -12);
+
+  doc.set_int64(-large);
+  ASSERT_FALSE(doc.is_int());
+  ASSERT_TRUE(doc.is_double());  // wide integers still read as doubles.
+  ASSERT_TRUE(doc.is_int64());
+  ASSERT_FALSE(doc.is_uint64());
+  ASSERT_EQ(doc.get_int64(), -large);
+  ASSERT_EQ(doc.get_double(), -static_cast<double>(large));
+
+  doc.set_uint64(large);
+  ASSERT_TRUE(doc.is_int64());
+  ASSERT_TRUE(doc.is_uint64());
+  ASSERT_EQ(doc.get_uint64(), large);
+
+  doc.set_uint64(UINT64_MAX);
+  ASSERT_FALSE(doc.is_int64());
+  ASSERT_TRUE(doc.is_uint64());
+  ASSERT_EQ(doc.get_uint64(), UINT64_MAX);
+  ASSERT_EQ(doc.get_double(), static_cast<double>(UINT64_MAX));
+
+  doc.set_list();
+  doc.push_back(large);
+  doc.push_back(UINT64_MAX);
+  doc.push_back(3);
+  garlic::CloveDocument copy;
+  garlic::copy_layer(doc, copy.get_reference());
+  ASSERT_TRUE(garlic::cmp_layers(doc, copy));
+  auto it = copy.begin_list();
+  ASSERT_EQ((*it).get_int64(), large);
+  ASSERT_EQ((*++it).get_uint64(), UINT64_MAX);
+  ASSERT_EQ((*++it).get_int(), 3);
+
+  (*copy.begin_list()).set_int64(large + 1);
+  ASSERT_FALSE(garlic::cmp_layers(doc, copy));
+}
+
+TEST(CloveValue, WideIntegersFromYaml) {
+  using namespace garlic;
+  CloveDocument doc;
+  adapters::libyaml::load("ts: 1700000000000", doc);
+  auto ts = (*doc.find_member("ts")).value;
+  ASSERT_TRUE(ts.is_int64());
+  ASSERT_EQ(ts.get_int64(), 1700000000000);
+  ASSERT_TRUE(ts.is_double());
+  ASSERT_EQ(ts.get_double(), 1700000000000.0);
+
+  // the same checks pass on the document and on a view of the YAML it came from.
+  auto yaml = adapters::libyaml::load("1700000000000");
+  ASSERT_TRUE(yaml);
+  const Constraint constraints[] = {
+    make_constraint<type_tag>(TypeFlag::Double),
+    make_constraint<double_literal_tag>(1700000000000.0),
+    make_constraint<range_tag>(0, 1700000000000),
+  };
+  for (const auto& constraint : constraints) {
+    ASSERT_TRUE(constraint.quick_test(ts));
+    ASSERT_TRUE(constraint.quick_test(yaml->get_view()));
+  }
+}
+
+TEST(CloveValue, TypeMask) {
+  using garlic::TypeFlag;
+  garlic::CloveDocument doc;
+  auto type = [&doc]() { return doc.get_view().get_type(); };
+
+  ASSERT_EQ(type(), TypeFlag::Null);
+  doc.set_int(-3);
+  ASSERT_EQ(type(), TypeFlag::Integer | TypeFlag::Int64);
+  doc.set_int(3);
+  ASSERT_EQ(type(), TypeFlag::Integer | TypeFlag::Int64 | TypeFlag::UInt64);
+  doc.set_int64(-(int64_t{1} << 40));
+  ASSERT_EQ(type(), TypeFlag::Int64 | TypeFlag::Double);
+  doc.set_uint64(UINT64_MAX);
+  ASSERT_EQ(type(), TypeFlag::UInt64 | TypeFlag::Double);
+  doc.set_double(1.5);
+  ASSERT_EQ(type(), TypeFlag::Double);
+  doc.set_string("text");
+  ASSERT_EQ(type(), TypeFlag::String);
+  doc.set_list();
+  ASSERT_EQ(garlic::get_type(doc.get_view()), TypeFlag::List);
+}
+
+TEST(CloveValue, IndexedMembers) {
+  using Document = garlic::GenericCloveDocument<
+    garlic::CAllocator, unsigned, garlic::CloveGrowthPolicy<4, 3, 2, 1>>;
+  test_full_layer(Document{});
+
+  Document doc;
+  doc.set_object();
+  for (auto i = 0; i < 100; ++i) doc.add_member(std::to_string(i), i);
+  auto view = doc.get_view();
+  for (auto i = 0; i < 100; ++i) {
+    auto key = std::to_string(i);
+    ASSERT_EQ((*view.find_member(key)).value.get_int(), i);
+    ASSERT_EQ((*doc.find_member(key)).value.get_int(), i);
+  }
+  ASSERT_EQ(view.find_member("100"), view.end_member());
+  ASSERT_EQ(std::distance(view.begin_member(), view.end_member()), 100);
+
+  // iteration order is the insertion order.
+  auto position = 0;
+  for (const auto& member : view.get_object()) {
+    ASSERT_EQ(member.key.get_string(), std::to_string(position++));
+  }
+
+  doc.remove_member("10");
+  doc.erase_member(doc.find_member("20"));
+  ASSERT_EQ(std::distance(view.begin_member(), view.end_member()), 98);
+  ASSERT_EQ(view.find_member("10"), view.end_member());
+  ASSERT_EQ(view.find_member("20"), view.end_member());
+  ASSERT_EQ((*view.find_member("21")).value.get_int(), 21);
+  ASSERT_EQ((*view.find_member("99")).value.get_int(), 99);
+
+  for (auto member : doc.get_object()) {
+    member.key.set_string("v2." + member.key.get_string());
+  }
+  ASSERT_EQ((*view.find_member("v2.50")).value.get_int(), 50);  // scans while the index is stale.
+  ASSERT_EQ((*doc.find_member("v2.51")).value.get_int(), 51);
+  ASSERT_EQ(view.find_member("51"), view.end_member());
+  ASSERT_EQ((*view.find_member("v2.52")).value.get_int(), 52);
+}
+
+TEST(CloveValue, InternedKeys) {
+  using Allocator = garlic::InterningAllocator<>;
+  using Document = garlic::GenericCloveDocument<Allocator>;
+  test_full_layer(Document{});
+
+  Document doc;
+  const char* key = "a key too long to be stored inline";
+  doc.set_list();
+  for (auto i = 0; i < 3; ++i) {
+    doc.push_back_builder([key, i](auto item) {
+      item.set_object();
+      item.add_member(key, i);
+      item.add_member("short", i);
+    });
+  }
+  ASSERT_EQ(doc.get_allocator().get_pool().size(), 1);
+
+  auto interned = doc.get_allocator().get_pool().find(key);
+  ASSERT_NE(interned, nullptr);
+  auto position = 0;
+  auto view = doc.get_view();
+  for (const auto& item : view.get_list()) {
+    auto it = item.find_member(interned);
+    ASSERT_NE(it, item.end_member());
+    ASSERT_EQ((*it).key.get_cstr(), interned);
+    ASSERT_EQ((*it).value.get_int(), position);
+    ASSERT_EQ((*item.find_member(std::string{key})).value.get_int(), position);
+    ASSERT_EQ((*item.find_member("short")).value.get_int(), position++);
+  }
+
+  auto item = *doc.begin_list();
+  item.remove_member(key);
+  ASSERT_EQ(item.find_member(key), item.end_member());
+  ASSERT_STREQ(interned, key);  // removing a member leaves the pool alone.
+}
+
+TEST(CloveValue, SharedKeyPool) {
+  using Allocator = garlic::InterningAllocator<garlic::CAllocator, garlic::SharedKeyPool>;
+  auto pool = std::make_shared<garlic::SharedKeyPool>();
+
+  std::vector<std::thread> threads;
+  std::vector<const char*> keys(4);
+  for (auto i = 0; i < 4; ++i) {
+    threads.emplace_back([&pool, &keys, i]() {
+      garlic::GenericCloveDocument<Allocator> doc(std::make_shared<Allocator>(pool));
+      doc.set_object();
+      for (auto j = 0; j < 100; ++j) {
+        doc.add_member("a shared key number " + std::to_string(j), j);
+      }
+      keys[i] = (*doc.find_member("a shared key number 42")).key.get_cstr();
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  ASSERT_EQ(pool->size(), 100);
+  for (auto key : keys) ASSERT_EQ(key, pool->find("a shared key number 42"));
+}
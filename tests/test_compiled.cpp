@@ -0,0 +1,234 @@
+#include <gtest/gtest.h>
+#include <garlic/clove.h>
+#include <garlic/parsing/compiled.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "test_utility.h"
+
+using namespace garlic;
+using namespace garlic::parsing;
+using namespace std;
+
+
+static Module compile_and_load(const Module& module) {
+  auto image = dump_compiled_module(module);
+  EXPECT_TRUE(image);
+  auto result = load_compiled_module(image->data(), image->size());
+  EXPECT_TRUE(result);
+  return std::move(*result);
+}
+
+static void assert_same_structure(const Module& module, const Module& loaded) {
+  for (auto it = module.begin_models(); it != module.end_models(); ++it) {
+    auto model = loaded.get_model(it->first);
+    ASSERT_NE(model, nullptr);
+    ASSERT_TRUE(model->frozen());
+    const auto& original = *it->second;
+    ASSERT_EQ(original.properties().field_map.size(), model->properties().field_map.size());
+    ASSERT_EQ(original.annotations().size(), model->annotations().size());
+    for (auto field = original.begin_fields(); field != original.end_fields(); ++field) {
+      auto loaded_field = model->find_field(field->first);
+      ASSERT_NE(loaded_field, model->end_fields());
+      ASSERT_EQ(field->second.required, loaded_field->second.required);
+      ASSERT_EQ(field->second.field->name(), loaded_field->second.field->name());
+      ASSERT_EQ(field->second.field->message(), loaded_field->second.field->message());
+      ASSERT_EQ(
+          field->second.field->properties().constraints.size(),
+          loaded_field->second.field->properties().constraints.size());
+    }
+  }
+  for (auto it = module.begin_fields(); it != module.end_fields(); ++it) {
+    auto field = loaded.get_field(it->first);
+    ASSERT_NE(field, nullptr);
+    NameQueue names;
+    for (const auto& constraint : it->second->properties().constraints) {
+      names.emplace_back(constraint.context().name.data(), constraint.context().name.size());
+    }
+    assert_field_constraints(*field, names);
+  }
+}
+
+TEST(CompiledModule, RoundTrip) {
+  const pair<const char*, vector<pair<const char*, vector<const char*>>>> cases[] = {
+    {"data/special_constraints/", {
+      {"AnyTest", {"any_good1", "any_good2", "any_bad1"}},
+      {"ListTest", {"list_good1", "list_bad1", "list_bad2"}},
+      {"TupleTest", {"tuple_good1", "tuple_bad1", "tuple_bad3", "tuple_bad6"}},
+      {"MapTest", {"map_good1", "map_bad1", "map_bad2", "map_bad3"}},
+      {"AllTest", {"all_good1", "all_bad1", "all_bad2"}},
+      {"LiteralTest", {"literal_good1", "literal_bad1"}},
+      {"EnumTest", {"enum_good1", "enum_good2", "enum_bad1"}},
+    }},
+    {"data/optional_fields/", {
+      {"User", {"good1", "good2", "good3", "bad1", "bad2", "bad3"}},
+      {"Staff", {"good1", "bad1"}},
+    }},
+    {"data/field_constraint/", {
+      {"Account", {"good", "bad1", "bad2"}},
+      {"AccountCustomMessage", {"good", "bad1", "bad2"}},
+    }},
+    {"data/constraint/", {{"User", {"bad1"}}}},
+  };
+
+  for (const auto& [directory, models] : cases) {
+    SCOPED_TRACE(directory);
+    Module module;
+    load_libyaml_module(module, (string(directory) + "module.yaml").data());
+    auto loaded = compile_and_load(module);
+    assert_same_structure(module, loaded);
+
+    for (const auto& [model_name, files] : models) {
+      for (auto file : files) {
+        SCOPED_TRACE(file);
+        auto doc = load_json((string(directory) + file + ".json").data());
+        auto expected = module.get_model(model_name)->validate(doc);
+        auto model = loaded.get_model(model_name);
+        ASSERT_EQ(describe(expected), describe(model->validate(doc)));
+        ASSERT_EQ(expected.is_valid(), model->quick_test(doc));
+      }
+    }
+  }
+}
+
+TEST(CompiledModule, SharedAndRecursive) {
+  Module module;
+  auto node = make_model("Node");
+  auto name = make_field("Name", {make_constraint<regex_tag>("[a-z]+"), make_constraint<range_tag>(1, SIZE_MAX)});
+  name->annotations().emplace("message", "bad name.");
+  node->add_field("name", name);
+  node->add_field("alias", name, false);
+  node->add_field("children", make_field({make_constraint<list_tag>(make_constraint<model_tag>(node), false, 64)}), false);
+  node->add_field("tags", make_field({make_constraint<map_tag>(
+          Constraint::empty(), make_constraint<string_literal_tag>("on"), true)}), false);
+  node->add_field("score", make_field({make_constraint<any_tag>(sequence<Constraint>{
+          make_constraint<int_literal_tag>(-5), make_constraint<double_literal_tag>(0.25),
+          make_constraint<bool_literal_tag>(true), make_constraint<null_literal_tag>(),
+          make_constraint<int64_literal_tag>(-(int64_t{1} << 40)),
+          make_constraint<uint64_literal_tag>(UINT64_MAX)})}), false);
+  node->add_field("named", make_field({make_constraint<field_tag>(name, true)}), false);
+  node->annotations().emplace("description", "a tree.");
+  module.add_model(node);
+  module.add_field(name);
+  module.freeze();
+
+  auto loaded = compile_and_load(module);
+  auto model = loaded.get_model("Node");
+  ASSERT_NE(model, nullptr);
+  ASSERT_EQ(model->annotations().at("description"), text("a tree."));
+
+  // the same field is shared by both keys and the module, the model still refers to itself.
+  auto loaded_name = loaded.get_field("Name");
+  ASSERT_EQ(model->get_field("name"), loaded_name);
+  ASSERT_EQ(model->get_field("alias"), loaded_name);
+  const auto& children = model->get_field("children")->properties().constraints[0];
+  ASSERT_EQ(children.context_for<list_tag>().constraint.context_for<model_tag>().model, model);
+  ASSERT_EQ(children.context_for<list_tag>().parallel_threshold, 64);
+  ASSERT_EQ(loaded_name->properties().constraints[1].context_for<range_tag>().max, SIZE_MAX);
+
+  CloveDocument doc;
+  auto check = [&]() {
+    ASSERT_EQ(describe(node->validate(doc)), describe(model->validate(doc)));
+    ASSERT_EQ(node->quick_test(doc), model->quick_test(doc));
+  };
+  doc.set_object();
+  doc.add_member("name", "root");
+  doc.add_member("score", 0.25);
+  check();
+  doc.add_member_builder("children", [](auto children) {
+      children.set_list();
+      children.push_back_builder([](auto child) {
+          child.set_object();
+          child.add_member("name", "Child");
+          child.add_member("score", -4);
+          child.add_member_builder("tags", [](auto tags) {
+              tags.set_object();
+              tags.add_member("debug", "off");
+              });
+          });
+      children.push_back_builder([](auto child) {
+          child.set_object();
+          child.add_member("name", "wide");
+          child.add_member("score", UINT64_MAX);
+          });
+      });
+  doc.add_member("named", "x1");
+  check();
+}
+
+TEST(CompiledModule, InvalidImages) {
+  Module module;
+  load_libyaml_module(module, "data/special_constraints/module.yaml");
+  auto image = *dump_compiled_module(module);
+
+  auto assert_invalid = [](const string& data) {
+    auto result = load_compiled_module(data.data(), data.size());
+    ASSERT_FALSE(result);
+    ASSERT_EQ(result.error(), GarlicError::InvalidCompiledModule);
+  };
+
+  assert_invalid("");
+  assert_invalid(image.substr(0, image.size() / 2));
+  auto copy = image;
+  copy[0] = 'X';  // magic.
+  assert_invalid(copy);
+  copy = image;
+  copy[8] += 1;  // version.
+  assert_invalid(copy);
+  copy = image;
+  uint32_t pairs = 0x80000001;  // wraps when counted in operands.
+  memcpy(copy.data() + offsetof(compiled::header, module_fields) + offsetof(compiled::span, count), &pairs, sizeof(pairs));
+  assert_invalid(copy);
+
+  // no corruption of the tables can make loading crash.
+  for (size_t position = 16; position < image.size(); position += 7) {
+    copy = image;
+    copy[position] = static_cast<char>(0xff);
+    load_compiled_module(copy.data(), copy.size());
+  }
+
+  // unaligned images still load.
+  string unaligned = " " + image;
+  ASSERT_TRUE(load_compiled_module(unaligned.data() + 1, image.size()));
+}
+
+TEST(CompiledModule, File) {
+  Module module;
+  load_libyaml_module(module, "data/optional_fields/module.yaml");
+
+  char path[] = "/tmp/garlic_compiled_XXXXXX";
+  auto descriptor = mkstemp(path);
+  ASSERT_GE(descriptor, 0);
+  auto file = fdopen(descriptor, "wb");
+  ASSERT_TRUE(dump_compiled_module(module, file));
+  fclose(file);
+
+  auto loaded = load_compiled_module(path);
+  remove(path);
+  ASSERT_TRUE(loaded);
+  assert_same_structure(module, *loaded);
+
+  auto missing = load_compiled_module(path);
+  ASSERT_FALSE(missing);
+  ASSERT_EQ(missing.error(), std::errc::no_such_file_or_directory);
+}
+
+TEST(CompiledModule, UnresolvedField) {
+  Module module;
+  auto model = make_model("User");
+  model->add_field("id", make_field({
+        make_constraint<field_tag>(std::make_shared<field_tag::Context::field_pointer>(nullptr))}));
+  module.add_model(model);
+
+  auto image = dump_compiled_module(module);
+  ASSERT_FALSE(image);
+  ASSERT_EQ(image.error(), GarlicError::UndefinedObject);
+
+  auto file = tmpfile();
+  ASSERT_FALSE(dump_compiled_module(module, file));
+  fclose(file);
+}
@@ -113,3 +113,14 @@ TEST(Constraints, LiteralConstraint) {
   auto result = validate_jsonfile(module, "LiteralTest", "data/special_constraints/literal_bad1.json");
   ASSERT_EQ(result.details.size(), 6);
 }
+
+TEST(Constraints, EnumConstraint) {
+  Module module;
+  load_libyaml_module(module, "data/special_constraints/module.yaml");
+
+  assert_jsonfile_valid(module, "EnumTest", "data/special_constraints/enum_good1.json");
+  assert_jsonfile_valid(module, "EnumTest", "data/special_constraints/enum_good2.json");
+
+  auto result = validate_jsonfile(module, "EnumTest", "data/special_constraints/enum_bad1.json");
+  ASSERT_EQ(result.details.size(), 4);
+}
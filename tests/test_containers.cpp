@@ -80,6 +80,7 @@ TEST(GarlicText, StaticCopyConstructors) {
   ASSERT_STREQ(txt1.data(), str1);
   ASSERT_NE(txt1, txt2);
   ASSERT_EQ(txt2.size(), 4);
+  ASSERT_STREQ(txt2.data(), "Text");
   ASSERT_FALSE(txt2.is_view());
 
   // std::string
@@ -93,6 +94,8 @@ TEST(GarlicText, StaticCopyConstructors) {
   auto txt4 = text::copy(str4);
   ASSERT_FALSE(txt4.is_view());
   ASSERT_EQ(str4, txt4);
+  auto txt7 = text::copy(str4.substr(0, 4));
+  ASSERT_STREQ(txt7.data(), "Text");
 
   // another text
   auto txt5 = "Text 5";
@@ -167,6 +170,24 @@ TEST(GarlicSequence, MoveOperators) {
   ASSERT_EQ(another_one.size(), 1);
 }
 
+TEST(GarlicSequence, Clear) {
+  sequence<text> names(2);
+  names.push_back(text::copy("a"));
+  names.push_back(text::copy("b"));
+  names.push_back(text::copy("c"));
+  auto capacity = names.capacity();
+  names.clear();
+  ASSERT_TRUE(names.empty());
+  ASSERT_EQ(names.capacity(), capacity);
+  names.push_back(text::copy("d"));
+  ASSERT_EQ(names.size(), 1);
+  ASSERT_EQ(names[0], text("d"));
+
+  auto empty = sequence<text>::no_sequence();
+  empty.clear();
+  ASSERT_TRUE(empty.empty());
+}
+
 TEST(GarlicSequence, PushFront) {
   sequence<double> one(4);
   one.push_back(3);
@@ -203,3 +224,41 @@ TEST(GarlicSequence, ListInitializer) {
   ASSERT_EQ(ints[3], 5);
   ASSERT_EQ(ints[4], 8);
 }
+
+TEST(GarlicPerfectMap, Basic) {
+  perfect_map<int> map;
+  ASSERT_EQ(map.find("missing"), nullptr);
+  map.build();
+  ASSERT_EQ(map.find("missing"), nullptr);
+
+  map.emplace("first", 1);
+  map.emplace("second", 2);
+  map.emplace("first", 3);  // duplicates are dropped.
+  map.emplace("", 4);
+  map.build();
+  ASSERT_EQ(map.size(), 3);
+  ASSERT_EQ(*map.find("first"), 1);
+  ASSERT_EQ(*map.find("second"), 2);
+  ASSERT_EQ(*map.find(""), 4);
+  ASSERT_EQ(map.find("firs"), nullptr);
+  ASSERT_EQ(map.find("first_"), nullptr);
+  ASSERT_EQ(map.find_position("second"), 1);
+  ASSERT_EQ(map.key(2), "");
+}
+
+TEST(GarlicPerfectMap, ManyKeys) {
+  perfect_map<size_t> map;
+  for (size_t i = 0; i < 5000; ++i) map.emplace("key_" + std::to_string(i), i);
+  map.build();
+  for (size_t i = 0; i < 5000; ++i) {
+    auto key = "key_" + std::to_string(i);
+    ASSERT_EQ(map.find_position(key), i);
+    ASSERT_EQ(*map.find(key), i);
+    ASSERT_EQ(map.key(i), key);
+  }
+  ASSERT_EQ(map.find("key_5000"), nullptr);
+  ASSERT_EQ(map.find("key_"), nullptr);
+
+  auto copy = map;
+  ASSERT_EQ(*copy.find("key_4999"), 4999);
+}
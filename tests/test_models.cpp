@@ -1,4 +1,7 @@
 #include <gtest/gtest.h>
+#include <garlic/clove.h>
+#include <string>
+#include <unordered_set>
 
 #include "test_utility.h"
 
@@ -24,3 +27,118 @@ TEST(Field, Basic) {
   field1->add_constraint<regex_tag>("\\d{1,3}", "c1");
   ASSERT_EQ(field1->begin_constraints()->context().name, text("c1"));
 }
+
+TEST(Model, Freeze) {
+  auto model = make_model("User");
+  model->add_field("name", make_field({make_constraint<regex_tag>("\\w{3,12}")}));
+  model->add_field("score", make_field({make_constraint<type_tag>(TypeFlag::Integer)}), false);
+  ASSERT_FALSE(model->frozen());
+
+  CloveDocument doc;
+  doc.set_object();
+  doc.add_member("name", "Peyman");
+  doc.add_member("score", "not a number");
+
+  auto assert_results = [&doc](const auto& model) {
+    ASSERT_FALSE(model->quick_test(doc));
+    auto result = model->validate(doc);
+    ASSERT_FALSE(result.is_valid());
+    ASSERT_EQ(result.details.size(), 1);
+    ASSERT_STREQ(result.details[0].name.data(), "score");
+  };
+
+  assert_results(model);
+  model->freeze();
+  ASSERT_TRUE(model->frozen());
+  assert_results(model);
+
+  (*doc.find_member("score")).value.set_int(12);
+  ASSERT_TRUE(model->quick_test(doc));
+  ASSERT_TRUE(model->validate(doc).is_valid());
+
+  // adding a field drops the frozen table until the model gets frozen again.
+  model->add_field("id", make_field({make_constraint<type_tag>(TypeFlag::Integer)}));
+  ASSERT_FALSE(model->frozen());
+  ASSERT_FALSE(model->quick_test(doc));
+  model->freeze();
+  ASSERT_FALSE(model->quick_test(doc));
+  doc.add_member("id", 1);
+  ASSERT_TRUE(model->quick_test(doc));
+  ASSERT_TRUE(model->validate(doc).is_valid());
+}
+
+TEST(Model, FrozenRequiredFields) {
+  // wide enough to spill the matched field set out of its inline storage.
+  auto model = make_model("Wide");
+  auto field = make_field({make_constraint<type_tag>(TypeFlag::Integer)});
+  for (int i = 0; i < 300; ++i) {
+    model->add_field(text::copy("field" + std::to_string(i)), field, i % 3 == 0);
+  }
+  model->freeze();
+
+  CloveDocument doc;
+  doc.set_object();
+  for (int i = 0; i < 300; ++i) {
+    if (i == 151 || i == 299) continue;
+    doc.add_member(text::copy("field" + std::to_string(i)), i);
+  }
+  ASSERT_TRUE(model->quick_test(doc));
+  ASSERT_TRUE(model->validate(doc).is_valid());
+
+  doc.erase_member(doc.find_member("field0"));
+  doc.erase_member(doc.find_member("field297"));
+  ASSERT_FALSE(model->quick_test(doc));
+  auto result = model->validate(doc);
+  ASSERT_FALSE(result.is_valid());
+  ASSERT_EQ(result.details.size(), 2);
+  std::unordered_set<std::string> missing;
+  for (const auto& detail : result.details) {
+    ASSERT_STREQ(detail.reason.data(), "missing required field!");
+    missing.emplace(detail.name.data(), detail.name.size());
+  }
+  ASSERT_TRUE(missing.count("field0"));
+  ASSERT_TRUE(missing.count("field297"));
+}
+
+TEST(Model, ArenaResults) {
+  auto item = make_model("Item");
+  item->add_field("name", make_field({make_constraint<type_tag>(TypeFlag::String)}));
+  auto model = make_model("Order");
+  model->add_field("items", make_field({make_constraint<list_tag>(make_constraint<model_tag>(item))}));
+  model->add_field("id", make_field({make_constraint<type_tag>(TypeFlag::Integer)}));
+
+  CloveDocument doc;
+  doc.set_object();
+  doc.add_member_builder("items", [](auto items) {
+      items.set_list();
+      items.push_back_builder([](auto item) { item.set_object(); item.add_member("name", "a"); });
+      items.push_back_builder([](auto item) { item.set_object(); item.add_member("name", 2); });
+      });
+
+  ArenaAllocator arena(256);  // small chunks so the tree spans a few of them.
+  auto expected = describe(model->validate(doc));
+  for (int round = 0; round < 3; ++round) {
+    {
+      auto result = model->validate(doc, arena);
+      ASSERT_FALSE(result.is_valid());
+      ASSERT_EQ(expected, describe(result));
+      ASSERT_TRUE(result.name.is_view());  // names live in the arena.
+      ASSERT_EQ(internal::result_arena, nullptr);
+    }
+    arena.reset();
+  }
+
+  auto field = model->get_field("id");
+  CloveDocument text_value;
+  text_value.set_string("x");
+  {
+    auto result = field->validate(text_value, arena);
+    ASSERT_EQ(result.failures.size(), 1);
+    auto constraint = field->properties().constraints[0].test(text_value, arena);
+    ASSERT_EQ(describe(constraint), describe(result.failures[0]));
+  }
+  arena.reset();
+
+  // results made outside of the arena are left alone.
+  ASSERT_EQ(expected, describe(model->validate(doc)));
+}
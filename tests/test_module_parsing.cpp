@@ -23,6 +23,7 @@ TEST(ModuleParsing, Basic) {
 
     auto user_model = module.get_model("User");
     ASSERT_NE(user_model, nullptr);
+    ASSERT_TRUE(user_model->frozen());
     assert_model_fields(*user_model, {"first_name", "last_name", "birthdate", "registration_date"});
 
     assert_module_structure(module, {
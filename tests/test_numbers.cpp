@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <garlic/parsing/numbers.h>
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+
+using namespace garlic::parsing;
+using namespace std;
+
+static bool same_bits(double a, double b) {
+  return memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+TEST(NumberParsing, Integers) {
+  int value;
+  ASSERT_TRUE(ParseInt("0", value)); ASSERT_EQ(value, 0);
+  ASSERT_TRUE(ParseInt("-0", value)); ASSERT_EQ(value, 0);
+  ASSERT_TRUE(ParseInt("0042", value)); ASSERT_EQ(value, 42);
+  ASSERT_TRUE(ParseInt("123456789", value)); ASSERT_EQ(value, 123456789);
+  ASSERT_TRUE(ParseInt("2147483647", value)); ASSERT_EQ(value, INT32_MAX);
+  ASSERT_TRUE(ParseInt("-2147483648", value)); ASSERT_EQ(value, INT32_MIN);
+  ASSERT_FALSE(ParseInt("2147483648", value));
+  ASSERT_FALSE(ParseInt("4294967295", value));
+  ASSERT_FALSE(ParseInt("-2147483649", value));
+
+  for (auto input : {"", "-", "+1", "1.0", "1e3", "12a", " 1", "--1"}) {
+    ASSERT_FALSE(ParseInt(input, value)) << input;
+  }
+
+  // the length is honored, nothing past it is read.
+  ASSERT_TRUE(ParseInt("1234567890", 4, value)); ASSERT_EQ(value, 1234);
+}
+
+TEST(NumberParsing, WideIntegers) {
+  int64_t value;
+  uint64_t unsigned_value;
+  ASSERT_TRUE(ParseInt("9223372036854775807", value)); ASSERT_EQ(value, INT64_MAX);
+  ASSERT_TRUE(ParseInt("-9223372036854775808", value)); ASSERT_EQ(value, INT64_MIN);
+  ASSERT_FALSE(ParseInt("9223372036854775808", value));
+  ASSERT_TRUE(ParseInt("0000000000000000000000001234567890123", value)); ASSERT_EQ(value, 1234567890123);
+  ASSERT_TRUE(ParseInt("18446744073709551615", unsigned_value)); ASSERT_EQ(unsigned_value, UINT64_MAX);
+  ASSERT_FALSE(ParseInt("18446744073709551616", unsigned_value));
+  ASSERT_FALSE(ParseInt("99999999999999999999", unsigned_value));
+  ASSERT_FALSE(ParseInt("123456789012345678901", unsigned_value));
+  ASSERT_FALSE(ParseInt("-1", unsigned_value));
+
+  mt19937_64 generator(7);
+  char buffer[32];
+  for (int i = 0; i < 10000; ++i) {
+    auto expected = static_cast<int64_t>(generator() >> (generator() % 64));
+    if (i % 2) expected = -expected;
+    snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(expected));
+    ASSERT_TRUE(ParseInt(buffer, value)) << buffer;
+    ASSERT_EQ(value, expected);
+  }
+}
+
+TEST(NumberParsing, Doubles) {
+  double value;
+  ASSERT_TRUE(ParseDouble("1", value)); ASSERT_EQ(value, 1.0);
+  ASSERT_TRUE(ParseDouble("-2.5", value)); ASSERT_EQ(value, -2.5);
+  ASSERT_TRUE(ParseDouble(".5", value)); ASSERT_EQ(value, 0.5);
+  ASSERT_TRUE(ParseDouble("1e3", value)); ASSERT_EQ(value, 1000.0);
+  ASSERT_TRUE(ParseDouble("6.02E+23", value)); ASSERT_EQ(value, 6.02e23);
+  ASSERT_TRUE(ParseDouble("1e-400", value)); ASSERT_EQ(value, 0.0);
+  ASSERT_TRUE(ParseDouble("-0.0", value)); ASSERT_TRUE(signbit(value));
+  ASSERT_TRUE(ParseDouble("0.1", value)); ASSERT_TRUE(same_bits(value, 0.1));
+  ASSERT_TRUE(ParseDouble("1.7976931348623157e308", value)); ASSERT_EQ(value, numeric_limits<double>::max());
+  ASSERT_TRUE(ParseDouble("4.9e-324", value)); ASSERT_EQ(value, numeric_limits<double>::denorm_min());
+  // long mantissas that are too small become zero as well, with their sign.
+  ASSERT_TRUE(ParseDouble("1.2345678901234567890e-400", value)); ASSERT_EQ(value, 0.0); ASSERT_FALSE(signbit(value));
+  ASSERT_TRUE(ParseDouble("-1.2345678901234567890e-400", value)); ASSERT_EQ(value, 0.0); ASSERT_TRUE(signbit(value));
+  ASSERT_TRUE(ParseDouble("0.000000000000000000012345678901234567890e-330", value)); ASSERT_EQ(value, 0.0);
+  // halfway between two doubles, both ways of rounding to even.
+  ASSERT_TRUE(ParseDouble("9007199254740993", value)); ASSERT_EQ(value, 9007199254740992.0);
+  ASSERT_TRUE(ParseDouble("9007199254740995", value)); ASSERT_EQ(value, 9007199254740996.0);
+  // too many digits for the fast path.
+  ASSERT_TRUE(ParseDouble("3.14159265358979323846264338327950288", value)); ASSERT_TRUE(same_bits(value, 3.141592653589793));
+
+  for (auto input : {"", "-", ".", "1.", "e3", "1e", "1e+", "+1", "1x", " 1", "1e400", "--1", "-.e1",
+                      "1.2345678901234567890e400", "-1234567890123456789012345e290"}) {
+    ASSERT_FALSE(ParseDouble(input, value)) << input;
+  }
+}
+
+TEST(NumberParsing, DoublesRoundLikeFromChars) {
+  mt19937_64 generator(7);
+  char buffer[64];
+  auto check = [&buffer](int length) {
+    double expected, value;
+    auto [last, error] = from_chars(buffer, buffer + length, expected);
+    if (error != errc() || last != buffer + length) return;
+    ASSERT_TRUE(ParseDouble(buffer, length, value)) << buffer;
+    ASSERT_TRUE(same_bits(value, expected)) << buffer;
+  };
+  for (int i = 0; i < 20000; ++i) {
+    auto bits = generator();
+    double random;
+    memcpy(&random, &bits, sizeof(double));
+    if (!isfinite(random)) continue;
+    check(snprintf(buffer, sizeof(buffer), "%.*g", static_cast<int>(generator() % 17) + 1, random));
+    check(snprintf(buffer, sizeof(buffer), "%.17g", random));
+    check(snprintf(buffer, sizeof(buffer), "%llue%d",
+          static_cast<unsigned long long>(generator() >> (generator() % 64)), static_cast<int>(generator() % 700) - 350));
+    check(snprintf(buffer, sizeof(buffer), "%llu.%llu",
+          static_cast<unsigned long long>(generator() % 100000000000), static_cast<unsigned long long>(generator())));
+  }
+}
@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+#include <garlic/batch.h>
+#include <garlic/clove.h>
+#include <garlic/constraints.h>
+#include <garlic/parallel.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "test_utility.h"
+
+using namespace garlic;
+using namespace std;
+
+
+TEST(ThreadPool, Run) {
+  ThreadPool pool(4);
+  ASSERT_EQ(pool.concurrency(), 4);
+
+  vector<atomic<int>> counts(1000);
+  pool.run(counts.size(), [&counts](size_t part) { ++counts[part]; });
+  for (const auto& count : counts) ASSERT_EQ(count.load(), 1);
+
+  // jobs started from within other jobs finish too.
+  atomic<int> total = 0;
+  pool.run(8, [&pool, &total](size_t) {
+      pool.run(100, [&total](size_t) { ++total; });
+      });
+  ASSERT_EQ(total.load(), 800);
+
+  ThreadPool single(1);
+  single.run(3, [&total](size_t) { ++total; });
+  ASSERT_EQ(total.load(), 803);
+}
+
+TEST(ThreadPool, FindFirstFailure) {
+  ThreadPool pool(4);
+  for (size_t failure : {0, 1, 255, 256, 4000, 9999}) {
+    // every index from the failure on fails, only the lowest one counts.
+    auto result = pool.find_first_failure(10000, 256, [failure](size_t index) { return index < failure; });
+    ASSERT_EQ(result, failure);
+  }
+  ASSERT_EQ(pool.find_first_failure(10000, 256, [](size_t index) { return index % 3000 != 2999; }), 2999);
+  ASSERT_EQ(pool.find_first_failure(10000, 256, [](size_t) { return true; }), 10000);
+  ASSERT_EQ(pool.find_first_failure(0, 256, [](size_t) { return false; }), 0);
+}
+
+TEST(ThreadPool, SkewedParts) {
+  // the first thread gets all the expensive parts, the others steal them.
+  ThreadPool pool(4);
+  vector<atomic<int>> counts(64);
+  pool.run(counts.size(), [&counts](size_t part) {
+      if (part < 16) this_thread::sleep_for(chrono::milliseconds(1));
+      ++counts[part];
+      });
+  for (const auto& count : counts) ASSERT_EQ(count.load(), 1);
+}
+
+TEST(Batch, Validate) {
+  auto model = make_model("Item");
+  model->add_field("id", make_field({make_constraint<type_tag>(TypeFlag::Integer)}));
+  model->add_field("tags", make_field({make_constraint<list_tag>(make_constraint<type_tag>(TypeFlag::String))}), false);
+
+  vector<CloveDocument> documents(200);
+  for (size_t index = 0; index < documents.size(); ++index) {
+    auto& doc = documents[index];
+    doc.set_object();
+    if (index % 7) doc.add_member("id", static_cast<int>(index));
+    doc.add_member_builder("tags", [index](auto tags) {
+        tags.set_list();
+        // a few documents are much larger than the others.
+        for (size_t tag = 0; tag < (index % 50 ? 2 : 5000); ++tag) tags.push_back("tag");
+        if (index % 11 == 0) tags.push_back(1);
+        });
+  }
+
+  ThreadPool pool(4);
+  auto results = validate_batch(*model, documents, pool);
+  ASSERT_EQ(results.size(), documents.size());
+  for (size_t index = 0; index < documents.size(); ++index) {
+    SCOPED_TRACE(index);
+    ASSERT_EQ(describe(model->validate(documents[index])), describe(results[index]));
+    ASSERT_EQ(results[index].is_valid(), index % 7 && index % 11);
+  }
+
+  ASSERT_TRUE(validate_batch(*model, vector<CloveDocument>{}).empty());
+}
+
+TEST(ListConstraint, Parallel) {
+  auto serial = make_constraint<list_tag>(make_constraint<type_tag>(TypeFlag::Integer));
+  auto parallel = make_constraint<list_tag>(make_constraint<type_tag>(TypeFlag::Integer), false, 100);
+  auto quiet = make_constraint<list_tag>(make_constraint<type_tag>(TypeFlag::Integer), true, 100);
+  auto quiet_serial = make_constraint<list_tag>(make_constraint<type_tag>(TypeFlag::Integer), true);
+
+  CloveDocument doc;
+  doc.set_list();
+  for (int i = 0; i < 5000; ++i) doc.push_back(i);
+  ASSERT_TRUE(parallel.quick_test(doc));
+  ASSERT_TRUE(parallel.test(doc).is_valid());
+
+  // strings at 3000 and 1200, the result points at the lowest one just like the serial one.
+  CloveDocument bad;
+  bad.set_list();
+  for (int i = 0; i < 5000; ++i) {
+    if (i == 1200 || i == 3000) bad.push_back("x");
+    else bad.push_back(i);
+  }
+  ASSERT_FALSE(parallel.quick_test(bad));
+  ASSERT_EQ(describe(serial.test(bad)), describe(parallel.test(bad)));
+  ASSERT_EQ(describe(quiet_serial.test(bad)), describe(quiet.test(bad)));
+  ASSERT_EQ(parallel.test(bad).details[0].name, text("1200"));
+
+  // lists below the threshold stay serial.
+  CloveDocument small;
+  small.set_list();
+  small.push_back(1);
+  small.push_back("x");
+  ASSERT_EQ(describe(serial.test(small)), describe(parallel.test(small)));
+}
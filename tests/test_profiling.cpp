@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include <garlic/clove.h>
+#include <garlic/constraints.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+using namespace garlic;
+using namespace std;
+
+
+static const profiling::entry* find_entry(
+    const vector<profiling::entry>& entries, profiling::scope kind, const char* name) {
+  for (const auto& item : entries) {
+    if (item.kind == kind && item.name == name) return &item;
+  }
+  return nullptr;
+}
+
+TEST(Profiling, Counters) {
+  auto model = make_model("User");
+  model->add_field("id", make_field("Id", {make_constraint<type_tag>(TypeFlag::Integer, "id_type")}));
+  model->add_field("age", make_field("Age", {make_constraint<range_tag>(0, 150, "age_range")}), false);
+
+  CloveDocument good;
+  good.set_object();
+  good.add_member("id", 1);
+  good.add_member("age", 30);
+
+  CloveDocument bad;
+  bad.set_object();
+  bad.add_member("id", "one");
+
+  profiling::reset();
+  ASSERT_TRUE(model->quick_test(good));
+  ASSERT_FALSE(model->validate(bad).is_valid());
+
+  // the counters of other threads are part of the report.
+  thread([&model, &good]() { ASSERT_TRUE(model->validate(good).is_valid()); }).join();
+
+  auto entries = profiling::report();
+  auto user = find_entry(entries, profiling::scope::model, "User");
+  ASSERT_NE(nullptr, user);
+  ASSERT_EQ(3, user->calls);
+  ASSERT_EQ(1, user->failures);
+
+  auto id = find_entry(entries, profiling::scope::constraint, "id_type");
+  ASSERT_NE(nullptr, id);
+  ASSERT_EQ(3, id->calls);
+  ASSERT_EQ(1, id->failures);
+
+  auto age = find_entry(entries, profiling::scope::field, "Age");
+  ASSERT_NE(nullptr, age);
+  ASSERT_EQ(2, age->calls);
+  ASSERT_EQ(0, age->failures);
+
+  // the model includes the time of its fields and ranks above them.
+  ASSERT_GE(user->nanoseconds, age->nanoseconds);
+  for (size_t index = 1; index < entries.size(); ++index) {
+    ASSERT_GE(entries[index - 1].nanoseconds, entries[index].nanoseconds);
+  }
+
+  stringstream output;
+  profiling::dump(output, 2);
+  auto table = output.str();
+  ASSERT_NE(string::npos, table.find("User"));
+  ASSERT_EQ(3, count(table.begin(), table.end(), '\n'));
+
+  profiling::reset();
+  ASSERT_TRUE(profiling::report().empty());
+}
@@ -0,0 +1,251 @@
+#include <gtest/gtest.h>
+#include <garlic/clove.h>
+#include <garlic/program.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "test_utility.h"
+
+using namespace garlic;
+using namespace std;
+
+
+static CloveDocument load_yaml(const char* data) {
+  CloveDocument doc;
+  adapters::libyaml::load(data, doc);
+  return doc;
+}
+
+TEST(Program, Models) {
+  const pair<const char*, vector<pair<const char*, vector<const char*>>>> cases[] = {
+    {"data/special_constraints/", {
+      {"AnyTest", {"any_good1", "any_good2", "any_bad1"}},
+      {"ListTest", {"list_good1", "list_bad1", "list_bad2"}},
+      {"TupleTest", {
+        "tuple_good1", "tuple_good2", "tuple_bad1", "tuple_bad2",
+        "tuple_bad3", "tuple_bad4", "tuple_bad5", "tuple_bad6"}},
+      {"MapTest", {"map_good1", "map_bad1", "map_bad2", "map_bad3"}},
+      {"AllTest", {"all_good1", "all_bad1", "all_bad2"}},
+      {"LiteralTest", {"literal_good1", "literal_bad1"}},
+      {"EnumTest", {"enum_good1", "enum_good2", "enum_bad1"}},
+    }},
+    {"data/optional_fields/", {
+      {"User", {"good1", "good2", "good3", "bad1", "bad2", "bad3"}},
+      {"Staff", {"good1", "good2", "good3", "bad1", "bad2", "bad3"}},
+    }},
+    {"data/field_constraint/", {
+      {"Account", {"good", "bad1", "bad2"}},
+      {"AccountCustomMessage", {"good", "bad1", "bad2"}},
+    }},
+    {"data/constraint/", {{"User", {"bad1"}}}},
+  };
+
+  for (const auto& [directory, models] : cases) {
+    SCOPED_TRACE(directory);
+    Module module;
+    load_libyaml_module(module, (string(directory) + "module.yaml").data());
+    for (const auto& [model_name, files] : models) {
+      auto model = module.get_model(model_name);
+      auto program = Program::compile(model);
+      for (auto file : files) {
+        SCOPED_TRACE(file);
+        auto doc = load_json((string(directory) + file + ".json").data());
+        ASSERT_EQ(model->quick_test(doc), program.quick_test(doc));
+        assert_same_result(model->validate(doc), program.test(doc));
+      }
+    }
+  }
+}
+
+TEST(Program, Constraints) {
+  auto name = make_field("Name", {make_constraint<type_tag>(TypeFlag::String), make_constraint<regex_tag>("[a-z]+")});
+  const Constraint constraints[] = {
+    make_constraint<type_tag>(TypeFlag::Integer),
+    make_constraint<range_tag>(2, 4),
+    make_constraint<regex_tag>("\\d+"),
+    make_constraint<any_tag>(sequence<Constraint>{
+        make_constraint<int_literal_tag>(-3), make_constraint<double_literal_tag>(1.5),
+        make_constraint<bool_literal_tag>(false), make_constraint<null_literal_tag>(),
+        make_constraint<string_literal_tag>("on")}),
+    make_constraint<enum_tag>(vector<string>{"on", "abc", "123"}, vector<int64_t>{-3, 12}),
+    make_constraint<enum_tag>(enum_tag::values_type{
+        .strings = {"abc"}, .integers = {12}, .large_integers = {UINT64_MAX}, .doubles = {1.5, -0.0},
+        .booleans = {false}, .null = true}),
+    make_constraint<list_tag>(make_constraint<range_tag>(1, 3)),
+    make_constraint<tuple_tag>(sequence<Constraint>{
+        make_constraint<type_tag>(TypeFlag::String), make_constraint<type_tag>(TypeFlag::Integer)}),
+    make_constraint<tuple_tag>(sequence<Constraint>{make_constraint<type_tag>(TypeFlag::String)}, false),
+    make_constraint<map_tag>(make_constraint<regex_tag>("[a-z]+"), make_constraint<type_tag>(TypeFlag::Integer)),
+    make_constraint<map_tag>(Constraint::empty(), make_constraint<range_tag>(0, 2)),
+    make_constraint<all_tag>(sequence<Constraint>{
+        make_constraint<type_tag>(TypeFlag::List), make_constraint<range_tag>(0, 2)}),
+    make_constraint<field_tag>(name),
+  };
+  const char* documents[] = {
+    "12", "-3", "1.5", "2.5", "0.0", "18446744073709551615", "false", "true", "null", "on", "off", "'123'",
+    "abc", "ab", "abcde",
+    "[]", "[1, 2]", "[1, 2, 3, 4, 5]", "[x, 1]", "[x, y]", "[x]", "[x, 1, 2]", "[[1], 'ab']",
+    "{}", "{a: 1}", "{a: x}", "{A: 1}", "{a: [1, 2, 3]}",
+  };
+
+  for (const auto& constraint : constraints) {
+    auto program = Program::compile(constraint);
+    for (auto document : documents) {
+      SCOPED_TRACE(document);
+      auto doc = load_yaml(document);
+      ASSERT_EQ(constraint.quick_test(doc), program.quick_test(doc)) << as_string(constraint.context().name);
+      assert_same_result(constraint.test(doc), program.test(doc));
+    }
+  }
+
+  // comparisons with NaN fail, so the range lets it through.
+  CloveDocument nan;
+  nan.set_double(NAN);
+  auto range = make_constraint<range_tag>(2, 4);
+  ASSERT_EQ(range.quick_test(nan), Program::compile(range).quick_test(nan));
+  ASSERT_EQ(make_constraint<double_literal_tag>(NAN).quick_test(nan),
+            Program::compile(make_constraint<double_literal_tag>(NAN)).quick_test(nan));
+}
+
+TEST(Program, WideIntegers) {
+  const int64_t large = int64_t{1} << 40;
+  const size_t precise = (size_t{1} << 53) + 3;  // rounds up to the next integer as a double.
+  const Constraint constraints[] = {
+    make_constraint<type_tag>(TypeFlag::Int64),
+    make_constraint<type_tag>(TypeFlag::UInt64),
+    make_constraint<range_tag>(2, static_cast<size_t>(large)),
+    make_constraint<range_tag>(0, precise),
+    make_constraint<int64_literal_tag>(-large),
+    make_constraint<int64_literal_tag>(12),
+    make_constraint<uint64_literal_tag>(UINT64_MAX),
+  };
+  const char* documents[] = {
+    "12", "-3", "1099511627776", "1099511627777", "-1099511627776",
+    "18446744073709551615", "18446744073709551616", "1.5", "abc", "[1, 2]",
+    "9007199254740995", "9007199254740996", "-9007199254740996",
+  };
+
+  for (const auto& constraint : constraints) {
+    auto program = Program::compile(constraint);
+    for (auto document : documents) {
+      SCOPED_TRACE(document);
+      auto doc = load_yaml(document);
+      ASSERT_EQ(constraint.quick_test(doc), program.quick_test(doc)) << as_string(constraint.context().name);
+      assert_same_result(constraint.test(doc), program.test(doc));
+    }
+  }
+
+  ASSERT_TRUE(make_constraint<uint64_literal_tag>(UINT64_MAX).quick_test(load_yaml("18446744073709551615")));
+  ASSERT_TRUE(make_constraint<range_tag>(2, static_cast<size_t>(large)).quick_test(load_yaml("1099511627776")));
+  ASSERT_FALSE(make_constraint<range_tag>(2, static_cast<size_t>(large)).quick_test(load_yaml("1099511627777")));
+  ASSERT_FALSE(make_constraint<type_tag>(TypeFlag::Int64).quick_test(load_yaml("18446744073709551615")));
+  ASSERT_TRUE(make_constraint<range_tag>(0, precise).quick_test(load_yaml("9007199254740995")));
+  ASSERT_FALSE(make_constraint<range_tag>(0, precise).quick_test(load_yaml("9007199254740996")));
+  ASSERT_FALSE(make_constraint<range_tag>(0, precise).test(load_yaml("9007199254740996")).is_valid());
+  ASSERT_FALSE(Program::compile(make_constraint<range_tag>(0, precise)).quick_test(load_yaml("9007199254740996")));
+  ASSERT_FALSE(make_constraint<range_tag>(0, precise).quick_test(load_yaml("-3")));
+}
+
+TEST(Program, RecursiveModel) {
+  auto node = make_model("Node");
+  node->add_field("name", make_field({make_constraint<type_tag>(TypeFlag::String)}));
+  node->add_field("children", make_field({make_constraint<list_tag>(make_constraint<model_tag>(node))}), false);
+  auto program = Program::compile(node);
+
+  auto good = load_yaml("{name: root, children: [{name: a}, {name: b, children: [{name: c, extra: 1}]}]}");
+  ASSERT_TRUE(program.quick_test(good));
+  assert_same_result(node->validate(good), program.test(good));
+
+  auto bad = load_yaml("{name: root, children: [{name: a}, {name: b, children: [{children: []}]}]}");
+  ASSERT_FALSE(program.quick_test(bad));
+  assert_same_result(node->validate(bad), program.test(bad));
+
+  // the program keeps the graph alive.
+  weak_ptr<Model> weak = node;
+  node.reset();
+  ASSERT_FALSE(weak.expired());
+  ASSERT_TRUE(program.quick_test(load_yaml("{name: x}")));
+}
+
+TEST(Program, WideModel) {
+  auto model = make_model("Wide");
+  auto field = make_field({make_constraint<type_tag>(TypeFlag::Integer)});
+  for (int i = 0; i < 300; ++i) model->add_field(text::copy("field" + to_string(i)), field, i % 3 == 0);
+  auto program = Program::compile(model);
+
+  CloveDocument doc;
+  doc.set_object();
+  for (int i = 0; i < 300; i += 3) doc.add_member(text::copy("field" + to_string(i)), i);
+  ASSERT_TRUE(program.quick_test(doc));
+
+  doc.get_reference().add_member("field1", "not a number");
+  ASSERT_FALSE(program.quick_test(doc));
+  ASSERT_EQ(model->quick_test(doc), program.quick_test(doc));
+
+  CloveDocument missing;
+  missing.set_object();
+  for (int i = 0; i < 297; i += 3) missing.add_member(text::copy("field" + to_string(i)), i);
+  ASSERT_FALSE(program.quick_test(missing));
+  assert_same_result(model->validate(missing), program.test(missing));
+}
+
+TEST(Program, FailureTrace) {
+  auto item = make_model("Item");
+  item->add_field("name", make_field("Name", {make_constraint<type_tag>(TypeFlag::String)}));
+  item->add_field("size", make_field({make_constraint<range_tag>(1, 10, "size_range")}), false);
+  auto order = make_model("Order");
+  order->add_field("items", make_field({make_constraint<list_tag>(make_constraint<model_tag>(item))}));
+  order->add_field("point", make_field({make_constraint<tuple_tag>(sequence<Constraint>{
+          make_constraint<type_tag>(TypeFlag::Integer), make_constraint<type_tag>(TypeFlag::Integer)})}), false);
+  order->add_field("tags", make_field({make_constraint<map_tag>(
+          Constraint::empty(), make_constraint<regex_tag>("[a-z]+", "tag", "bad tag."))}), false);
+  auto program = Program::compile(order);
+
+  FailureTrace trace;
+  auto good = load_yaml("{items: [{name: a}, {name: b, size: 3}], point: [1, 2], tags: {x: abc}}");
+  ASSERT_TRUE(program.trace(good, trace));
+  ASSERT_FALSE(trace.failed());
+  ASSERT_TRUE(trace.result().is_valid());
+
+  auto assert_trace = [&](const char* document, const char* path, const char* name, const char* reason) {
+    SCOPED_TRACE(document);
+    auto doc = load_yaml(document);
+    ASSERT_FALSE(program.trace(doc, trace));
+    ASSERT_TRUE(trace.failed());
+    ASSERT_EQ(path, trace.path());
+    ASSERT_EQ(name, as_string(trace.name()));
+    ASSERT_EQ(reason, as_string(trace.reason()));
+
+    // the result nests a field for every segment of the path.
+    auto result = trace.result();
+    for (size_t depth = 0; depth < trace.depth(); ++depth) {
+      ASSERT_TRUE(result.is_field());
+      ASSERT_EQ(1, result.details.size());
+      auto segment = trace.at(depth);
+      ASSERT_EQ(segment.is_index() ? to_string(segment.index) : string(segment.key), as_string(result.name));
+      auto inner = std::move(result.details[0]);
+      result = std::move(inner);
+    }
+    ASSERT_FALSE(result.is_valid());
+    ASSERT_EQ(name, as_string(result.name));
+  };
+
+  assert_trace("{items: [{name: a}, {name: 2}]}", "items.1.name", "type_constraint", "Expected string type.");
+  assert_trace("{items: [{name: a, size: 20}]}", "items.0.size", "size_range", "out of range value.");
+  assert_trace("{items: [{name: a}, {}]}", "items.1.name", "Item", "missing required field!");
+  assert_trace("{items: [{name: a}, 3]}", "items.1", "Item", "Expected object.");
+  assert_trace("{items: {}}", "items", "list_constraint", "Expected a list.");
+  assert_trace("{items: [{name: a}], point: [1]}", "point", "tuple_constraint", "Too few values in the tuple.");
+  assert_trace("{items: [{name: a}], point: [1, x]}", "point.1", "type_constraint", "Expected integer type.");
+  assert_trace("{items: [{name: a}], tags: {x: abc, y: '12'}}", "tags.y", "tag", "bad tag.");
+  assert_trace("{}", "items", "Order", "missing required field!");
+  assert_trace("[]", "", "Order", "Expected object.");
+
+  // quick_test() agrees with every trace.
+  for (auto document : {"{items: [{name: 2}]}", "{items: [{name: a}], point: [1, 2, 3]}"}) {
+    auto doc = load_yaml(document);
+    ASSERT_EQ(program.quick_test(doc), program.trace(doc, trace));
+  }
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include <garlic/regex.h>
+
+#include <random>
+#include <regex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace garlic;
+using namespace std;
+
+static const vector<const char*> supported_patterns = {
+  "", "abc", "a|b|", "a*", "a+?", "(ab)*c", "(?:ab|cd)+", "a{3}", "a{2,}", "a{1,3}?", "(a|b){0,4}c",
+  "\\d{1,3}", "\\w+@\\w+\\.com", "\\s*\\S+", "[a-c]+", "[^a-c]*", "[-a]", "[a-]", "[\\d_]+", "[\\D]",
+  "[\\]\\\\-]+", ".*", "a.c", "^ab$", "^$", "\\$\\^", "x\\x41y", "[01]?[012][/]\\d{2}[/]\\d{4}",
+  "(a*)*b", "(a|ab)(c|bcd)(d*)", "()a", "\\W\\D", "a\\.b", "(((a)))|b",
+};
+
+static const vector<const char*> fallback_patterns = {
+  "(a)\\1", "a(?=b)b", "\\bab", "[[:alpha:]]+", "a$b", "a^b", "\\u0041",
+};
+
+static string random_input(mt19937& generator, size_t max_size) {
+  static const char alphabet[] = "abcdx01_ .@$^\n\\-]A/";
+  uniform_int_distribution<size_t> size(0, max_size);
+  uniform_int_distribution<size_t> index(0, sizeof(alphabet) - 2);
+  string result(size(generator), ' ');
+  for (auto& c : result) c = alphabet[index(generator)];
+  return result;
+}
+
+TEST(RegexMatcher, MatchesStdRegex) {
+  mt19937 generator(7);
+  for (auto pattern : supported_patterns) {
+    regex_matcher matcher(pattern);
+    ASSERT_TRUE(matcher.is_automaton()) << pattern;
+    std::regex expected(pattern);
+    for (int i = 0; i < 2000; ++i) {
+      auto input = random_input(generator, 8);
+      ASSERT_EQ(matcher.match(input), std::regex_match(input, expected))
+        << "pattern: " << pattern << " input: " << input;
+    }
+  }
+}
+
+TEST(RegexMatcher, Fallback) {
+  for (auto pattern : fallback_patterns) {
+    regex_matcher matcher(pattern);
+    ASSERT_FALSE(matcher.is_automaton()) << pattern;
+  }
+  regex_matcher backreference("(a+)b\\1");
+  ASSERT_TRUE(backreference.match("aabaa"));
+  ASSERT_FALSE(backreference.match("aaba"));
+
+  ASSERT_THROW(regex_matcher("a{2,1}"), std::regex_error);
+  ASSERT_THROW(regex_matcher("(ab"), std::regex_error);
+}
+
+TEST(RegexMatcher, StringView) {
+  regex_matcher matcher("\\d{3}");
+  string input = "1234";
+  ASSERT_TRUE(matcher.match(string_view(input.data(), 3)));
+  ASSERT_FALSE(matcher.match(input));
+  ASSERT_FALSE(matcher.match(string_view("12\0", 3)));
+}
+
+TEST(RegexMatcher, LongInput) {
+  regex_matcher matcher("(a|b)*c");
+  string input(1 << 20, 'a');
+  input.back() = 'c';
+  ASSERT_TRUE(matcher.match(input));
+  input.back() = 'a';
+  ASSERT_FALSE(matcher.match(input));
+}
+
+TEST(RegexMatcher, ManyStates) {
+  // (a|b)*a(a|b){12} needs thousands of DFA states which overflows the cache.
+  regex_matcher matcher("(a|b)*a(a|b){12}");
+  std::regex expected("(a|b)*a(a|b){12}");
+  mt19937 generator(11);
+  uniform_int_distribution<int> coin(0, 1);
+  for (int i = 0; i < 500; ++i) {
+    string input(20, 'a');
+    for (auto& c : input) c = coin(generator) ? 'a' : 'b';
+    ASSERT_EQ(matcher.match(input), std::regex_match(input, expected)) << input;
+  }
+}
+
+TEST(RegexMatcher, Concurrent) {
+  const char* pattern = "[a-z]+\\d{2,4}(-[A-Z]+)?";
+  regex_matcher matcher(pattern);
+  std::regex expected(pattern);
+  mt19937 generator(3);
+  vector<string> inputs;
+  vector<char> results;
+  for (int i = 0; i < 2000; ++i) {
+    inputs.push_back("abc" + to_string(generator() % 100000) + (i % 2 ? "-XY" : "-x"));
+    results.push_back(std::regex_match(inputs.back(), expected));
+  }
+
+  vector<char> passed(4);
+  vector<thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&, i] {
+        passed[i] = true;
+        for (size_t index = 0; index < inputs.size(); ++index) {
+          if (matcher.match(inputs[index]) != static_cast<bool>(results[index])) passed[i] = false;
+        }
+        });
+  }
+  for (auto& thread : threads) thread.join();
+  for (auto result : passed) ASSERT_TRUE(result);
+}
+
+TEST(RegexMatcher, Deferred) {
+  regex_matcher matcher("[a-z]+\\d{2}", regex_matcher::deferred);
+  ASSERT_TRUE(matcher.match("abc12"));
+  ASSERT_FALSE(matcher.match("abc1"));
+  ASSERT_TRUE(matcher.is_automaton());
+
+  auto copy = regex_matcher("(a)\\1", regex_matcher::deferred);
+  ASSERT_TRUE(copy.match("aa"));
+  ASSERT_FALSE(copy.is_automaton());
+
+  // invalid patterns never match rather than throwing.
+  regex_matcher invalid("(ab", regex_matcher::deferred);
+  regex_matcher other(invalid);
+  ASSERT_FALSE(invalid.match("ab"));
+  ASSERT_FALSE(other.match("(ab"));
+}
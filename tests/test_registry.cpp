@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <garlic/clove.h>
+#include <garlic/registry.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace garlic;
+using namespace std;
+
+
+static Module make_module(int version) {
+  Module module;
+  auto model = make_model("User");
+  model->add_field("id", make_field({make_constraint<type_tag>(TypeFlag::Integer)}));
+  if (version % 2) model->add_field("name", make_field({make_constraint<type_tag>(TypeFlag::String)}));
+  model->annotations().emplace("version", text::copy(to_string(version)));
+  module.add_model(model);
+  return module;
+}
+
+TEST(ModuleRegistry, Publish) {
+  ModuleRegistry registry;
+  ASSERT_FALSE(registry.read());
+
+  CloveDocument doc;
+  doc.set_object();
+  doc.add_member("id", 1);
+
+  registry.publish(make_module(0));
+  {
+    auto module = registry.read();
+    ASSERT_TRUE(module);
+    auto model = module->get_model("User");
+    ASSERT_TRUE(model->frozen());
+    ASSERT_TRUE(model->quick_test(doc));
+
+    // nested snapshots on the same thread see the same module until they are all gone.
+    auto nested = registry.read();
+    ASSERT_EQ(module.get(), nested.get());
+  }
+
+  // the old module stays alive while another thread reads it.
+  atomic<int> stage = 0;
+  thread reader([&registry, &stage, &doc]() {
+      auto module = registry.read();
+      stage = 1;
+      while (stage != 2) this_thread::yield();
+      ASSERT_TRUE(module->get_model("User")->quick_test(doc));
+      });
+  while (stage != 1) this_thread::yield();
+  registry.publish(make_module(1));
+  ASSERT_EQ(registry.reclaim(), 1);
+  {
+    auto module = registry.read();
+    ASSERT_FALSE(module->get_model("User")->quick_test(doc));
+  }
+  stage = 2;
+  reader.join();
+  ASSERT_EQ(registry.reclaim(), 0);
+}
+
+TEST(ModuleRegistry, Concurrent) {
+  ModuleRegistry registry;
+  registry.publish(make_module(0));
+
+  CloveDocument doc;
+  doc.set_object();
+  doc.add_member("id", 1);
+  doc.add_member("name", "user");
+
+  atomic<bool> done = false;
+  vector<thread> readers;
+  for (int index = 0; index < 4; ++index) {
+    readers.emplace_back([&registry, &done, &doc]() {
+        while (!done) {
+          auto module = registry.read();
+          auto model = module->get_model("User");
+          ASSERT_TRUE(model->quick_test(doc));
+          ASSERT_TRUE(model->validate(doc).is_valid());
+        }
+        });
+  }
+  for (int version = 1; version < 200; ++version) registry.publish(make_module(version));
+  done = true;
+  for (auto& reader : readers) reader.join();
+  ASSERT_EQ(registry.reclaim(), 0);
+  auto module = registry.read();
+  ASSERT_EQ(module->get_model("User")->annotations().at("version"), text("199"));
+}
+
+TEST(ModuleRegistry, DropsReadersOfDeletedRegistries) {
+  for (int index = 0; index < 16; ++index) {
+    ModuleRegistry registry;
+    registry.publish(make_module(index));
+    ASSERT_TRUE(registry.read());
+  }
+  // the thread only keeps a slot in the registries that are still alive.
+  ModuleRegistry registry;
+  ASSERT_FALSE(registry.read());
+  ASSERT_EQ(internal::registry_readers.size(), 1);
+}
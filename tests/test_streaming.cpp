@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+#include <garlic/clove.h>
+#include <garlic/streaming.h>
+
+#include <cstdio>
+#include <string>
+
+#include "test_utility.h"
+
+using namespace garlic;
+using namespace std;
+
+
+template<GARLIC_VIEW Layer>
+static void emit_events(StreamValidator& validator, const Layer& layer) {
+  if (layer.is_null()) validator.null();
+  else if (layer.is_bool()) validator.boolean(layer.get_bool());
+  else if (layer.is_int()) validator.integer(layer.get_int());
+  else if (garlic::is_int64(layer)) validator.integer(garlic::get_int64(layer));
+  else if (garlic::is_uint64(layer)) validator.integer(garlic::get_uint64(layer));
+  else if (layer.is_double()) validator.real(layer.get_double());
+  else if (layer.is_string()) validator.string(layer.get_string_view());
+  else if (layer.is_list()) {
+    validator.begin_list();
+    for (const auto& item : layer.get_list()) emit_events(validator, item);
+    validator.end_list();
+  } else if (layer.is_object()) {
+    validator.begin_object();
+    for (const auto& member : layer.get_object()) {
+      validator.key(member.key.get_string_view());
+      emit_events(validator, member.value);
+    }
+    validator.end_object();
+  }
+}
+
+template<typename Target, GARLIC_VIEW Layer>
+static ConstraintResult stream_validate(Target&& target, const Layer& layer) {
+  StreamValidator validator(std::forward<Target>(target));
+  emit_events(validator, layer);
+  EXPECT_TRUE(validator.done());
+  return std::move(validator.result());
+}
+
+static void assert_stream_validation(const Module& module, const char* model_name, const char* filename) {
+  auto model = module.get_model(model_name);
+  ASSERT_NE(model, nullptr);
+  ASSERT_TRUE(model->frozen());
+  auto doc = load_json(filename);
+  auto view = doc.get_view();
+
+  assert_same_result(model->validate(view), stream_validate(model, view));
+
+  // the same model without the frozen field table.
+  auto unfrozen = make_shared<Model>(Model::Properties(model->properties()));
+  ASSERT_FALSE(unfrozen->frozen());
+  assert_same_result(unfrozen->validate(view), stream_validate(unfrozen, view));
+}
+
+TEST(StreamValidator, SpecialConstraints) {
+  Module module;
+  load_libyaml_module(module, "data/special_constraints/module.yaml");
+
+  const pair<const char*, vector<const char*>> cases[] = {
+    {"AnyTest", {"any_good1", "any_good2", "any_bad1"}},
+    {"ListTest", {"list_good1", "list_bad1", "list_bad2"}},
+    {"TupleTest", {
+      "tuple_good1", "tuple_good2", "tuple_bad1", "tuple_bad2",
+      "tuple_bad3", "tuple_bad4", "tuple_bad5", "tuple_bad6"}},
+    {"MapTest", {"map_good1", "map_bad1", "map_bad2", "map_bad3"}},
+    {"AllTest", {"all_good1", "all_bad1", "all_bad2"}},
+    {"LiteralTest", {"literal_good1", "literal_bad1"}},
+    {"EnumTest", {"enum_good1", "enum_good2", "enum_bad1"}},
+  };
+  for (const auto& [model_name, files] : cases) {
+    for (auto file : files) {
+      SCOPED_TRACE(file);
+      assert_stream_validation(module, model_name, ("data/special_constraints/" + string(file) + ".json").data());
+    }
+  }
+}
+
+TEST(StreamValidator, Models) {
+  Module module;
+  load_libyaml_module(module, "data/optional_fields/module.yaml");
+  for (auto model_name : {"User", "Staff"}) {
+    for (auto file : {"good1", "good2", "good3", "bad1", "bad2", "bad3"}) {
+      SCOPED_TRACE(file);
+      assert_stream_validation(module, model_name, ("data/optional_fields/" + string(file) + ".json").data());
+    }
+  }
+
+  Module fields;
+  load_libyaml_module(fields, "data/field_constraint/module.yaml");
+  for (auto model_name : {"Account", "AccountCustomMessage"}) {
+    for (auto file : {"good", "bad1", "bad2"}) {
+      SCOPED_TRACE(file);
+      assert_stream_validation(fields, model_name, ("data/field_constraint/" + string(file) + ".json").data());
+    }
+  }
+
+  Module constraints;
+  load_libyaml_module(constraints, "data/constraint/module.yaml");
+  assert_stream_validation(constraints, "User", "data/constraint/bad1.json");
+}
+
+TEST(StreamValidator, Constraint) {
+  auto constraint = make_constraint<list_tag>(
+      make_constraint<tuple_tag>(sequence<Constraint>{
+        make_constraint<type_tag>(TypeFlag::String),
+        make_constraint<range_tag>(2, 4)}));
+
+  CloveDocument doc;
+  doc.set_list();
+  for (const char* name : {"a", "b", "c"}) {
+    doc.get_reference().push_back_builder([name](auto item) {
+        item.set_list();
+        item.push_back(name);
+        item.push_back(3);
+        });
+  }
+  assert_same_result(constraint.test(doc), stream_validate(constraint, doc.get_view()));
+
+  auto last = *--doc.get_reference().end_list();
+  (*--last.end_list()).set_int(7);
+  auto result = stream_validate(constraint, doc.get_view());
+  ASSERT_FALSE(result.is_valid());
+  assert_same_result(constraint.test(doc), result);
+
+  // scalars reach the constraint directly.
+  CloveDocument scalar;
+  scalar.set_string("garlic");
+  StreamValidator validator(make_constraint<range_tag>(1, 3));
+  validator.string("garlic");
+  ASSERT_TRUE(validator.done());
+  assert_same_result(make_constraint<range_tag>(1, 3).test(scalar), validator.result());
+}
+
+TEST(StreamValidator, WideIntegers) {
+  const int64_t large = int64_t{1} << 40;
+  auto constraint = make_constraint<list_tag>(
+      make_constraint<any_tag>(sequence<Constraint>{
+        make_constraint<int64_literal_tag>(-large),
+        make_constraint<uint64_literal_tag>(UINT64_MAX),
+        make_constraint<range_tag>(0, static_cast<size_t>(large))}));
+
+  CloveDocument doc;
+  doc.set_list();
+  doc.push_back(-large);
+  doc.push_back(UINT64_MAX);
+  doc.push_back(large);
+  doc.push_back(12);
+  auto result = stream_validate(constraint, doc.get_view());
+  ASSERT_TRUE(result.is_valid());
+  assert_same_result(constraint.test(doc), result);
+
+  doc.push_back(large + 1);
+  doc.push_back(-large - 1);
+  result = stream_validate(constraint, doc.get_view());
+  ASSERT_FALSE(result.is_valid());
+  assert_same_result(constraint.test(doc), result);
+
+  // above 2^53 the bounds are compared as integers, not as doubles.
+  const uint64_t precise = (uint64_t{1} << 53) + 3;
+  auto wide_range = make_constraint<list_tag>(make_constraint<range_tag>(0, precise));
+  CloveDocument wide;
+  wide.set_list();
+  wide.push_back(precise);
+  ASSERT_TRUE(stream_validate(wide_range, wide.get_view()).is_valid());
+  wide.push_back(precise + 1);
+  result = stream_validate(wide_range, wide.get_view());
+  ASSERT_FALSE(result.is_valid());
+  assert_same_result(wide_range.test(wide), result);
+}
+
+TEST(StreamValidator, WideModel) {
+  auto model = make_model("Wide");
+  auto field = make_field({make_constraint<type_tag>(TypeFlag::Integer)});
+  for (int i = 0; i < 300; ++i) model->add_field(text::copy("field" + to_string(i)), field, i % 3 != 0);
+
+  CloveDocument doc;
+  doc.set_object();
+  for (int i = 0; i < 300; i += 2) {
+    auto key = "field" + to_string(i);
+    if (i % 7) doc.add_member(text::copy(key), i);
+    else doc.add_member(text::copy(key), "not a number");
+  }
+
+  assert_same_result(model->validate(doc), stream_validate(model, doc.get_view()));
+  model->freeze();
+  assert_same_result(model->validate(doc), stream_validate(model, doc.get_view()));
+}
@@ -1,5 +1,8 @@
 #include "test_utility.h"
 
+#include <algorithm>
+#include <vector>
+
 garlic::adapters::libyaml::YamlDocument
 get_libyaml_document(const char * name) {
   auto file = fopen(name, "r");
@@ -16,6 +19,16 @@ get_rapidjson_document(const char* name) {
   return doc;
 }
 
+garlic::CloveDocument load_json(const char* filename) {
+  garlic::CloveDocument doc;
+  auto file = fopen(filename, "r");
+  garlic::adapters::libyaml::load(file, doc);
+  fclose(file);
+  return doc;
+}
+
+std::string as_string(const garlic::text& value) { return std::string(value.data(), value.size()); }
+
 void
 print_constraint_result(
     const garlic::ConstraintResult& result,
@@ -92,7 +105,7 @@ void load_libyaml_module(garlic::Module& module, const char* filename) {
   auto doc = get_libyaml_document(filename);
   auto result = garlic::parsing::load_module(doc.get_view());
   ASSERT_TRUE(result);
-  module = *result;
+  module = std::move(*result);
 }
 
 
@@ -146,3 +159,24 @@ void assert_jsonfile_invalid(
   if (print) print_constraint_result(result);
   ASSERT_FALSE(result.is_valid());
 }
+
+void assert_same_result(const garlic::ConstraintResult& expected, const garlic::ConstraintResult& result) {
+  ASSERT_EQ(expected.is_valid(), result.is_valid());
+  ASSERT_EQ(expected.flag, result.flag);
+  ASSERT_EQ(as_string(expected.name), as_string(result.name));
+  ASSERT_EQ(as_string(expected.reason), as_string(result.reason));
+  ASSERT_EQ(expected.details.size(), result.details.size()) << as_string(expected.name);
+  for (size_t index = 0; index < expected.details.size(); ++index) {
+    assert_same_result(expected.details[index], result.details[index]);
+  }
+}
+
+std::string describe(const garlic::ConstraintResult& result) {
+  if (result.is_valid()) return "valid";
+  std::vector<std::string> details;
+  for (const auto& item : result.details) details.push_back(describe(item));
+  std::sort(details.begin(), details.end());
+  auto output = as_string(result.name) + ":" + as_string(result.reason) + (result.is_field() ? ":field" : "") + "[";
+  for (const auto& item : details) output += item + ",";
+  return output + "]";
+}
@@ -6,6 +6,7 @@
 #include <deque>
 
 #include <gtest/gtest.h>
+#include <garlic/clove.h>
 #include <garlic/parsing/module.h>
 #include <garlic/adapters/rapidjson.h>
 #include <garlic/adapters/libyaml.h>
@@ -21,10 +22,27 @@ get_libyaml_document(const char * name);
 garlic::adapters::rapidjson::JsonDocument
 get_rapidjson_document(const char* name);
 
+/*
+ * Loads a JSON file into a clove document through libyaml.
+ */
+garlic::CloveDocument load_json(const char* filename);
+
+std::string as_string(const garlic::text& value);
+
 void print_constraint_result(const garlic::ConstraintResult& result, int level=0);
 void assert_field_constraint_result(const garlic::ConstraintResult& results, const char* name);
 void assert_constraint_result(const garlic::ConstraintResult& results, const char* name, const char* message);
 
+/*
+ * Asserts two results have the same flags, names, reasons and details, all the way down.
+ */
+void assert_same_result(const garlic::ConstraintResult& expected, const garlic::ConstraintResult& result);
+
+/*
+ * Renders a result with sorted details, detail order of models follows their hash tables.
+ */
+std::string describe(const garlic::ConstraintResult& result);
+
 template<GARLIC_VIEW LayerType>
 void print_constraints(const garlic::Field& field) {
   bool first = true;